@@ -13,10 +13,20 @@
 #include "AliExternalBDT.h"
 
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace {
   inline bool checkFile (const std::string name) {
     FILE *file = fopen(name.c_str(), "r");
@@ -27,6 +37,37 @@ namespace {
       return false;
     }
   }
+
+  /// 64-bit FNV-1a hash of the model file content, continued over the extra string
+  bool hashFile(const std::string &name, const std::string &extra, std::string &hash) {
+    std::ifstream file(name, std::ios::binary);
+    if (!file) return false;
+    unsigned long long value = 14695981039346656037ull;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount()) {
+      for (std::streamsize iChar = 0; iChar < file.gcount(); ++iChar) {
+        value = (value ^ static_cast<unsigned char>(buffer[iChar])) * 1099511628211ull;
+      }
+    }
+    for (const char &c : extra) {
+      value = (value ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    std::ostringstream out;
+    out << std::hex << value;
+    hash = out.str();
+    return true;
+  }
+
+  /// Output of a shell command, empty if it cannot be run
+  std::string commandOutput(const std::string &command) {
+    std::string output;
+    FILE *pipe = popen(command.data(), "r");
+    if (pipe == NULL) return output;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe) != NULL) output += buffer;
+    pclose(pipe);
+    return output;
+  }
 }
 
 AliExternalBDT::AliExternalBDT(std::string name) :
@@ -35,25 +76,36 @@ AliExternalBDT::AliExternalBDT(std::string name) :
   fModelPath{""},
   fModelName{""},
   fCompiler{},
-  fPredictor{}
+  fPredictor{},
+  fCacheDirectory{""},
+  fCompilerFlags{"-O1"},
+  fUseNativeArch{false},
+  fStartupTime{0.},
+  fEntries{},
+  fBatchFeatures{},
+  fBatchScores{}
 {
 }
 
 
-bool AliExternalBDT::CompileAndLoadModelLibrary() {
-  std::string path = GetUniquePath();
+bool AliExternalBDT::CompileAndLoadModelLibrary(const std::string &path) {
   if (checkFile(path + "/main.so")) {
     std::cout << "Library found: " << path.data() << "/main.so . Loading it!" << std::endl;
   } else {
     std::cout << "Starting the model compilation, depending on the model size it can take a while..." << std::endl;
-    system((std::string("gcc -c -O1 -fPIC ") + path + "/main.c -o " + path + "/main.o && gcc -shared " + path + \
-          "/main.o -o " + path + "/main.so").data());
+    /// build under a temporary name and rename, so that a library is never seen half-written
+    const std::string tmp = path + "/main.so.tmp" + std::to_string(getpid());
+    const int status = system((std::string("gcc -c ") + GetCompilerFlags() + " -fPIC " + path + "/main.c -o " + path + \
+          "/main.o && gcc -shared " + path + "/main.o -o " + tmp + " && mv -f " + tmp + " " + path + "/main.so").data());
+    if (status != 0) {
+      std::cerr << "Model compilation failed." << std::endl;
+      return false;
+    }
   }
   return LoadModelLibrary(path + "/main.so");
 }
 
-bool AliExternalBDT::CreateModelCode() {
-  std::string path = GetUniquePath();
+bool AliExternalBDT::CreateModelCode(const std::string &path) {
   if (checkFile(path + "/main.c")) {
     std::cout << "Code found: " << path.data() << "/main.c . \
       Remove it or unset/change the AliExternalBDT name to force its regeneration." << std::endl;
@@ -72,6 +124,54 @@ bool AliExternalBDT::CreateModelCode() {
   return true;
 }
 
+std::string AliExternalBDT::GetCompilerFlags() const {
+  return fUseNativeArch ? fCompilerFlags + " -march=native" : fCompilerFlags;
+}
+
+bool AliExternalBDT::LoadCachedModelLibrary(int type) {
+  /// the model type is part of the key, the same file loaded as another type gives another library
+  std::string key = "type" + std::to_string(type) + " " + GetCompilerFlags();
+  /// -march=native is the same string on every host: the key holds the target (CPU and instruction set
+  /// extensions) that the compiler resolves it to on this host, so that the nodes of a heterogeneous
+  /// cluster do not load a library built for another CPU
+  if (fUseNativeArch) {
+    const std::string target = commandOutput("gcc " + GetCompilerFlags() + " -Q --help=target 2>/dev/null");
+    if (target.empty()) {
+      std::cerr << "Cannot resolve the native target of the compiler" << std::endl;
+      return false;
+    }
+    key += " " + target;
+  }
+  std::string hash;
+  if (!hashFile(fModelPath, key, hash)) {
+    std::cerr << "Cannot read the model file " << fModelPath << " for hashing" << std::endl;
+    return false;
+  }
+  mkdir(fCacheDirectory.data(), 0777);
+  const std::string path = fCacheDirectory + "/" + fModelName + "_" + hash;
+
+  /// one worker per node compiles the model, the others wait on the lock and reuse its library
+  /// (flock() is not reliable on NFS: the cache directory must be on node-local storage)
+  const std::string lockPath = path + ".lock";
+  const int lock = open(lockPath.data(), O_RDWR | O_CREAT, 0666);
+  if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+    std::cerr << "Cannot lock the model cache " << lockPath << std::endl;
+    if (lock >= 0) close(lock);
+    return false;
+  }
+  bool status = true;
+  if (!checkFile(path + "/main.so")) {
+    mkdir(path.data(), 0777);
+    status = CreateModelCode(path) && CompileAndLoadModelLibrary(path);
+  } else {
+    std::cout << "Cached library found: " << path.data() << "/main.so . Loading it!" << std::endl;
+    status = LoadModelLibrary(path + "/main.so");
+  }
+  flock(lock, LOCK_UN);
+  close(lock);
+  return status;
+}
+
 std::string AliExternalBDT::GetUniquePath() {
   if (fBDTname.empty()) {
     return fModelName + std::to_string((unsigned long)this);
@@ -103,8 +203,16 @@ bool AliExternalBDT::LoadModel(const std::string &path, int type) {
     std::cerr << "Model loading failed" << std::endl;
     return false;
   }
-  if (!CreateModelCode()) return false;
-  if (!CompileAndLoadModelLibrary()) return false;
+  const auto start = std::chrono::steady_clock::now();
+  if (fCacheDirectory.empty()) {
+    const std::string uniquePath = GetUniquePath();
+    if (!CreateModelCode(uniquePath)) return false;
+    if (!CompileAndLoadModelLibrary(uniquePath)) return false;
+  } else {
+    if (!LoadCachedModelLibrary(type)) return false;
+  }
+  fStartupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "Model " << fModelName << " ready in " << fStartupTime << " s" << std::endl;
   return true;
 }
 
@@ -128,16 +236,70 @@ bool AliExternalBDT::LoadModelLibrary(std::string path) {
 }
 
 double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
-  std::vector<TreelitePredictorEntry> entries(size);
-  for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
-    entries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+  if (static_cast<int>(fEntries.size()) != size) fEntries.resize(size);
+  for (size_t iEntry = 0; iEntry < fEntries.size(); ++iEntry) {
+    fEntries[iEntry].fvalue = static_cast<float>(features[iEntry]);
   }
   size_t out_size{0u};
   TreelitePredictorQueryResultSizeSingleInst(fPredictor, &out_size);
   assert(out_size == 1);
   float output = 0.f;
-  TreelitePredictorPredictInst(fPredictor, entries.data(),
+  TreelitePredictorPredictInst(fPredictor, fEntries.data(),
       static_cast<int>(useRawScore), &output,
       &out_size);
   return output;
 }
+
+void AliExternalBDT::ReserveBatch(int nRows, int nCols) {
+  if (nRows <= 0 || nCols <= 0) return;
+  fBatchFeatures.reserve(static_cast<size_t>(nRows) * nCols);
+  fBatchScores.reserve(nRows);
+}
+
+bool AliExternalBDT::PredictBatch(const float *features, int nRows, int nCols, double *scores, bool useRawScore) {
+  return PredictDenseBatch(features, nRows, nCols, scores, useRawScore);
+}
+
+bool AliExternalBDT::PredictBatch(const double *features, int nRows, int nCols, double *scores, bool useRawScore) {
+  if (nRows <= 0 || nCols <= 0) return nRows == 0;
+  const size_t nValues = static_cast<size_t>(nRows) * nCols;
+  fBatchFeatures.resize(nValues);
+  for (size_t iValue = 0; iValue < nValues; ++iValue) {
+    fBatchFeatures[iValue] = static_cast<float>(features[iValue]);
+  }
+  return PredictDenseBatch(fBatchFeatures.data(), nRows, nCols, scores, useRawScore);
+}
+
+bool AliExternalBDT::PredictDenseBatch(const float *features, int nRows, int nCols, double *scores, bool useRawScore) {
+  if (nRows <= 0 || nCols <= 0) return nRows == 0;
+  /// the dense batch uses NaN as the missing-value marker, while Predict() passes NaN to the model as a value:
+  /// NaN features are rejected so that both paths give the same score for the same candidate
+  const size_t nValues = static_cast<size_t>(nRows) * nCols;
+  for (size_t iValue = 0; iValue < nValues; ++iValue) {
+    if (std::isnan(features[iValue])) {
+      std::cerr << "NaN feature in row " << iValue / nCols << ", column " << iValue % nCols
+        << ": not supported by the batch prediction" << std::endl;
+      return false;
+    }
+  }
+  DenseBatchHandle batch;
+  if (TreeliteAssembleDenseBatch(features, std::numeric_limits<float>::quiet_NaN(), nRows, nCols, &batch) != 0) {
+    std::cerr << "Batch assembly failed" << std::endl;
+    return false;
+  }
+  size_t out_size{0u};
+  TreelitePredictorQueryResultSize(fPredictor, batch, 0, &out_size);
+  assert(out_size == static_cast<size_t>(nRows));
+  if (fBatchScores.size() < out_size) fBatchScores.resize(out_size);
+  const int status = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0,
+      static_cast<int>(useRawScore), fBatchScores.data(), &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status != 0) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  for (int iRow = 0; iRow < nRows; ++iRow) {
+    scores[iRow] = fBatchScores[iRow];
+  }
+  return true;
+}
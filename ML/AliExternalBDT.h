@@ -29,12 +29,37 @@ public:
   bool LoadModelLibrary(std::string path);
   bool LoadXGBoostModel(std::string path);
 
+  /// Directory of the on-disk cache of compiled models, shared by the processes of a node.
+  /// The libraries are indexed by the hash of the model file, of the model type and of the compiler flags
+  /// (with -march=native, of the target resolved by the compiler on the host).
+  /// The compilation is serialised with flock(), which is not reliable on NFS and other network file
+  /// systems: the directory must be on node-local storage (e.g. under $TMPDIR).
+  void SetCacheDirectory(std::string dir) { fCacheDirectory = dir; }
+  /// Optimisation flags used to compile the generated model code (default -O1)
+  void SetCompilerFlags(std::string flags) { fCompilerFlags = flags; }
+  /// Compile the generated model code for the host architecture (-march=native)
+  void SetUseNativeArchitecture(bool native = true) { fUseNativeArch = native; }
+  /// Wall time in seconds spent to make the last model ready (code generation, compilation and loading)
+  double GetStartupTime() const { return fStartupTime; }
+
   double Predict(double *features, int size, bool useRaw = false);
 
+  /// Batch inference on a row-major matrix of nRows candidates with nCols features each.
+  /// The scores are written to scores[0..nRows-1]; no allocation happens once the
+  /// internal scratch buffers reached the size of the largest batch seen.
+  /// NaN features are not supported: the batch is rejected (false is returned).
+  bool PredictBatch(const float *features, int nRows, int nCols, double *scores, bool useRaw = false);
+  bool PredictBatch(const double *features, int nRows, int nCols, double *scores, bool useRaw = false);
+  /// Pre-size the scratch buffers for batches up to nRows x nCols
+  void ReserveBatch(int nRows, int nCols);
+
 private:
-  bool CompileAndLoadModelLibrary();
-  bool CreateModelCode();
+  bool CompileAndLoadModelLibrary(const std::string &path);
+  bool CreateModelCode(const std::string &path);
+  std::string GetCompilerFlags() const;
   std::string GetUniquePath();
+  bool LoadCachedModelLibrary(int type);
+  bool PredictDenseBatch(const float *features, int nRows, int nCols, double *scores, bool useRaw);
   bool LoadModel(const std::string &path, int type);
 
   std::string fBDTname;       /// Unique name of this external BDT handler
@@ -43,6 +68,15 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+
+  std::string fCacheDirectory;  /// directory of the compiled model cache (empty: no cache)
+  std::string fCompilerFlags;   /// optimisation flags for the model compilation
+  bool fUseNativeArch;          /// compile with -march=native
+  double fStartupTime;          /// time spent to make the last model ready (s)
+
+  std::vector<TreelitePredictorEntry> fEntries;    //! scratch buffer for single-instance queries
+  std::vector<float> fBatchFeatures;               //! scratch buffer for float conversion of batch features
+  std::vector<float> fBatchScores;                 //! scratch buffer for batch predictions
 };
 
 #endif
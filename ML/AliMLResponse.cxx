@@ -56,6 +56,10 @@ string ImportFile(string path) {
 bool ModelHandler::CompileModel() {
   string localpath = ImportFile(this->path);
 
+  this->model.SetCacheDirectory(cachedir);
+  if (!compilerflags.empty()) this->model.SetCompilerFlags(compilerflags);
+  this->model.SetUseNativeArchitecture(nativearch);
+
   switch (kLibraryMap[GetLibrary()]) {
   case kXGBoost: {
     return this->model.LoadXGBoostModel(localpath.data());
@@ -82,8 +86,10 @@ ClassImp(AliMLResponse);
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
-    : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+    : TNamed(), fConfigFilePath{}, fEnsembleConfigFilePaths{}, fModelCacheDirectory{}, fModelCompilerFlags{},
+      fUseNativeArch{false}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{},
+      fNBins{}, fNVariables{}, fBinsBegin{}, fRaw{}, fBinEdges{}, fSlotIndices{}, fBoundAddresses{}, fFeatures{},
+      fEnsemble{}, fAllVariableNames{}, fEnsembleVarIndices{}, fAllFeatures{} {
   //
   // Default constructor
   //
@@ -91,8 +97,10 @@ AliMLResponse::AliMLResponse()
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
-    : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+    : TNamed(name, title), fConfigFilePath{""}, fEnsembleConfigFilePaths{}, fModelCacheDirectory{""},
+      fModelCompilerFlags{""}, fUseNativeArch{false}, fModels{}, fCentClasses{}, fBins{},
+      fVariableNames{}, fNBins{}, fNVariables{}, fBinsBegin{}, fRaw{}, fBinEdges{}, fSlotIndices{}, fBoundAddresses{},
+      fFeatures{}, fEnsemble{}, fAllVariableNames{}, fEnsembleVarIndices{}, fAllFeatures{} {
   //
   // Standard constructor
   //
@@ -107,9 +115,14 @@ AliMLResponse::~AliMLResponse() {
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
-    : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
+    : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath},
+      fEnsembleConfigFilePaths{source.fEnsembleConfigFilePaths}, fModelCacheDirectory{source.fModelCacheDirectory},
+      fModelCompilerFlags{source.fModelCompilerFlags}, fUseNativeArch{source.fUseNativeArch}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{fBins.begin()}, fRaw{source.fRaw},
+      fBinEdges{source.fBinEdges}, fSlotIndices{source.fSlotIndices}, fBoundAddresses{source.fBoundAddresses},
+      fFeatures{source.fFeatures}, fEnsemble{source.fEnsemble}, fAllVariableNames{source.fAllVariableNames},
+      fEnsembleVarIndices{source.fEnsembleVarIndices}, fAllFeatures{source.fAllFeatures} {
   //
   // Copy constructor
   //
@@ -124,14 +137,26 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   TNamed::operator=(source);
 
   fConfigFilePath = source.fConfigFilePath;
+  fEnsembleConfigFilePaths = source.fEnsembleConfigFilePaths;
+  fModelCacheDirectory = source.fModelCacheDirectory;
+  fModelCompilerFlags  = source.fModelCompilerFlags;
+  fUseNativeArch       = source.fUseNativeArch;
   fModels         = source.fModels;
   fCentClasses    = source.fCentClasses;
   fBins           = source.fBins;
   fVariableNames  = source.fVariableNames;
   fNBins          = source.fNBins;
   fNVariables     = source.fNVariables;
-  fBinsBegin      = source.fBinsBegin;
+  fBinsBegin      = fBins.begin();
   fRaw            = source.fRaw;
+  fBinEdges       = source.fBinEdges;
+  fSlotIndices    = source.fSlotIndices;
+  fBoundAddresses = source.fBoundAddresses;
+  fFeatures       = source.fFeatures;
+  fEnsemble       = source.fEnsemble;
+  fAllVariableNames   = source.fAllVariableNames;
+  fEnsembleVarIndices = source.fEnsembleVarIndices;
+  fAllFeatures        = source.fAllFeatures;
 
   return *this;
 }
@@ -175,17 +200,53 @@ void AliMLResponse::MLResponseInit() {
   fRaw           = nodeList["RAW_SCORE"].as<bool>();
 
   fBinsBegin = fBins.begin();
+  fBinEdges.assign(fBins.begin(), fBins.end());
+  fFeatures.assign(fNVariables, 0.);
 
   for (const auto &model : nodeList["MODELS"]) {
     fModels.push_back(ModelHandler{model});
   }
 
+  /// compilation settings (optional in the config file, the setters take precedence)
+  string cacheDir = fModelCacheDirectory;
+  if (cacheDir.empty() && nodeList["MODEL_CACHE_DIR"]) cacheDir = nodeList["MODEL_CACHE_DIR"].as<string>();
+  string compilerFlags = fModelCompilerFlags;
+  if (compilerFlags.empty() && nodeList["COMPILER_FLAGS"]) compilerFlags = nodeList["COMPILER_FLAGS"].as<string>();
+  bool nativeArch = fUseNativeArch || (nodeList["NATIVE_ARCH"] && nodeList["NATIVE_ARCH"].as<bool>());
+
   for (auto &model : fModels) {
+    model.SetCompilationSettings(cacheDir, compilerFlags, nativeArch);
     bool comp = model.CompileModel();
     if (!comp) {
       AliFatal("Error in model compilation! Exit");
     }
   }
+
+  /// alternative model sets for ensemble mode, sharing the feature vector with this one
+  fAllVariableNames = fVariableNames;
+  fEnsemble.clear();
+  fEnsembleVarIndices.clear();
+  for (const auto &path : fEnsembleConfigFilePaths) {
+    fEnsemble.push_back(AliMLResponse(Form("%s_ensemble%zu", GetName(), fEnsemble.size()), GetTitle()));
+    AliMLResponse &member = fEnsemble.back();
+    member.SetConfigFilePath(path);
+    member.SetModelCacheDirectory(fModelCacheDirectory);
+    member.SetModelCompilerFlags(fModelCompilerFlags);
+    member.SetUseNativeArchitecture(fUseNativeArch);
+    member.MLResponseInit();
+
+    vector<int> indices;
+    for (const auto &varname : member.fVariableNames) {
+      auto var = std::find(fAllVariableNames.begin(), fAllVariableNames.end(), varname);
+      if (var == fAllVariableNames.end()) {
+        fAllVariableNames.push_back(varname);
+        var = fAllVariableNames.end() - 1;
+      }
+      indices.push_back(var - fAllVariableNames.begin());
+    }
+    fEnsembleVarIndices.push_back(indices);
+  }
+  fAllFeatures.assign(fAllVariableNames.size(), 0.);
 }
 
 //_______________________________________________________________________________
@@ -196,24 +257,186 @@ int AliMLResponse::FindBin(double binvar) {
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
+double AliMLResponse::Predict(double binvar, const map<string, double> &varmap) {
   if ((int)varmap.size() < fNVariables) {
     AliFatal("The variables map you provided to the predictor have a size different from the variable list size! Exit");
   }
 
-  vector<double> features;
-  for (const auto &varname : fVariableNames) {
-    if (varmap.find(varname) == varmap.end()) {
-      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", varname.data()));
+  fFeatures.resize(fNVariables);
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    const auto var = varmap.find(fVariableNames[iVar]);
+    if (var == varmap.end()) {
+      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", fVariableNames[iVar].data()));
     }
-    features.push_back(varmap[varname]);
+    fFeatures[iVar] = var->second;
   }
 
   int bin = FindBin(binvar);
-  if (bin == 0 || bin == fNBins) {
+  if (!IsBinValid(bin)) {
+    AliWarning("Binned variable outside range, no model available!");
+    return -999.;
+  }
+
+  return PredictBin(bin);
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::GetVariableIndex(const string &varname) const {
+  /// the features of the ensemble members follow the own ones
+  for (int iVar = 0; iVar < (int)fAllVariableNames.size(); ++iVar) {
+    if (fAllVariableNames[iVar] == varname) return iVar;
+  }
+  return -1;
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::BindVariableSlots(const vector<string> &slotnames) {
+  fSlotIndices.assign(fAllVariableNames.size(), -1);
+  for (int iSlot = 0; iSlot < (int)slotnames.size(); ++iSlot) {
+    int iVar = GetVariableIndex(slotnames[iSlot]);
+    if (iVar >= 0) fSlotIndices[iVar] = iSlot;
+  }
+  for (int iVar = 0; iVar < (int)fSlotIndices.size(); ++iVar) {
+    if (fSlotIndices[iVar] < 0) {
+      AliFatal(Form("Variable |%s| required by the config not found in the slots provided! Exit",
+                    fAllVariableNames[iVar].data()));
+    }
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::BindVariable(const string &varname, const double *address) {
+  int iVar = GetVariableIndex(varname);
+  if (iVar < 0) {
+    AliWarning(Form("Variable |%s| not used by the models, binding ignored", varname.data()));
+    return;
+  }
+  if (fBoundAddresses.size() != fAllVariableNames.size()) fBoundAddresses.assign(fAllVariableNames.size(), nullptr);
+  fBoundAddresses[iVar] = address;
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::FindBinFast(double binvar) const {
+  /// number of edges strictly below binvar, i.e. the lower_bound index used by FindBin
+  int bin = 0;
+  for (const auto &edge : fBinEdges) {
+    bin += edge < binvar;
+  }
+  return bin;
+}
+
+//_______________________________________________________________________________
+double AliMLResponse::Predict(double binvar, const double *values) {
+  if (fSlotIndices.size() != fAllVariableNames.size()) {
+    AliFatal("Slots of the variables not bound, call BindVariableSlots() first! Exit");
+  }
+
+  int bin = FindBinFast(binvar);
+  if (!IsBinValid(bin)) {
     AliWarning("Binned variable outside range, no model available!");
     return -999.;
   }
 
-  return fModels[bin - 1].GetModel().Predict(&features[0], fNVariables, fRaw);
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    fFeatures[iVar] = values[fSlotIndices[iVar]];
+  }
+  return PredictBin(bin);
+}
+
+//_______________________________________________________________________________
+double AliMLResponse::PredictBound(double binvar) {
+  if ((int)fBoundAddresses.size() < fNVariables ||
+      std::find(fBoundAddresses.begin(), fBoundAddresses.begin() + fNVariables, nullptr) !=
+          fBoundAddresses.begin() + fNVariables) {
+    AliFatal("Not all the variables are bound, call BindVariable() for each of them first! Exit");
+  }
+
+  int bin = FindBinFast(binvar);
+  if (!IsBinValid(bin)) {
+    AliWarning("Binned variable outside range, no model available!");
+    return -999.;
+  }
+
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    fFeatures[iVar] = *fBoundAddresses[iVar];
+  }
+  return PredictBin(bin);
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictEnsembleFeatures(double binvar, vector<double> &scores) {
+  scores.resize(GetNEnsembleMembers());
+
+  int bin = FindBinFast(binvar);
+  if (IsBinValid(bin)) {
+    std::copy(fAllFeatures.begin(), fAllFeatures.begin() + fNVariables, fFeatures.begin());
+    scores[0] = PredictBin(bin);
+  } else {
+    scores[0] = -999.;
+  }
+
+  for (size_t iMember = 0; iMember < fEnsemble.size(); ++iMember) {
+    AliMLResponse &member      = fEnsemble[iMember];
+    const vector<int> &indices = fEnsembleVarIndices[iMember];
+    int memberBin              = member.FindBinFast(binvar);
+    if (!member.IsBinValid(memberBin)) {
+      scores[iMember + 1] = -999.;
+      continue;
+    }
+    for (size_t iVar = 0; iVar < indices.size(); ++iVar) {
+      member.fFeatures[iVar] = fAllFeatures[indices[iVar]];
+    }
+    scores[iMember + 1] = member.PredictBin(memberBin);
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::SelectEnsemble(double binvar, const vector<double> &scores, vector<bool> &selected) {
+  selected.assign(GetNEnsembleMembers(), false);
+
+  int bin     = FindBinFast(binvar);
+  selected[0] = IsBinValid(bin) && scores[0] >= fModels[bin - 1].GetScoreCut();
+  for (size_t iMember = 0; iMember < fEnsemble.size(); ++iMember) {
+    const AliMLResponse &member = fEnsemble[iMember];
+    int memberBin               = member.FindBinFast(binvar);
+    selected[iMember + 1] =
+        member.IsBinValid(memberBin) && scores[iMember + 1] >= member.fModels[memberBin - 1].GetScoreCut();
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictEnsemble(double binvar, const map<string, double> &varmap, vector<double> &scores) {
+  for (size_t iVar = 0; iVar < fAllVariableNames.size(); ++iVar) {
+    const auto var = varmap.find(fAllVariableNames[iVar]);
+    if (var == varmap.end()) {
+      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", fAllVariableNames[iVar].data()));
+    }
+    fAllFeatures[iVar] = var->second;
+  }
+  PredictEnsembleFeatures(binvar, scores);
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictEnsemble(double binvar, const double *values, vector<double> &scores) {
+  if (fSlotIndices.size() != fAllVariableNames.size()) {
+    AliFatal("Slots of the variables not bound, call BindVariableSlots() first! Exit");
+  }
+  for (size_t iVar = 0; iVar < fAllVariableNames.size(); ++iVar) {
+    fAllFeatures[iVar] = values[fSlotIndices[iVar]];
+  }
+  PredictEnsembleFeatures(binvar, scores);
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::IsSelectedEnsemble(double binvar, const map<string, double> &varmap, vector<double> &scores,
+                                       vector<bool> &selected) {
+  PredictEnsemble(binvar, varmap, scores);
+  SelectEnsemble(binvar, scores, selected);
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::IsSelectedEnsemble(double binvar, const double *values, vector<double> &scores,
+                                       vector<bool> &selected) {
+  PredictEnsemble(binvar, values, scores);
+  SelectEnsemble(binvar, scores, selected);
 }
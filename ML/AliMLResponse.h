@@ -32,10 +32,10 @@
 
 class ModelHandler {
 public:
-  ModelHandler() : model(), path(), library(), scorecut() {}
+  ModelHandler() : model(), path(), library(), scorecut(), cachedir(), compilerflags(), nativearch(false) {}
   ModelHandler(const YAML::Node &node)
       : model(), path(node["path"].as<std::string>()), library(node["library"].as<std::string>()),
-        scorecut(node["cut"].as<double>()) {}
+        scorecut(node["cut"].as<double>()), cachedir(), compilerflags(), nativearch(false) {}
 
   std::string const &GetPath() const { return path; }
   std::string const &GetLibrary() const { return library; }
@@ -43,6 +43,13 @@ public:
 
   AliExternalBDT &GetModel() { return model; }
 
+  /// settings passed to AliExternalBDT before the compilation (empty cache directory: no cache, empty flags: default)
+  void SetCompilationSettings(const std::string &cacheDir, const std::string &flags, bool native) {
+    cachedir      = cacheDir;
+    compilerflags = flags;
+    nativearch    = native;
+  }
+
   bool CompileModel();
 
 private:
@@ -52,6 +59,10 @@ private:
   std::string library;
 
   double scorecut;
+
+  std::string cachedir;         //! directory of the compiled model cache
+  std::string compilerflags;    //! optimisation flags for the model compilation
+  bool nativearch;              //! compile the model for the host architecture
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +78,16 @@ public:
 
   /// method to set yaml config file
   void SetConfigFilePath(const std::string configfilepath) { fConfigFilePath = configfilepath; }
+  /// method to add the yaml config file of an alternative model set evaluated in ensemble mode
+  void AddEnsembleConfigFile(const std::string configfilepath) { fEnsembleConfigFilePaths.push_back(configfilepath); }
+
+  /// compilation of the models (override the MODEL_CACHE_DIR, COMPILER_FLAGS and NATIVE_ARCH keys of the config file)
+  /// directory of the on-disk cache of compiled models shared by the processes of a node
+  void SetModelCacheDirectory(const std::string dir) { fModelCacheDirectory = dir; }
+  /// optimisation flags used to compile the models
+  void SetModelCompilerFlags(const std::string flags) { fModelCompilerFlags = flags; }
+  /// compile the models for the host architecture (-march=native)
+  void SetUseNativeArchitecture(bool native = true) { fUseNativeArch = native; }
 
   /// method to check whether the config file is formally correct
   void CheckConfigFile(YAML::Node nodelist);
@@ -76,15 +97,50 @@ public:
   /// return the bin index
   int FindBin(double binvar);
   /// return the MLModel predicted score (raw or proba, depending on useraw)
-  double Predict(double binvar, std::map<std::string, double> varmap);
+  double Predict(double binvar, const std::map<std::string, double> &varmap);
   /// return true if predicted score for map is above the threshold given in the config
-  bool IsSelected(double binvar, std::map<std::string, double> varmap);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap);
   /// overload for getting the model score too
   template<typename F>
-  bool IsSelected(double binvar, std::map<std::string, double> varmap, F &score);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score);
+
+  /// compiled binding mode (to be configured after MLResponseInit)
+  /// declare the layout of the flat array passed to Predict/IsSelected: slotnames[i] is the feature stored at values[i]
+  void BindVariableSlots(const std::vector<std::string> &slotnames);
+  /// bind a feature to the address of a variable read at each Predict/IsSelected call without arguments
+  void BindVariable(const std::string &varname, const double *address);
+  /// return the index of the feature in the list of the config file (-1 if not found)
+  int GetVariableIndex(const std::string &varname) const;
+  /// return the bin index using the precomputed bin edges (same convention as FindBin)
+  int FindBinFast(double binvar) const;
+  /// return the MLModel predicted score for the features in the flat array laid out as in BindVariableSlots
+  double Predict(double binvar, const double *values);
+  /// return the MLModel predicted score for the features read from the bound addresses
+  double PredictBound(double binvar);
+  /// compiled-binding counterparts of IsSelected
+  template<typename F>
+  bool IsSelected(double binvar, const double *values, F &score);
+  bool IsSelected(double binvar, const double *values);
+  template<typename F>
+  bool IsSelectedBound(double binvar, F &score);
+  bool IsSelectedBound(double binvar);
+
+  /// ensemble mode: the model set of the main config file (index 0) and those added with AddEnsembleConfigFile
+  /// share one feature extraction and return one score per model set
+  int GetNEnsembleMembers() const { return 1 + static_cast<int>(fEnsemble.size()); }
+  void PredictEnsemble(double binvar, const std::map<std::string, double> &varmap, std::vector<double> &scores);
+  void PredictEnsemble(double binvar, const double *values, std::vector<double> &scores);
+  void IsSelectedEnsemble(double binvar, const std::map<std::string, double> &varmap, std::vector<double> &scores,
+                          std::vector<bool> &selected);
+  void IsSelectedEnsemble(double binvar, const double *values, std::vector<double> &scores,
+                          std::vector<bool> &selected);
 
 protected:
   std::string fConfigFilePath;    /// path of the config file
+  std::vector<std::string> fEnsembleConfigFilePaths;    /// paths of the config files of the alternative model sets
+  std::string fModelCacheDirectory;    /// directory of the compiled model cache (empty: from the config file)
+  std::string fModelCompilerFlags;     /// flags for the model compilation (empty: from the config file)
+  bool fUseNativeArch;                 /// compile the models with -march=native (or NATIVE_ARCH in the config file)
 
   std::vector<ModelHandler> fModels;
   std::vector<int> fCentClasses;         /// centrality classes ([cent_min, cent_max])
@@ -98,21 +154,68 @@ protected:
 
   bool fRaw;
 
+  std::vector<double> fBinEdges;               //! bin edges cached for FindBinFast
+  std::vector<int> fSlotIndices;               //! position in the flat input array of each feature
+  std::vector<const double *> fBoundAddresses; //! bound address of each feature
+  std::vector<double> fFeatures;               //! scratch buffer for the feature vector
+
+  std::vector<AliMLResponse> fEnsemble;              //! alternative model sets evaluated in ensemble mode
+  std::vector<std::string> fAllVariableNames;        //! union of the features of all model sets (own ones first)
+  std::vector<std::vector<int>> fEnsembleVarIndices; //! position in fAllVariableNames of the features of each member
+  std::vector<double> fAllFeatures;                  //! scratch buffer for the union of the features
+
+  /// scores of all the model sets using the features in fAllFeatures
+  void PredictEnsembleFeatures(double binvar, std::vector<double> &scores);
+  /// selection flags of all the model sets for the scores computed by PredictEnsembleFeatures
+  void SelectEnsemble(double binvar, const std::vector<double> &scores, std::vector<bool> &selected);
+
+  /// model score for a bin index already validated, using the features in fFeatures
+  double PredictBin(int bin) { return fModels[bin - 1].GetModel().Predict(fFeatures.data(), fNVariables, fRaw); }
+  /// true if a model is available for the bin
+  bool IsBinValid(int bin) const { return bin > 0 && bin <= fNBins; }
+
   /// \cond CLASSIMP
-  ClassDef(AliMLResponse, 1);    ///
+  ClassDef(AliMLResponse, 3);    ///
   /// \endcond
 };
 
 template<typename F>
-bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap, F &score) {
-  int bin     = FindBin(binvar);
-  score = Predict(binvar, varmap);
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score) {
+  int bin = FindBin(binvar);
+  score   = Predict(binvar, varmap);
+  if (!IsBinValid(bin)) return false;
   return score >= fModels[bin - 1].GetScoreCut();
 }
 
-inline bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap) {
+inline bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap) {
   float score{0.f};
   return IsSelected(binvar, varmap, score);
 }
 
+template<typename F>
+bool AliMLResponse::IsSelected(double binvar, const double *values, F &score) {
+  int bin = FindBinFast(binvar);
+  score   = Predict(binvar, values);
+  if (!IsBinValid(bin)) return false;
+  return score >= fModels[bin - 1].GetScoreCut();
+}
+
+inline bool AliMLResponse::IsSelected(double binvar, const double *values) {
+  float score{0.f};
+  return IsSelected(binvar, values, score);
+}
+
+template<typename F>
+bool AliMLResponse::IsSelectedBound(double binvar, F &score) {
+  int bin = FindBinFast(binvar);
+  score   = PredictBound(binvar);
+  if (!IsBinValid(bin)) return false;
+  return score >= fModels[bin - 1].GetScoreCut();
+}
+
+inline bool AliMLResponse::IsSelectedBound(double binvar) {
+  float score{0.f};
+  return IsSelectedBound(binvar, score);
+}
+
 #endif
@@ -26,6 +26,9 @@
 #include <TMath.h>
 #include <TRandom.h>
 #include <TChain.h>
+#include <TTree.h>
+#include <TBranch.h>
+#include <TEnv.h>
 #include <TGrid.h>
 #include <TGridResult.h>
 #include <TSystem.h>
@@ -169,7 +172,17 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper() :
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchNFiles(0),
+  fPrefetchNEvents(0),
+  fReadSelectionBranchesFirst(false),
+  fSelectionBranches(),
+  fReadTimer(),
+  fNFullReads(0),
+  fFullReadTime(0.),
+  fNSelectionReads(0),
+  fSelectionReadTime(0.),
+  fIOTimeSaved(0.)
 {
   if (fgInstance != nullptr) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -243,7 +256,17 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper(const c
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchNFiles(0),
+  fPrefetchNEvents(0),
+  fReadSelectionBranchesFirst(false),
+  fSelectionBranches(),
+  fReadTimer(),
+  fNFullReads(0),
+  fFullReadTime(0.),
+  fNSelectionReads(0),
+  fSelectionReadTime(0.),
+  fIOTimeSaved(0.)
 {
   if (fgInstance != 0) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -328,6 +351,9 @@ void AliAnalysisTaskEmcalEmbeddingHelper::RetrieveTaskPropertiesFromYAMLConfig()
   res = fYAMLConfig.GetProperty("randomFileAccess", fRandomFileAccess, false);
   res = fYAMLConfig.GetProperty("createHisto", fCreateHisto, false);
   res = fYAMLConfig.GetProperty("printTimingInfoInLog", fPrintTimingInfoToLog, false);
+  res = fYAMLConfig.GetProperty("prefetchNFiles", fPrefetchNFiles, false);
+  res = fYAMLConfig.GetProperty("prefetchNEvents", fPrefetchNEvents, false);
+  res = fYAMLConfig.GetProperty("readSelectionBranchesFirst", fReadSelectionBranchesFirst, false);
   // More general embedding helper properties
   res = fYAMLConfig.GetProperty("filePattern", fFilePattern, false);
   res = fYAMLConfig.GetProperty("inputFilename", fInputFilename, false);
@@ -821,6 +847,7 @@ void AliAnalysisTaskEmcalEmbeddingHelper::DetermineFirstFileToEmbed()
 Bool_t AliAnalysisTaskEmcalEmbeddingHelper::GetNextEntry()
 {
   Int_t attempts = -1;
+  double readTimeBefore = fFullReadTime + fSelectionReadTime;
 
   do {
     // Reset to start of tree
@@ -847,7 +874,7 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::GetNextEntry()
     // Load current event
     // Can be a simple less than, because fFileNumber counts from 0.
     if (fFileNumber < fMaxNumberOfFiles) {
-      fChain->GetEntry(fCurrentEntry);
+      ReadEntry(fCurrentEntry, fReadSelectionBranchesFirst);
     }
     else {
       AliError("====================================================================================================");
@@ -865,7 +892,7 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::GetNextEntry()
 
       // Access the relevant entry
       // We are certain that fFileNumber is less than fMaxNumberOfFiles, so we are resetting to start
-      fChain->GetEntry(fCurrentEntry);
+      ReadEntry(fCurrentEntry, fReadSelectionBranchesFirst);
     }
     AliDebug(4, TString::Format("Loading entry %i between %i-%i, starting with offset %i from the lower bound of %i", fCurrentEntry, fLowerEntry, fUpperEntry, fOffset, fLowerEntry));
 
@@ -887,9 +914,26 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::GetNextEntry()
 
   } while (!IsEventSelected());
 
+  // Only the selection branches have been read up to now, so the accepted event is read in full.
+  // The full reads of the rejected events are estimated from the average time of the full reads.
+  double ioTimeSaved = 0;
+  if (fReadSelectionBranchesFirst) {
+    SetCachedBranches(false);
+    ReadEntry(fCurrentEntry - 1, false);
+    SetCachedBranches(true);
+    ioTimeSaved = attempts * std::max(fFullReadTime / fNFullReads - fSelectionReadTime / fNSelectionReads, 0.);
+    fIOTimeSaved += ioTimeSaved;
+  }
+
   if (fCreateHisto) {
     fHistManager.FillTH1("fHistEventCount", "Accepted");
     fHistManager.FillTH1("fHistEmbeddedEventsAttempted", attempts);
+    if (fPrintTimingInfoToLog) {
+      fHistManager.FillTH1("fHistExternalEventReadTime", (fFullReadTime + fSelectionReadTime - readTimeBefore) * 1e3);
+      if (fReadSelectionBranchesFirst) {
+        fHistManager.FillTH1("fHistIOTimeSaved", ioTimeSaved * 1e3);
+      }
+    }
   }
 
   if (!fChain) return kFALSE;
@@ -1244,6 +1288,17 @@ void AliAnalysisTaskEmcalEmbeddingHelper::UserCreateOutputObjects()
     histName = "fInitTreeRealtime";
     histTitle = "Real time to execute InitTree() (s)";
     fHistManager.CreateTH1(histName, histTitle, 200, 0, 2000);
+
+    // Time waiting for the external events
+    histName = "fHistExternalEventReadTime";
+    histTitle = "Real time to read the external events for each embedded event;Real time (ms);Counts";
+    fHistManager.CreateTH1(histName, histTitle, 500, 0, 500);
+
+    if (fReadSelectionBranchesFirst) {
+      histName = "fHistIOTimeSaved";
+      histTitle = "Estimated real time saved by reading only the selection branches of the rejected events;Real time (ms);Counts";
+      fHistManager.CreateTH1(histName, histTitle, 500, 0, 500);
+    }
   }
 
   // Add all histograms to output list
@@ -1327,9 +1382,43 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
   Bool_t res = InitEvent();
   if (!res) return kFALSE;
 
+  SetupPrefetching();
+
   return kTRUE;
 }
 
+/**
+ * Configure the reading ahead of the external events. Since the external event is connected to the
+ * TChain, the events cannot be read in a separate thread. Instead:
+ * - The next files in the chain are opened asynchronously (see PrefetchNextFiles()).
+ * - The baskets of the next events are read by the prefetching thread of the TTreeCache, which is
+ *   created in InitTree() for fPrefetchNEvents events. The asynchronous prefetching is only enabled
+ *   while this cache is created, so that the other trees read in the train are not affected.
+ * - The embedded event selection can be evaluated on the header, vertices and MC header branches,
+ *   so that rejected events are never fully read.
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::SetupPrefetching()
+{
+  if (fPrefetchNEvents > 0) {
+    AliInfoStream() << "Prefetching the baskets of the next " << fPrefetchNEvents << " external events.\n";
+  }
+  if (fPrefetchNFiles > 0) {
+    AliInfoStream() << "Opening the next " << fPrefetchNFiles << " external files asynchronously.\n";
+  }
+
+  fSelectionBranches.clear();
+  if (fReadSelectionBranchesFirst) {
+    if (dynamic_cast<AliAODEvent *>(fExternalEvent)) {
+      fSelectionBranches = {"header", "vertices", AliAODMCHeader::StdBranchName()};
+      AliInfoStream() << "Only the branches needed for the embedded event selection will be read for the rejected events.\n";
+    }
+    else {
+      AliWarningStream() << "Reading the selection branches first is only implemented for AODs. The full external events will be read.\n";
+      fReadSelectionBranchesFirst = false;
+    }
+  }
+}
+
 /**
  * Check if the file pythia base filename can be found in the folder or archive corresponding where
  * the external event input file is found.
@@ -1448,6 +1537,20 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
   // Fine to be += as long as we started at 0
   fUpperEntry += fChain->GetTree()->GetEntries();
 
+  // Size the cache of the new tree for the window of prefetched events
+  if (fPrefetchNEvents > 0 && fChain->GetTree()->GetEntries() > 0) {
+    Long64_t bytesPerEvent = fChain->GetTree()->GetZipBytes() / fChain->GetTree()->GetEntries();
+    // The prefetching setting is read when the cache is created: the cache which may have been created
+    // when loading the new tree is removed, and the setting is restored for the other trees of the train
+    Int_t asyncPrefetching = gEnv->GetValue("TFile.AsyncPrefetching", 0);
+    gEnv->SetValue("TFile.AsyncPrefetching", 1);
+    fChain->SetCacheSize(0);
+    fChain->SetCacheSize(bytesPerEvent * fPrefetchNEvents);
+    gEnv->SetValue("TFile.AsyncPrefetching", asyncPrefetching);
+    SetCachedBranches(fReadSelectionBranchesFirst);
+    fChain->StopCacheLearningPhase();
+  }
+
   // Jump ahead at random if desired
   // Determines the offset into the tree
   if (fRandomEventNumberAccess) {
@@ -1489,6 +1592,8 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
     }
   }
 
+  PrefetchNextFiles();
+
   AliDebug(2, TString::Format("Will start embedding file %i beginning from entry %i (entry %i within the file). NOTE: This file number is not equal to the absolute file number in the file list!", fFileNumber, fCurrentEntry, fCurrentEntry - fLowerEntry));
   // NOTE: Cannot use this print message, as it is possible that fMaxNumberOfFiles != fFilenames.size() because
   //       invalid filenames may be included in the fFilenames count!
@@ -1510,6 +1615,101 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
 
 }
 
+/**
+ * Requests the asynchronous opening of the next fPrefetchNFiles files in the chain and of their pythia
+ * cross section files. TFile::Open() (called by the TChain and in PythiaInfoFromCrossSectionFile()) picks
+ * up a pending request for the same file, so the open latency is hidden behind the embedding of the
+ * current file. The open only runs in the background for remote files (such as on AliEn).
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::PrefetchNextFiles()
+{
+  if (fPrefetchNFiles <= 0) {
+    return;
+  }
+
+  TObjArray * chainElements = fChain->GetListOfFiles();
+  for (UInt_t i = 1; i <= static_cast<UInt_t>(fPrefetchNFiles) && i < fMaxNumberOfFiles; i++)
+  {
+    // Embedding restarts from the beginning of the chain after the last file
+    UInt_t fileNumber = (fFileNumber + i) % fMaxNumberOfFiles;
+    std::vector<std::string> filenames = {chainElements->At(fileNumber)->GetTitle()};
+    if (fileNumber < fPythiaCrossSectionFilenames.size()) {
+      filenames.push_back(fPythiaCrossSectionFilenames.at(fileNumber));
+    }
+
+    for (const auto & filename : filenames)
+    {
+      // Don't repeat a pending request
+      if (TFile::GetAsyncOpenStatus(filename.c_str()) != TFile::kAOSNotAsync) {
+        continue;
+      }
+      AliDebugStream(2) << "Opening \"" << filename << "\" asynchronously.\n";
+      TFile::AsyncOpen(filename.c_str());
+    }
+  }
+}
+
+/**
+ * Selects the branches of the external chain which are read ahead by the TTreeCache. While the embedded event
+ * selection is evaluated on the selection branches only, caching the other branches would read the baskets of
+ * the rejected events anyway.
+ *
+ * @param[in] selectionBranchesOnly If true, only the branches needed for the embedded event selection are cached
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::SetCachedBranches(bool selectionBranchesOnly)
+{
+  if (fPrefetchNEvents <= 0 || !fChain->GetCacheSize()) {
+    return;
+  }
+  if (selectionBranchesOnly) {
+    fChain->DropBranchFromCache("*", kTRUE);
+    for (const auto & branchName : fSelectionBranches) {
+      if (fChain->GetBranch(branchName.c_str())) {
+        fChain->AddBranchToCache(branchName.c_str(), kTRUE);
+      }
+    }
+  }
+  else {
+    fChain->AddBranchToCache("*", kTRUE);
+  }
+}
+
+/**
+ * Reads an entry of the external chain and keeps track of the time spent waiting for it.
+ *
+ * @param[in] entry Entry in the chain
+ * @param[in] selectionBranchesOnly If true, only the branches needed for the embedded event selection are read
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::ReadEntry(Int_t entry, bool selectionBranchesOnly)
+{
+  fReadTimer.Start(kTRUE);
+  if (selectionBranchesOnly) {
+    // Beyond the last file, nothing is read (as for GetEntry())
+    Long64_t localEntry = fChain->LoadTree(entry);
+    if (localEntry >= 0) {
+      for (const auto & branchName : fSelectionBranches) {
+        TBranch * branch = fChain->GetTree()->GetBranch(branchName.c_str());
+        if (branch) {
+          branch->GetEntry(localEntry);
+        }
+      }
+    }
+  }
+  else {
+    fChain->GetEntry(entry);
+  }
+  fReadTimer.Stop();
+
+  if (selectionBranchesOnly) {
+    fNSelectionReads++;
+    fSelectionReadTime += fReadTimer.RealTime();
+  }
+  else {
+    fNFullReads++;
+    fFullReadTime += fReadTimer.RealTime();
+  }
+}
+
 /**
  * Extract pythia information from a cross section file. Modified from AliAnalysisTaskEmcal::PythiaInfoFromFile().
  *
@@ -1738,6 +1938,23 @@ void AliAnalysisTaskEmcalEmbeddingHelper::ValidatePhysicsSelectionForInternalEve
   }
 }
 
+/**
+ * Print the time spent reading the external events on this worker, for logging purposes.
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::FinishTaskOutput()
+{
+  if (!fPrintTimingInfoToLog) {
+    return;
+  }
+
+  std::cout << "External events: " << fNFullReads << " full reads in " << fFullReadTime << " (s) real time";
+  if (fReadSelectionBranchesFirst) {
+    std::cout << ", " << fNSelectionReads << " reads of the selection branches in " << fSelectionReadTime << " (s) real time."
+              << " Estimated real time saved by not fully reading the rejected events: " << fIOTimeSaved << " (s)";
+  }
+  std::cout << "." << std::endl;
+}
+
 /**
  * This function is called once at the end of the analysis.
  */
@@ -1892,6 +2109,9 @@ std::string AliAnalysisTaskEmcalEmbeddingHelper::toString(bool includeFileList)
   tempSS << "Random event number access: " << fRandomEventNumberAccess << "\n";
   tempSS << "Random file access: " << fRandomFileAccess << "\n";
   tempSS << "Starting file index: " << fFilenameIndex << "\n";
+  tempSS << "Number of files opened ahead: " << fPrefetchNFiles << "\n";
+  tempSS << "Number of events prefetched: " << fPrefetchNEvents << "\n";
+  tempSS << "Read selection branches first: " << fReadSelectionBranchesFirst << "\n";
   tempSS << "Number of files to embed: " << fFilenames.size() << "\n";
   tempSS << "YAML configuration path: \"" << fConfigurationPath << "\"\n";
   tempSS << "Enable internal event selection: " << fUseInternalEventSelection << "\n";
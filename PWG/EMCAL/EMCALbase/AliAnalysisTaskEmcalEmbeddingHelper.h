@@ -82,6 +82,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   void      UserExec(Option_t *option)                           ;
   void      UserCreateOutputObjects()                            ;
   void      Terminate(Option_t *option)                          ;
+  void      FinishTaskOutput()                                   ;
   /* @} */
 
   static const AliAnalysisTaskEmcalEmbeddingHelper* GetInstance() { return fgInstance       ; }
@@ -116,6 +117,9 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   Int_t GetStartingFileIndex()                              const { return fFilenameIndex; }
   TString GetFileListFilename()                             const { return fFileListFilename; }
   bool GetCreateHistos()                                    const { return fCreateHisto; }
+  Int_t GetPrefetchNFiles()                                 const { return fPrefetchNFiles; }
+  Int_t GetPrefetchNEvents()                                const { return fPrefetchNEvents; }
+  bool GetReadSelectionBranchesFirst()                      const { return fReadSelectionBranchesFirst; }
 
   // Set
   /// Set the pt hard bin which will be added into the file pattern. Can also be omitted and set directly in the pattern.
@@ -150,6 +154,25 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   void SetCreateHistos(bool b)                                    { fCreateHisto = b; }
   /// Set path to %YAML configuration file
   void SetConfigurationPath(const char * path)                    { fConfigurationPath = path; }
+  /**
+   * Set the number of upcoming files in the chain which are opened asynchronously while the current file
+   * is embedded, such that the open latency (mainly on AliEn) is not paid in InitTree(). 0 disables it.
+   */
+  void SetPrefetchNFiles(Int_t n)                                 { fPrefetchNFiles = n; }
+  /**
+   * Set the number of upcoming external events whose baskets are read ahead in the background. It sizes the
+   * TTreeCache of the external chain with asynchronous prefetching enabled. 0 disables it. The prefetching
+   * is only enabled for the cache of the external chain: "TFile.AsyncPrefetching" is set while the cache is
+   * created and restored afterwards.
+   */
+  void SetPrefetchNEvents(Int_t n)                                { fPrefetchNEvents = n; }
+  /**
+   * Read only the branches needed for the embedded event selection (header, vertices and MC header) before
+   * the event is accepted, such that the full external event is only read for accepted events. With
+   * SetPrefetchNEvents(), only the selection branches are cached, except during the read of an accepted event.
+   * AOD only.
+   */
+  void SetReadSelectionBranchesFirst(bool b = true)               { fReadSelectionBranchesFirst = b; }
   /* @} */
 
   /**
@@ -299,6 +322,10 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   virtual Bool_t  CheckIsEmbeddedEventSelected();
   Bool_t          InitEvent()           ;
   void            InitTree()            ;
+  void            SetupPrefetching()    ;
+  void            PrefetchNextFiles()   ;
+  void            ReadEntry(Int_t entry, bool selectionBranchesOnly);
+  void            SetCachedBranches(bool selectionBranchesOnly);
   bool            PythiaInfoFromCrossSectionFile(std::string filename);
   // Validation helper
   void            ValidatePhysicsSelectionForInternalEventSelection();
@@ -375,6 +402,17 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   bool                                          fPrintTimingInfoToLog; ///< Flag to print time to execute InitTree(), for logging purposes
   TStopwatch                                    fTimer            ;    //!<! Timer for the InitTree() function
 
+  Int_t                                         fPrefetchNFiles   ; ///<  Number of upcoming files in the chain which are opened asynchronously
+  Int_t                                         fPrefetchNEvents  ; ///<  Number of upcoming external events whose baskets are prefetched in the background
+  bool                                   fReadSelectionBranchesFirst; ///<  If true, only the branches needed for the embedded event selection are read until an event is accepted
+  std::vector <std::string>                     fSelectionBranches; //!<! Branches needed for the embedded event selection
+  TStopwatch                                    fReadTimer        ; //!<! Timer for reading the external events
+  Long64_t                                      fNFullReads       ; //!<! Number of external events which were fully read
+  double                                        fFullReadTime     ; //!<! Real time spent in the full reads of the external events (s)
+  Long64_t                                      fNSelectionReads  ; //!<! Number of external events for which only the selection branches were read
+  double                                        fSelectionReadTime; //!<! Real time spent in reading the selection branches (s)
+  double                                        fIOTimeSaved      ; //!<! Estimated real time saved by not fully reading the rejected external events (s)
+
   static AliAnalysisTaskEmcalEmbeddingHelper   *fgInstance        ; //!<! Global instance of this class
 
  private:
@@ -382,7 +420,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   AliAnalysisTaskEmcalEmbeddingHelper &operator=(const AliAnalysisTaskEmcalEmbeddingHelper&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 12);
+  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 13);
   /// \endcond
 };
 #endif
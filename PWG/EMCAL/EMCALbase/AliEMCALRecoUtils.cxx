@@ -39,6 +39,9 @@
 #include "AliTrackerBase.h"
 #include "AliEMCALPIDUtils.h"
 
+#include <thread>
+#include <vector>
+
 /// \cond CLASSIMP
 ClassImp(AliEMCALRecoUtils) ;
 /// \endcond
@@ -55,6 +58,7 @@ AliEMCALRecoUtils::AliEMCALRecoUtils():
   fNonLinearityFunction(0),               fNonLinearThreshold(0),
   fSmearClusterEnergy(kFALSE),            fRandom(),
   fCellsRecalibrated(kFALSE),             fRecalibration(kFALSE),                 fUse1Drecalib(kFALSE),                  fEMCALRecalibrationFactors(),
+  fNThreadsCellRecalibration(1),
   fConstantTimeShift(0),                  fTimeRecalibration(kFALSE),             fEMCALTimeRecalibrationFactors(),       fLowGain(kFALSE),
   fUseL1PhaseInTimeRecalibration(kFALSE), fEMCALL1PhaseInTimeRecalibration(),
   fIsParRun(kFALSE),                      fCurrentParNumber(0),                   fNPars(0),                              fGlobalEventID(NULL),
@@ -111,6 +115,7 @@ AliEMCALRecoUtils::AliEMCALRecoUtils(const AliEMCALRecoUtils & reco)
   fCellsRecalibrated(reco.fCellsRecalibrated),
   fRecalibration(reco.fRecalibration),                       fUse1Drecalib(reco.fUse1Drecalib),                   
   fEMCALRecalibrationFactors(NULL),
+  fNThreadsCellRecalibration(reco.fNThreadsCellRecalibration),
   fConstantTimeShift(reco.fConstantTimeShift),  
   fTimeRecalibration(reco.fTimeRecalibration),               fEMCALTimeRecalibrationFactors(NULL),
   fLowGain(reco.fLowGain),
@@ -204,6 +209,7 @@ AliEMCALRecoUtils & AliEMCALRecoUtils::operator = (const AliEMCALRecoUtils & rec
   fCellsRecalibrated         = reco.fCellsRecalibrated;
   fRecalibration             = reco.fRecalibration;
   fUse1Drecalib              = reco.fUse1Drecalib;
+  fNThreadsCellRecalibration = reco.fNThreadsCellRecalibration;
   
   fConstantTimeShift         = reco.fConstantTimeShift;
   fTimeRecalibration         = reco.fTimeRecalibration;
@@ -422,6 +428,30 @@ AliEMCALRecoUtils::~AliEMCALRecoUtils()
 Bool_t AliEMCALRecoUtils::AcceptCalibrateCell(Int_t absID, Int_t bc,
                                               Float_t  & amp,    Double_t & time, 
                                               AliVCaloCells* cells) 
+{  
+  return AcceptCalibrateCell(absID, bc, cells->GetCellAmplitude(absID), cells->GetCellTime(absID),
+                             !(cells->GetCellHighGain(absID)), amp, time); //HG = false -> LG = true
+}
+
+///
+/// Reject cell if acceptance criteria not passed (correct cell number, is it bad channel) 
+/// and calibrate it in energy and time, starting from the values of the cell.
+/// It does not modify the utils, it can be called concurrently.
+///
+/// \param absID: absolute cell ID number
+/// \param bc: bunch crossing number
+/// \param ampIn: cell energy amplitude
+/// \param timeIn: cell time
+/// \param isLowGain: cell in low gain
+/// \param amp: output calibrated amplitude
+/// \param time: output calibrated time
+///
+/// \return bool quality of cell, exists or not 
+///
+//_______________________________________________________________________________
+Bool_t AliEMCALRecoUtils::AcceptCalibrateCell(Int_t absID, Int_t bc,
+                                              Double_t ampIn,    Double_t timeIn, Bool_t isLowGain,
+                                              Float_t  & amp,    Double_t & time) const
 {  
   AliEMCALGeometry* geom = AliEMCALGeometry::GetInstance();
   
@@ -462,7 +492,7 @@ Bool_t AliEMCALRecoUtils::AcceptCalibrateCell(Int_t absID, Int_t bc,
   }
   
   //Recalibrate energy
-  amp  = cells->GetCellAmplitude(absID);
+  amp  = ampIn;
   if (!fCellsRecalibrated && IsRecalibrationOn()){
     if(fUse1Drecalib)
       amp *= GetEMCALChannelRecalibrationFactor1D(absID);
@@ -470,9 +500,8 @@ Bool_t AliEMCALRecoUtils::AcceptCalibrateCell(Int_t absID, Int_t bc,
       amp *= GetEMCALChannelRecalibrationFactor(imod,ieta,iphi);
   }
   // Recalibrate time
-  time = cells->GetCellTime(absID);
+  time = timeIn;
   time-=fConstantTimeShift*1e-9; // only in case of old Run1 simulation
-  Bool_t isLowGain = !(cells->GetCellHighGain(absID));//HG = false -> LG = true
 
   RecalibrateCellTime(absID,bc,time,isLowGain);
   
@@ -2140,6 +2169,17 @@ void AliEMCALRecoUtils::RecalibrateCells(AliVCaloCells * cells, Int_t bc)
   Double_t efrac = 0;
   
   Int_t nEMcell  = cells->GetNumberOfCells() ;  
+
+  // Not worth starting the threads for few cells
+  const Int_t kMinCellsPerThread = 500;
+  Int_t nThreads = TMath::Min(fNThreadsCellRecalibration, nEMcell / kMinCellsPerThread);
+  if (nThreads > 1)
+  {
+    RecalibrateCellsInThreads(cells, bc, nThreads);
+    fCellsRecalibrated = kTRUE;
+    return;
+  }
+
   for (Int_t iCell = 0; iCell < nEMcell; iCell++) 
   { 
     cells->GetCell( iCell, absId, ecellin, tcellin, mclabel, efrac );
@@ -2158,6 +2198,66 @@ void AliEMCALRecoUtils::RecalibrateCells(AliVCaloCells * cells, Int_t bc)
   fCellsRecalibrated = kTRUE;
 }
 
+///
+/// Recalibrate the cells as RecalibrateCells, with the list of cells split in
+/// contiguous ranges of positions, one per thread. The threads only read the cells
+/// and the calibration maps; the new values are set in the cells after the threads
+/// are done, since SetCell can change the sorting state of the list.
+/// The values of each cell are read from its position, instead of being searched by
+/// absolute ID, which gives the same result for a list without duplicated cells.
+///
+/// \param cells: list of cells
+/// \param bc: bunch crossing number returned by esdevent->GetBunchCrossNumber()
+/// \param nThreads: number of threads
+///
+//_______________________________________________________________________
+void AliEMCALRecoUtils::RecalibrateCellsInThreads(AliVCaloCells * cells, Int_t bc, Int_t nThreads)
+{
+  Int_t nEMcell = cells->GetNumberOfCells() ;
+  
+  std::vector<Short_t>  absIds(nEMcell);
+  std::vector<Float_t>  ecells(nEMcell);
+  std::vector<Double_t> tcells(nEMcell);
+  std::vector<Int_t>    mclabels(nEMcell);
+  std::vector<Double_t> efracs(nEMcell);
+  
+  auto recalibrateRange = [&](Int_t first, Int_t last) 
+  {
+    Double_t ecellin = 0;
+    Double_t tcellin = 0;
+    for (Int_t iCell = first; iCell < last; iCell++) 
+    {
+      cells->GetCell( iCell, absIds[iCell], ecellin, tcellin, mclabels[iCell], efracs[iCell] );
+      
+      Bool_t accept = AcceptCalibrateCell(absIds[iCell], bc, ecellin, tcellin, !(cells->GetHighGain(iCell)),
+                                          ecells[iCell], tcells[iCell]);
+      if (!accept)
+      {
+        ecells[iCell] = 0;
+        tcells[iCell] = -1;
+      }
+    }
+  };
+  
+  // The last range is done in this thread
+  std::vector<std::thread> threads;
+  Int_t first = 0;
+  for (Int_t iThread = 0; iThread < nThreads; iThread++) 
+  {
+    Int_t last = first + (nEMcell - first) / (nThreads - iThread);
+    if (iThread < nThreads - 1) 
+      threads.push_back(std::thread(recalibrateRange, first, last));
+    else 
+      recalibrateRange(first, last);
+    first = last;
+  }
+  for (UInt_t iThread = 0; iThread < threads.size(); iThread++) threads[iThread].join();
+  
+  // Set new values
+  for (Int_t iCell = 0; iCell < nEMcell; iCell++) 
+    cells->SetCell(iCell, absIds[iCell], ecells[iCell], tcells[iCell], mclabels[iCell], efracs[iCell]);
+}
+
 ///
 /// Recalibrate time of cell from AbsID number considering cell calibration map 
 ///
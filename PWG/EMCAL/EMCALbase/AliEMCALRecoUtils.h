@@ -162,7 +162,11 @@ public:
   //-----------------------------------------------------
   Bool_t   AcceptCalibrateCell(Int_t absId, Int_t bc,
                                Float_t & amp, Double_t & time, AliVCaloCells* cells) ; // Energy and Time
+  Bool_t   AcceptCalibrateCell(Int_t absId, Int_t bc, Double_t ampIn, Double_t timeIn, Bool_t isLowGain,
+                               Float_t & amp, Double_t & time) const ; // Energy and Time, from the cell values
   void     RecalibrateCells(AliVCaloCells * cells, Int_t bc) ; // Energy and Time
+  void     SetNThreadsForCellRecalibration(Int_t n)      { fNThreadsCellRecalibration = n ; }
+  Int_t    GetNThreadsForCellRecalibration()       const { return fNThreadsCellRecalibration ; }
   void     RecalibrateClusterEnergy(const AliEMCALGeometry* geom, AliVCluster* cluster, AliVCaloCells * cells, Int_t bc=-1) ; // Energy and time
   void     ResetCellsCalibrated()                        { fCellsRecalibrated = kFALSE; }
 
@@ -506,6 +510,8 @@ public:
                                                       Float_t & amp, TArrayI & labeArr, TArrayF & eDepArr ) const;
 private:  
   
+  void       RecalibrateCellsInThreads(AliVCaloCells * cells, Int_t bc, Int_t nThreads) ;
+  
   // Position recalculation
   Float_t    fMisalTransShift[15];       ///< Cluster position translation shift parameters
   Float_t    fMisalRotShift[15];         ///< Cluster position rotation shift parameters
@@ -533,6 +539,7 @@ private:
   Bool_t     fRecalibration;             ///< Switch on or off the recalibration
   Bool_t     fUse1Drecalib;              ///< Flag to use one dimensional recalibration histogram
   TObjArray* fEMCALRecalibrationFactors; ///< Array of histograms with map of recalibration factors, EMCAL
+  Int_t      fNThreadsCellRecalibration; //!<! Number of threads sharing the cells in RecalibrateCells (<=1: serial loop)
     
   // Time Recalibration 
   Float_t    fConstantTimeShift;         ///< Apply a 600 ns (+15.8) time shift in case of simulation, shift in ns.
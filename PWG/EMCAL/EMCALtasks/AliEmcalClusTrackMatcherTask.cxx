@@ -13,8 +13,7 @@
 #include <AliLog.h>
 #include <AliVCluster.h>
 #include <AliVTrack.h>
-#include <AliEMCALRecoUtils.h>
-
+#include "AliEmcalCorrectionEventManager.h"
 #include "AliEmcalParticle.h"
 #include "AliParticleContainer.h"
 #include "AliClusterContainer.h"
@@ -261,7 +260,7 @@ void AliEmcalClusTrackMatcherTask::GenerateEmcalParticles()
         propthistrack = kTRUE;
       }
     }
-    if (propthistrack) AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(track, fPropDist);
+    if (propthistrack) AliEmcalCorrectionEventManager::ExtrapolateTrackToEMCalSurface(InputEvent(), track, fPropDist);
 
     // Create AliEmcalParticle objects to handle the matching
     AliEmcalParticle* emcalTrack = new ((*fEmcalTracks)[fNEmcalTracks]) AliEmcalParticle(track, tracks->GetCurrentID());
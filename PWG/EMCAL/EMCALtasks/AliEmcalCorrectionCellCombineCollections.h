@@ -37,6 +37,8 @@ class AliEmcalCorrectionCellCombineCollections : public AliEmcalCorrectionCompon
   void UserCreateOutputObjects();
   void ExecOnce();
   Bool_t Run();
+  // Reads the cells of the external event and adds the combined cells to the input event
+  Bool_t AccessesOnlyInputObjects() const { return kFALSE; }
 
   std::string GetExternalCellsBranchName()                      const { return fExternalCellsBranchName; }
   std::string GetCombinedCellsBranchName()                      const { return fCreatedCellsBranchName; }
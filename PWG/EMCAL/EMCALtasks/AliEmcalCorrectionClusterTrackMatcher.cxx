@@ -3,8 +3,13 @@
 
 #include "AliEmcalCorrectionClusterTrackMatcher.h"
 
+#include <algorithm>
+
 #include <TH1.h>
 #include <TList.h>
+#include <TMath.h>
+#include <TVector2.h>
+#include <TVector3.h>
 
 #include "AliClusterContainer.h"
 #include "AliParticleContainer.h"
@@ -38,6 +43,7 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fUseOuterParamInESDs(kFALSE),
   fUpdateTracks(kTRUE),
   fUpdateClusters(kTRUE),
+  fUseEtaPhiGrid(kTRUE),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap(),
   fEmcalTracks(0),
@@ -46,6 +52,18 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fNEmcalClusters(0),
   fHistMatchEtaAll(0),
   fHistMatchPhiAll(0),
+  fGridNEta(0),
+  fGridNPhi(0),
+  fGridEtaMin(0),
+  fGridEtaMax(0),
+  fGridEtaInvWidth(0),
+  fGridPhiInvWidth(0),
+  fGridClusterEta(),
+  fGridClusterPhi(),
+  fGridCellFirst(),
+  fGridCellClusters(),
+  fGridUnbinnedClusters(),
+  fGridCandidates(),
   fNMCGenerToAccept(0),
   fMCGenerToAcceptForTrack(1)
 {
@@ -82,6 +100,7 @@ Bool_t AliEmcalCorrectionClusterTrackMatcher::Initialize()
   GetProperty("maxDist", fMaxDistance);
   GetProperty("updateClusters", fUpdateClusters);
   GetProperty("updateTracks", fUpdateTracks);
+  GetProperty("useEtaPhiGrid", fUseEtaPhiGrid);
   fDoPropagation = fEsdMode;
   
   Bool_t enableFracEMCRecalc = kFALSE;
@@ -334,8 +353,8 @@ void AliEmcalCorrectionClusterTrackMatcher::GenerateEmcalParticles()
           if ( !generOK ) continue;
         }
         
-        // Propagate the track
-        AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(track, fPropDist, mass, 20, 0.35, kFALSE, fUseDCA, fUseOuterParamInESDs);
+        // Propagate the track, or take the result of a previous propagation in this event
+        fEventManager.ExtrapolateTrackToEMCalSurface(track, fPropDist, mass, 20, 0.35, kFALSE, fUseDCA, fUseOuterParamInESDs);
       }
 
       // Reset properties of the track to fix TRefArray errors which occur when AddTrackMatched(obj) is called.
@@ -365,52 +384,210 @@ void AliEmcalCorrectionClusterTrackMatcher::GenerateEmcalParticles()
 
 /**
  * Set the links between tracks and clusters.
+ *
+ * If fUseEtaPhiGrid is set, the cluster positions are sorted in an \f$\eta\f$-\f$\phi\f$ grid
+ * with cells of at least fMaxDistance, and each track is only compared with the clusters of the cells
+ * which overlap with the \f$\eta\f$-\f$\phi\f$ window of size fMaxDistance around its position on the EMCal surface.
+ * The candidates are compared in increasing cluster index, as in the loop over all the pairs,
+ * such that the matching results are identical.
  */
 void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
 {
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
-  for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
-    AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
-    AliVTrack* track = emcalTrack->GetTrack();
+  if (!fUseEtaPhiGrid || fMaxDistance <= 0) {
+    for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
+      AliVTrack* track = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack))->GetTrack();
 
-    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
-      AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
-      AliVCluster* cluster = emcalCluster->GetCluster();
-      
-      Double_t deta = 999;
-      Double_t dphi = 999;
-      GetEtaPhiDiff(track, cluster, dphi, deta);
-      Double_t d2 = deta * deta + dphi * dphi;
+      for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+        AliVCluster* cluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster))->GetCluster();
 
-      if (d2 > maxd2) continue;
-      
-      Double_t d = TMath::Sqrt(d2);
-      emcalCluster->AddMatchedObj(itrack, d);
-      emcalTrack->AddMatchedObj(icluster, d);
-      AliDebug(2, Form("Now matching cluster E = %.3f, pT = %.3f, eta = %.3f, phi = %.3f "
-                       "with track pT = %.3f, eta = %.3f, phi = %.3f"
-                       "Track eta, phi on EMCal = %.3f, %.3f, d = %.3f",
-                       cluster->GetNonLinCorrEnergy(), emcalCluster->Pt(), emcalCluster->Eta(), emcalCluster->Phi(),
-                       emcalTrack->Pt(), emcalTrack->Eta(), emcalTrack->Phi(),
-                       track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), d));
-      
-      if (fCreateHisto) {
-        Int_t mombin = GetMomBin(track->P());
-        Int_t centbinch = fCentBin;
-        if (track->Charge() < 0) centbinch += fNcentBins;
-        Int_t etabin = 0;
-        if(track->Eta() > 0) etabin = 1;
-
-        fHistMatchEta[centbinch][mombin][etabin]->Fill(deta);
-        fHistMatchPhi[centbinch][mombin][etabin]->Fill(dphi);
-        fHistMatchEtaAll->Fill(deta);
-        fHistMatchPhiAll->Fill(dphi);
+        Double_t deta = 999;
+        Double_t dphi = 999;
+        GetEtaPhiDiff(track, cluster, dphi, deta);
+        MatchTrackAndCluster(itrack, icluster, deta, dphi, maxd2);
       }
     }
+    return;
+  }
+
+  BuildEtaPhiGrid();
+
+  for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
+    AliVTrack* track = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack))->GetTrack();
+    Double_t veta = track->GetTrackEtaOnEMCal();
+    Double_t vphi = track->GetTrackPhiOnEMCal();
+
+    GetEtaPhiGridCandidates(veta, vphi);
+
+    for (std::vector<Int_t>::const_iterator it = fGridCandidates.begin(); it != fGridCandidates.end(); ++it) {
+      // Same differences as in GetEtaPhiDiff()
+      Double_t deta = veta - fGridClusterEta[*it];
+      Double_t dphi = TVector2::Phi_mpi_pi(vphi - fGridClusterPhi[*it]);
+      MatchTrackAndCluster(itrack, *it, deta, dphi, maxd2);
+    }
   }
 }
 
+/**
+ * Link a track and a cluster if their distance on the EMCal surface is below fMaxDistance.
+ * @param[in] itrack Index of the track in fEmcalTracks
+ * @param[in] icluster Index of the cluster in fEmcalClusters
+ * @param[in] deta Difference in \f$\eta\f$ between the track and the cluster
+ * @param[in] dphi Difference in \f$\phi\f$ between the track and the cluster
+ * @param[in] maxd2 Square of the maximum matching distance
+ */
+void AliEmcalCorrectionClusterTrackMatcher::MatchTrackAndCluster(Int_t itrack, Int_t icluster, Double_t deta, Double_t dphi, Double_t maxd2)
+{
+  Double_t d2 = deta * deta + dphi * dphi;
+
+  if (d2 > maxd2) return;
+
+  AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
+  AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
+  AliVTrack* track = emcalTrack->GetTrack();
+  AliVCluster* cluster = emcalCluster->GetCluster();
+
+  Double_t d = TMath::Sqrt(d2);
+  emcalCluster->AddMatchedObj(itrack, d);
+  emcalTrack->AddMatchedObj(icluster, d);
+  AliDebug(2, Form("Now matching cluster E = %.3f, pT = %.3f, eta = %.3f, phi = %.3f "
+                   "with track pT = %.3f, eta = %.3f, phi = %.3f"
+                   "Track eta, phi on EMCal = %.3f, %.3f, d = %.3f",
+                   cluster->GetNonLinCorrEnergy(), emcalCluster->Pt(), emcalCluster->Eta(), emcalCluster->Phi(),
+                   emcalTrack->Pt(), emcalTrack->Eta(), emcalTrack->Phi(),
+                   track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), d));
+
+  if (fCreateHisto) {
+    Int_t mombin = GetMomBin(track->P());
+    Int_t centbinch = fCentBin;
+    if (track->Charge() < 0) centbinch += fNcentBins;
+    Int_t etabin = 0;
+    if(track->Eta() > 0) etabin = 1;
+
+    fHistMatchEta[centbinch][mombin][etabin]->Fill(deta);
+    fHistMatchPhi[centbinch][mombin][etabin]->Fill(dphi);
+    fHistMatchEtaAll->Fill(deta);
+    fHistMatchPhiAll->Fill(dphi);
+  }
+}
+
+/**
+ * Sort the clusters of the event in an \f$\eta\f$-\f$\phi\f$ grid (counting sort).
+ * The \f$\eta\f$ range is the one of the clusters of the event, the \f$\phi\f$ range is \f$[0, 2\pi)\f$.
+ * Both cell widths are at least fMaxDistance. Clusters with a non-finite position are kept aside,
+ * they are compared with all tracks as in the loop over all the pairs.
+ */
+void AliEmcalCorrectionClusterTrackMatcher::BuildEtaPhiGrid()
+{
+  const Int_t kMaxCells = 1000;   // maximum number of cells in each direction
+
+  fGridClusterEta.resize(fNEmcalClusters);
+  fGridClusterPhi.resize(fNEmcalClusters);
+  fGridUnbinnedClusters.clear();
+
+  fGridEtaMin = 0;
+  fGridEtaMax = 0;
+  Bool_t first = kTRUE;
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    AliVCluster* cluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster))->GetCluster();
+
+    // Same position as in GetEtaPhiDiff()
+    Float_t pos[3] = {0};
+    cluster->GetPosition(pos);
+    TVector3 cpos(pos);
+    Double_t ceta = cpos.Eta();
+    Double_t cphi = cpos.Phi();
+    fGridClusterEta[icluster] = ceta;
+    fGridClusterPhi[icluster] = cphi;
+
+    if (!TMath::Finite(ceta) || !TMath::Finite(cphi)) {
+      fGridUnbinnedClusters.push_back(icluster);
+      continue;
+    }
+    if (first || ceta < fGridEtaMin) fGridEtaMin = ceta;
+    if (first || ceta > fGridEtaMax) fGridEtaMax = ceta;
+    first = kFALSE;
+  }
+
+  fGridNEta = TMath::Max(1, TMath::Min(kMaxCells, Int_t((fGridEtaMax - fGridEtaMin) / fMaxDistance)));
+  fGridEtaInvWidth = (fGridEtaMax > fGridEtaMin) ? fGridNEta / (fGridEtaMax - fGridEtaMin) : 0;
+  fGridNPhi = TMath::Max(1, TMath::Min(kMaxCells, Int_t(TMath::TwoPi() / fMaxDistance)));
+  fGridPhiInvWidth = fGridNPhi / TMath::TwoPi();
+
+  // Count the clusters per cell, then fill the cells
+  std::vector<Int_t> clusterCell(fNEmcalClusters, -1);
+  fGridCellFirst.assign(fGridNEta * fGridNPhi + 1, 0);
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    Double_t ceta = fGridClusterEta[icluster];
+    Double_t cphi = fGridClusterPhi[icluster];
+    if (!TMath::Finite(ceta) || !TMath::Finite(cphi)) continue;
+
+    Int_t ieta = TMath::Min(fGridNEta - 1, Int_t((ceta - fGridEtaMin) * fGridEtaInvWidth));
+    Int_t iphi = Int_t(TVector2::Phi_0_2pi(cphi) * fGridPhiInvWidth);
+    if (iphi >= fGridNPhi) iphi -= fGridNPhi;
+    clusterCell[icluster] = ieta * fGridNPhi + iphi;
+    fGridCellFirst[clusterCell[icluster] + 1]++;
+  }
+  for (UInt_t icell = 1; icell < fGridCellFirst.size(); icell++) {
+    fGridCellFirst[icell] += fGridCellFirst[icell - 1];
+  }
+
+  fGridCellClusters.resize(fGridCellFirst.back());
+  std::vector<Int_t> cellFill(fGridCellFirst.begin(), fGridCellFirst.end() - 1);
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    if (clusterCell[icluster] < 0) continue;
+    fGridCellClusters[cellFill[clusterCell[icluster]]++] = icluster;
+  }
+}
+
+/**
+ * Fill fGridCandidates with the indices of the clusters which can be matched to a track,
+ * in increasing order. The window is enlarged by a small margin to be robust against rounding.
+ * @param[in] veta \f$\eta\f$ of the track on the EMCal surface
+ * @param[in] vphi \f$\phi\f$ of the track on the EMCal surface
+ */
+void AliEmcalCorrectionClusterTrackMatcher::GetEtaPhiGridCandidates(Double_t veta, Double_t vphi)
+{
+  const Double_t kMargin = 1e-6;
+
+  fGridCandidates.clear();
+
+  // Tracks with a non-finite position are compared with all the clusters
+  if (!TMath::Finite(veta) || !TMath::Finite(vphi)) {
+    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) fGridCandidates.push_back(icluster);
+    return;
+  }
+
+  fGridCandidates.insert(fGridCandidates.end(), fGridUnbinnedClusters.begin(), fGridUnbinnedClusters.end());
+
+  const Double_t window = fMaxDistance + kMargin;
+  if (fGridCellClusters.empty() || veta + window < fGridEtaMin || veta - window > fGridEtaMax) return;
+
+  Int_t etaFirst = 0;
+  if (veta - window > fGridEtaMin) etaFirst = TMath::Min(fGridNEta - 1, Int_t((veta - window - fGridEtaMin) * fGridEtaInvWidth));
+  Int_t etaLast = fGridNEta - 1;
+  if (veta + window < fGridEtaMax) etaLast = TMath::Min(fGridNEta - 1, Int_t((veta + window - fGridEtaMin) * fGridEtaInvWidth));
+
+  Double_t vphi0 = TVector2::Phi_0_2pi(vphi);
+  Int_t phiFirst = TMath::FloorNint((vphi0 - window) * fGridPhiInvWidth);
+  Int_t phiLast = TMath::FloorNint((vphi0 + window) * fGridPhiInvWidth);
+  if (phiLast - phiFirst + 1 >= fGridNPhi) {
+    phiFirst = 0;
+    phiLast = fGridNPhi - 1;
+  }
+
+  for (Int_t ieta = etaFirst; ieta <= etaLast; ieta++) {
+    for (Int_t jphi = phiFirst; jphi <= phiLast; jphi++) {
+      Int_t iphi = ((jphi % fGridNPhi) + fGridNPhi) % fGridNPhi;
+      Int_t icell = ieta * fGridNPhi + iphi;
+      fGridCandidates.insert(fGridCandidates.end(), fGridCellClusters.begin() + fGridCellFirst[icell], fGridCellClusters.begin() + fGridCellFirst[icell + 1]);
+    }
+  }
+
+  std::sort(fGridCandidates.begin(), fGridCandidates.end());
+}
+
 /**
  * Update clusters with matching info.
  */
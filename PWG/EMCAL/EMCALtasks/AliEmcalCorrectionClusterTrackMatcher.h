@@ -1,6 +1,8 @@
 #ifndef ALIEMCALCORRECTIONCLUSTERTRACKMATCHER_H
 #define ALIEMCALCORRECTIONCLUSTERTRACKMATCHER_H
 
+#include <vector>
+
 #include "AliEmcalCorrectionComponent.h"
 
 #if !(defined(__CINT__) || defined(__MAKECINT__))
@@ -69,6 +71,9 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Int_t         GetMomBin(Double_t p) const;
   void          GenerateEmcalParticles();
   void          DoMatching();
+  void          MatchTrackAndCluster(Int_t itrack, Int_t icluster, Double_t deta, Double_t dphi, Double_t maxd2);
+  void          BuildEtaPhiGrid();
+  void          GetEtaPhiGridCandidates(Double_t veta, Double_t vphi);
   void          UpdateTracks();
   void          UpdateClusters();
   Bool_t        IsTrackInEmcalAcceptance(AliVParticle* part, Double_t edges=0.9) const;
@@ -88,6 +93,7 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Bool_t        fUseOuterParamInESDs;   ///< Use TPC outer parameters instead of inner parameters for track propagation, ESDs only
   Bool_t        fUpdateTracks;          ///< update tracks with matching info
   Bool_t        fUpdateClusters;        ///< update clusters with matching info
+  Bool_t        fUseEtaPhiGrid;         ///< if true then only clusters in the eta-phi grid cells around each track are compared with it
   
 #if !(defined(__CINT__) || defined(__MAKECINT__))
   // Handle mapping between index and containers
@@ -104,6 +110,20 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   TH1          *fHistMatchEta[10][9][2]; //!<!deta distribution
   TH1          *fHistMatchPhi[10][9][2]; //!<!dphi distribution
   
+  // Eta-phi grid of the cluster positions, rebuilt for each event
+  Int_t                 fGridNEta;              //!<!number of eta cells
+  Int_t                 fGridNPhi;              //!<!number of phi cells
+  Double_t              fGridEtaMin;            //!<!lowest cluster eta
+  Double_t              fGridEtaMax;            //!<!highest cluster eta
+  Double_t              fGridEtaInvWidth;       //!<!inverse of the eta cell width
+  Double_t              fGridPhiInvWidth;       //!<!inverse of the phi cell width
+  std::vector<Double_t> fGridClusterEta;        //!<!cluster eta, by cluster index
+  std::vector<Double_t> fGridClusterPhi;        //!<!cluster phi, by cluster index
+  std::vector<Int_t>    fGridCellFirst;         //!<!position of the first cluster of each cell in fGridCellClusters
+  std::vector<Int_t>    fGridCellClusters;      //!<!cluster indices ordered by cell
+  std::vector<Int_t>    fGridUnbinnedClusters;  //!<!clusters with a non-finite position, compared with all tracks
+  std::vector<Int_t>    fGridCandidates;        //!<!clusters to be compared with the current track
+  
   Int_t      fNMCGenerToAccept;          ///<  Number of MC generators that should not be included in analysis
   TString    fMCGenerToAccept[5];        ///<  List with name of generators that should not be included
   Bool_t     fMCGenerToAcceptForTrack;   ///<  Activate the removal of tracks entering the track matching that come from a particular generator
@@ -116,7 +136,7 @@ private:
   static RegisterCorrectionComponent<AliEmcalCorrectionClusterTrackMatcher> reg;
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 5); // EMCal cluster track matcher correction component
+  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 6); // EMCal cluster track matcher correction component
   /// \endcond
 };
 
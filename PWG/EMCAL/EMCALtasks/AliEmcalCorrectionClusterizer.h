@@ -44,6 +44,8 @@ class AliEmcalCorrectionClusterizer : public AliEmcalCorrectionComponent {
   void UserCreateOutputObjects();
   Bool_t Run();
   Bool_t CheckIfRunChanged();
+  // The MC labels of the cells can be taken from the clusters of the event
+  Bool_t AccessesOnlyInputObjects() const { return !(fSetCellMCLabelFromCluster || fSetCellMCLabelFromEdepFrac); }
   
 protected:
   void           Clusterize();
@@ -53,6 +53,12 @@ class AliEmcalCorrectionComponent : public TNamed {
   virtual Bool_t Run();
   virtual Bool_t UserNotify();
   virtual Bool_t CheckIfRunChanged();
+  /**
+   * True if the component only accesses the event through its cells, clusters and tracks. It can then
+   * run concurrently with the components of other input objects (see AliEmcalCorrectionTask::DetermineComponentChains()).
+   * Components which read or create other objects of the event must return false.
+   */
+  virtual Bool_t AccessesOnlyInputObjects() const { return kTRUE; }
   
   void GetEtaPhiDiff(const AliVTrack *t, const AliVCluster *v, Double_t &phidiff, Double_t &etadiff);
   void UpdateCells();
@@ -79,6 +85,8 @@ class AliEmcalCorrectionComponent : public TNamed {
   AliTrackContainer      *GetTrackContainer(const char* name)              const { return dynamic_cast<AliTrackContainer*>(GetParticleContainer(name))     ; }
   void                    RemoveParticleContainer(Int_t i=0)                     { fParticleCollArray.RemoveAt(i)                      ; }
   void                    RemoveClusterContainer(Int_t i=0)                      { fClusterCollArray.RemoveAt(i)                       ; }
+  Int_t                   GetNParticleContainers()                         const { return fParticleCollArray.GetEntriesFast()          ; }
+  Int_t                   GetNClusterContainers()                          const { return fClusterCollArray.GetEntriesFast()           ; }
   AliEMCALRecoUtils      *GetRecoUtils()  const { return fRecoUtils; }
   AliVCaloCells          *GetCaloCells()  const { return fCaloCells; }
   TList                  *GetOutputList() const { return fOutput; }
@@ -87,6 +95,8 @@ class AliEmcalCorrectionComponent : public TNamed {
   void SetRecoUtils(AliEMCALRecoUtils *ru) { fRecoUtils = ru; }
 
   void SetInputEvent(AliVEvent * event) { fEventManager.SetInputEvent(event); }
+  /// Event used by the component: the internal event or the external (embedded) event
+  AliVEvent *GetInputEvent() const { return fEventManager.InputEvent(); }
   void SetMCEvent(AliMCEvent * mcevent) { fMCEvent = mcevent; }
   /**
    * If we are using standard input event then the embedded event should not be used!
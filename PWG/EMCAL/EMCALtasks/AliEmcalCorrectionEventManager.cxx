@@ -2,7 +2,70 @@
 //
 
 #include "AliEmcalCorrectionEventManager.h"
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "AliAnalysisManager.h"
+#include "AliEMCALRecoUtils.h"
 #include "AliEmcalContainerUtils.h"
+#include "AliVTrack.h"
+
+namespace {
+
+/**
+ * @struct ExtrapolationCacheEntry
+ * @brief Result of the extrapolation of a track to the EMCal surface, with the parameters used for it
+ */
+struct ExtrapolationCacheEntry {
+  const AliVTrack * fTrack;       ///< Extrapolated track, to protect against duplicated track IDs
+  Double_t fPx;                   ///< Momentum of the track at the time of the extrapolation, to protect
+  Double_t fPy;                   ///< against reused track slots and IDs in a later event
+  Double_t fPz;                   ///<
+  Double_t fXv;                   ///< Position of the track at the time of the extrapolation
+  Double_t fYv;                   ///<
+  Double_t fZv;                   ///<
+  Short_t fCharge;                ///< Charge of the track
+  Double_t fEmcalR;               ///< Distance to the EMCal surface
+  Double_t fMass;                 ///< Mass hypothesis
+  Double_t fStep;                 ///< Propagation step
+  Double_t fMinPt;                ///< Minimum pT to propagate the track
+  Bool_t fUseMassForTracking;     ///< Use the PID mass of the track
+  Bool_t fUseDCA;                 ///< Start from the DCA instead of the primary vertex
+  Bool_t fUseOuterParam;          ///< Use the TPC outer parameters (ESD)
+  Bool_t fResult;                 ///< Return value of the extrapolation
+  Double_t fEta;                  ///< Eta on the EMCal surface
+  Double_t fPhi;                  ///< Phi on the EMCal surface
+  Double_t fPt;                   ///< pT on the EMCal surface
+};
+
+/**
+ * @struct ExtrapolationCacheEvent
+ * @brief Cached extrapolations of one input event, with the identifiers of the event they were filled for
+ */
+struct ExtrapolationCacheEvent {
+  Long64_t fEntry;                ///< Entry of the analysis manager (entry in the current tree)
+  Int_t fRunNumber;               ///< Run number
+  UInt_t fPeriodNumber;           ///< Period number
+  UInt_t fOrbitNumber;            ///< Orbit number
+  UShort_t fBunchCrossNumber;     ///< Bunch crossing number
+  Int_t fEventNumberInFile;       ///< Event number in the input file
+  std::unordered_map<Int_t, ExtrapolationCacheEntry> fTracks; ///< Extrapolations by track ID
+};
+
+/// Cached extrapolations, by event
+std::map<const AliVEvent *, ExtrapolationCacheEvent> gExtrapolationCache;
+/// Protects the cache, the correction components of independent input objects can run concurrently
+std::mutex gExtrapolationCacheMutex;
+/// Serializes the extrapolations, the material budget is computed with the navigator of the TGeoManager
+std::mutex gPropagationMutex;
+
+}
+
+Bool_t AliEmcalCorrectionEventManager::fgUseExtrapolationCache = kFALSE;
+ULong64_t AliEmcalCorrectionEventManager::fgNExtrapolationCacheHits = 0;
+ULong64_t AliEmcalCorrectionEventManager::fgNExtrapolationCacheMisses = 0;
 
 /**
  * Standard constructor
@@ -47,3 +110,119 @@ AliVEvent * AliEmcalCorrectionEventManager::InputEvent() const
 {
   return AliEmcalContainerUtils::GetEvent(fInputEvent, fUseEmbedding);
 }
+
+/**
+ * Extrapolate a track of the current input event to the EMCal surface, using the shared extrapolation cache.
+ * See the static version for the details.
+ *
+ * @return True if the track was extrapolated to the EMCal surface
+ */
+Bool_t AliEmcalCorrectionEventManager::ExtrapolateTrackToEMCalSurface(AliVTrack * track, Double_t emcalR, Double_t mass, Double_t step, Double_t minpT,
+                                                                      Bool_t useMassForTracking, Bool_t useDCA, Bool_t useOuterParam) const
+{
+  return ExtrapolateTrackToEMCalSurface(InputEvent(), track, emcalR, mass, step, minpT, useMassForTracking, useDCA, useOuterParam);
+}
+
+/**
+ * Extrapolate a track to the EMCal surface with AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(), unless it was
+ * already extrapolated with the same parameters in the same event. In that case the \f$\eta\f$, \f$\phi\f$ and
+ * \f$p_{T}\f$ on the EMCal surface are set from the cache. The tracks are identified by their ID in the event
+ * (and their address, since the IDs are not unique in all the track collections).
+ *
+ * The cache of an event is cleared when the entry of the analysis manager, the run, period, orbit or bunch
+ * crossing number, or the event number in the file changes. The entry alone is not enough, since it is counted
+ * in the current tree (two files with one event each both have entry 0). As MC events have no orbit and bunch
+ * crossing numbers, a cached extrapolation is in addition only used if the momentum, position and charge of the
+ * track are still the ones it was extrapolated with, such that a reused track slot and ID of a new event is
+ * never given the values of the previous one. Without analysis manager the tracks are always extrapolated.
+ *
+ * The cache is disabled by default, see SetUseExtrapolationCache().
+ *
+ * @param event Event which the track belongs to
+ * @param track Track to be extrapolated
+ * @param emcalR Distance to the EMCal surface
+ * @param mass Mass hypothesis (negative to use the PID mass)
+ * @param step Propagation step
+ * @param minpT Minimum pT to propagate the track
+ * @param useMassForTracking Use the PID mass of the track
+ * @param useDCA Start from the DCA instead of the primary vertex
+ * @param useOuterParam Use the TPC outer parameters (ESD only)
+ * @return True if the track was extrapolated to the EMCal surface
+ */
+Bool_t AliEmcalCorrectionEventManager::ExtrapolateTrackToEMCalSurface(const AliVEvent * event, AliVTrack * track, Double_t emcalR, Double_t mass, Double_t step, Double_t minpT,
+                                                                      Bool_t useMassForTracking, Bool_t useDCA, Bool_t useOuterParam)
+{
+  AliAnalysisManager * mgr = AliAnalysisManager::GetAnalysisManager();
+  if (!fgUseExtrapolationCache || !mgr || !event || !track) {
+    std::lock_guard<std::mutex> lock(gPropagationMutex);
+    return AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(track, emcalR, mass, step, minpT, useMassForTracking, useDCA, useOuterParam);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(gExtrapolationCacheMutex);
+    ExtrapolationCacheEvent & eventCache = gExtrapolationCache[event];
+    if (eventCache.fEntry != mgr->GetCurrentEntry() || eventCache.fRunNumber != event->GetRunNumber() ||
+        eventCache.fPeriodNumber != event->GetPeriodNumber() || eventCache.fOrbitNumber != event->GetOrbitNumber() ||
+        eventCache.fBunchCrossNumber != event->GetBunchCrossNumber() || eventCache.fEventNumberInFile != event->GetEventNumberInFile()) {
+      // New event: keep the allocated map, only remove its content
+      eventCache.fTracks.clear();
+      eventCache.fEntry = mgr->GetCurrentEntry();
+      eventCache.fRunNumber = event->GetRunNumber();
+      eventCache.fPeriodNumber = event->GetPeriodNumber();
+      eventCache.fOrbitNumber = event->GetOrbitNumber();
+      eventCache.fBunchCrossNumber = event->GetBunchCrossNumber();
+      eventCache.fEventNumberInFile = event->GetEventNumberInFile();
+    }
+
+    const ExtrapolationCacheEntry & cached = eventCache.fTracks[track->GetID()];
+    if (cached.fTrack == track && cached.fPx == track->Px() && cached.fPy == track->Py() && cached.fPz == track->Pz() &&
+        cached.fXv == track->Xv() && cached.fYv == track->Yv() && cached.fZv == track->Zv() && cached.fCharge == track->Charge() &&
+        cached.fEmcalR == emcalR && cached.fMass == mass && cached.fStep == step && cached.fMinPt == minpT &&
+        cached.fUseMassForTracking == useMassForTracking && cached.fUseDCA == useDCA && cached.fUseOuterParam == useOuterParam) {
+      track->SetTrackPhiEtaPtOnEMCal(cached.fPhi, cached.fEta, cached.fPt);
+      fgNExtrapolationCacheHits++;
+      return cached.fResult;
+    }
+    fgNExtrapolationCacheMisses++;
+  }
+
+  // The extrapolation is done without holding the lock of the cache
+  Bool_t result = kFALSE;
+  {
+    std::lock_guard<std::mutex> lock(gPropagationMutex);
+    result = AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(track, emcalR, mass, step, minpT, useMassForTracking, useDCA, useOuterParam);
+  }
+
+  std::lock_guard<std::mutex> lock(gExtrapolationCacheMutex);
+  ExtrapolationCacheEntry & cached = gExtrapolationCache[event].fTracks[track->GetID()];
+  cached.fTrack = track;
+  cached.fPx = track->Px();
+  cached.fPy = track->Py();
+  cached.fPz = track->Pz();
+  cached.fXv = track->Xv();
+  cached.fYv = track->Yv();
+  cached.fZv = track->Zv();
+  cached.fCharge = track->Charge();
+  cached.fEmcalR = emcalR;
+  cached.fMass = mass;
+  cached.fStep = step;
+  cached.fMinPt = minpT;
+  cached.fUseMassForTracking = useMassForTracking;
+  cached.fUseDCA = useDCA;
+  cached.fUseOuterParam = useOuterParam;
+  cached.fResult = result;
+  cached.fEta = track->GetTrackEtaOnEMCal();
+  cached.fPhi = track->GetTrackPhiOnEMCal();
+  cached.fPt = track->GetTrackPtOnEMCal();
+  return result;
+}
+
+/**
+ * Remove all the extrapolations from the cache. The extrapolations of an event are removed automatically when
+ * the next event is seen, this is only needed to release the memory.
+ */
+void AliEmcalCorrectionEventManager::ClearExtrapolationCache()
+{
+  std::lock_guard<std::mutex> lock(gExtrapolationCacheMutex);
+  gExtrapolationCache.clear();
+}
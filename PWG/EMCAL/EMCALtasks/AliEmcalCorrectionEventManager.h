@@ -3,6 +3,8 @@
 
 #include "AliAnalysisTaskSE.h"
 
+class AliVTrack;
+
 /**
  * @class AliEmcalCorrectionEventManager
  * @ingroup EMCALCORRECTIONFW
@@ -23,6 +25,14 @@
  * AliEmcalCorrectionComponent::SetUsingInputEvent(). In that case, if there is a non-embedded container,
  * it will call SetUsingInputEvent(true), which will ensure that the component uses the internal event.
  *
+ * The manager also gives access to a cache of the track extrapolations to the EMCal surface, shared by all the
+ * components and tasks in the train (see ExtrapolateTrackToEMCalSurface()). The \f$\eta\f$, \f$\phi\f$ and
+ * \f$p_{T}\f$ at the surface are stored per event and per track ID, such that a track which was already
+ * propagated with the same parameters in the same event is not propagated again. An event is identified by the
+ * entry of the analysis manager together with its run, period, orbit and bunch crossing numbers and its event
+ * number in the file, and its cache is cleared when any of them changes. A cached extrapolation is in addition
+ * only used if the momentum, position and charge of the track are still the ones it was extrapolated with.
+ *
  * @author Raymond Ehlers <raymond.ehlers@yale.edu>, Yale University
  * @date Jun 29, 2017
  */
@@ -53,9 +63,25 @@ class AliEmcalCorrectionEventManager : public AliAnalysisTaskSE
    */
   void SetUseEmbeddingEvent(bool b = true) { fUseEmbedding = b; }
 
+  Bool_t ExtrapolateTrackToEMCalSurface(AliVTrack * track, Double_t emcalR = 440, Double_t mass = 0.1396, Double_t step = 20, Double_t minpT = 0.35,
+                                        Bool_t useMassForTracking = kFALSE, Bool_t useDCA = kFALSE, Bool_t useOuterParam = kFALSE) const;
+  static Bool_t ExtrapolateTrackToEMCalSurface(const AliVEvent * event, AliVTrack * track, Double_t emcalR = 440, Double_t mass = 0.1396, Double_t step = 20, Double_t minpT = 0.35,
+                                               Bool_t useMassForTracking = kFALSE, Bool_t useDCA = kFALSE, Bool_t useOuterParam = kFALSE);
+  /// Enable or disable the extrapolation cache (disabled by default, "useExtrapolationCache" in the YAML configuration of AliEmcalCorrectionTask)
+  static void SetUseExtrapolationCache(Bool_t b = kTRUE) { fgUseExtrapolationCache = b; }
+  static void ClearExtrapolationCache();
+  /// Number of extrapolations taken from the cache
+  static ULong64_t GetNExtrapolationCacheHits() { return fgNExtrapolationCacheHits; }
+  /// Number of extrapolations actually performed through the cache
+  static ULong64_t GetNExtrapolationCacheMisses() { return fgNExtrapolationCacheMisses; }
+
  protected:
   bool fUseEmbedding;      ///< If true, return the embedded event instead
 
+  static Bool_t fgUseExtrapolationCache;             //!<! If true, the track extrapolations are cached
+  static ULong64_t fgNExtrapolationCacheHits;        //!<! Number of extrapolations taken from the cache
+  static ULong64_t fgNExtrapolationCacheMisses;      //!<! Number of extrapolations performed through the cache
+
  private:
   AliEmcalCorrectionEventManager(const AliEmcalCorrectionEventManager &);               // Not implemented
   AliEmcalCorrectionEventManager &operator=(const AliEmcalCorrectionEventManager &);    // Not implemented
@@ -25,6 +25,8 @@ class AliEmcalCorrectionPHOSCorrections : public AliEmcalCorrectionComponent {
   void UserCreateOutputObjects();
   Bool_t Run();
   Bool_t CheckIfRunChanged();
+  // Corrects the PHOS clusters of the event through the tender supply
+  Bool_t AccessesOnlyInputObjects() const { return kFALSE; }
   
   AliPHOSTenderSupply*          GetPHOSTenderSupply() {return fPHOSTender;}
 
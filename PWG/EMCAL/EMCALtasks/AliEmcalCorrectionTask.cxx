@@ -7,19 +7,26 @@
 #include "AliEmcalCorrectionComponent.h"
 
 #include <vector>
+#include <map>
 #include <set>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <TChain.h>
+#include <TH2F.h>
+#include <TROOT.h>
+#include <TStopwatch.h>
 
 #include <AliAnalysisManager.h>
 #include <AliVEventHandler.h>
 #include <AliESDEvent.h>
 #include <AliAODEvent.h>
 #include <AliEMCALGeometry.h>
+#include <AliEMCALRecoUtils.h>
 #include <AliVCaloCells.h>
 #include <AliLog.h>
 #include <AliCentrality.h>
@@ -64,7 +71,13 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask() :
   fParticleCollArray(),
   fClusterCollArray(),
   fCellCollArray(),
-  fOutput(0)
+  fOutput(0),
+  fNThreads(1),
+  fComponentStage(),
+  fComponentChain(),
+  fComponentTime(),
+  fComponentRunNumbers(),
+  fHistComponentTime(0)
 {
   // Default constructor
   AliDebug(3, Form("%s", __PRETTY_FUNCTION__));
@@ -109,7 +122,13 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask(const char * name) :
   fParticleCollArray(),
   fClusterCollArray(),
   fCellCollArray(),
-  fOutput(0)
+  fOutput(0),
+  fNThreads(1),
+  fComponentStage(),
+  fComponentChain(),
+  fComponentTime(),
+  fComponentRunNumbers(),
+  fHistComponentTime(0)
 {
   // Standard constructor
   AliDebug(3, Form("%s", __PRETTY_FUNCTION__));
@@ -153,7 +172,13 @@ AliEmcalCorrectionTask::AliEmcalCorrectionTask(const AliEmcalCorrectionTask & ta
   fGeom(task.fGeom),
   fParticleCollArray(*(static_cast<TObjArray *>(task.fParticleCollArray.Clone()))),
   fClusterCollArray(*(static_cast<TObjArray *>(task.fClusterCollArray.Clone()))),
-  fOutput(task.fOutput)                           // TODO: More care is needed here!
+  fOutput(task.fOutput),                          // TODO: More care is needed here!
+  fNThreads(task.fNThreads),
+  fComponentStage(task.fComponentStage),
+  fComponentChain(task.fComponentChain),
+  fComponentTime(task.fComponentTime),
+  fComponentRunNumbers(task.fComponentRunNumbers),
+  fHistComponentTime(task.fHistComponentTime)
 {
   // Vertex position
   std::copy(std::begin(task.fVertex), std::end(task.fVertex), std::begin(fVertex));
@@ -218,6 +243,12 @@ void swap(AliEmcalCorrectionTask & first, AliEmcalCorrectionTask & second)
   swap(first.fClusterCollArray, second.fClusterCollArray);
   swap(first.fCellCollArray, second.fCellCollArray);
   swap(first.fOutput, second.fOutput);
+  swap(first.fNThreads, second.fNThreads);
+  swap(first.fComponentStage, second.fComponentStage);
+  swap(first.fComponentChain, second.fComponentChain);
+  swap(first.fComponentTime, second.fComponentTime);
+  swap(first.fComponentRunNumbers, second.fComponentRunNumbers);
+  swap(first.fHistComponentTime, second.fHistComponentTime);
 }
 
 /**
@@ -274,6 +305,20 @@ void AliEmcalCorrectionTask::Initialize(bool removeDummyTask)
   // Determine component execution order
   DetermineComponentsToExecute(fOrderedComponentsToExecute);
 
+  // Number of threads for the components of independent input objects
+  // Not required, such that older default configurations can still be used
+  int nThreads = 1;
+  fYAMLConfig.GetProperty("nThreads", nThreads, false);
+  fNThreads = nThreads;
+
+  // Cache of the track extrapolations to the EMCal surface, shared by the tasks of the train
+  // Opt-in and not required, it can only be enabled here, such that the other tasks are not affected
+  bool useExtrapolationCache = false;
+  fYAMLConfig.GetProperty("useExtrapolationCache", useExtrapolationCache, false);
+  if (useExtrapolationCache) {
+    AliEmcalCorrectionEventManager::SetUseExtrapolationCache(kTRUE);
+  }
+
   // Check for user defined settings that are not in the default file
   CheckForUnmatchedUserSettings();
 
@@ -1038,6 +1083,15 @@ void AliEmcalCorrectionTask::UserCreateOutputObjects()
 
   UserCreateOutputObjectsComponents();
 
+  // Time spent in each component per event, the last bin is the time of all the components
+  Int_t nComponents = fCorrectionComponents.size();
+  fHistComponentTime = new TH2F("fHistComponentTime", "Time per event of the correction components;;#it{t} (ms)", nComponents + 1, 0, nComponents + 1, 1000, 0, 100);
+  for (Int_t i = 0; i < nComponents; i++) {
+    fHistComponentTime->GetXaxis()->SetBinLabel(i + 1, fCorrectionComponents[i]->GetName());
+  }
+  fHistComponentTime->GetXaxis()->SetBinLabel(nComponents + 1, "Total");
+  fOutput->Add(fHistComponentTime);
+
   PostData(1, fOutput);
 }
 
@@ -1155,6 +1209,11 @@ void AliEmcalCorrectionTask::ExecOnce()
     SetCellsObjectInCellContainerBasedOnProperties(cellObj);
   }
 
+  // The components of different threads can create objects, for example TClonesArray entries
+  if (fNThreads > 1) {
+    ROOT::EnableThreadSafety();
+  }
+
   fEventInitialized = kTRUE;
 
   // Print warning to the user that the rest of the configuration information is available in the generation log
@@ -1195,6 +1254,106 @@ void AliEmcalCorrectionTask::ExecOnceComponents()
       AddContainersToComponent(component, AliEmcalContainerUtils::kCaloCells, true);
     }
   }
+
+  // The input objects of all the components are now available
+  DetermineComponentChains();
+}
+
+/**
+ * Groups the correction components which can be run concurrently. The components are split in stages, which are
+ * run one after the other. A component which does not only access its input objects (see
+ * AliEmcalCorrectionComponent::AccessesOnlyInputObjects()) or does not have any input object forms a stage by itself.
+ * Inside a stage, the components which share an input object (the cells, a cluster or track container or the
+ * array of a container) are in the same chain. The chains of a stage are independent of each other: they
+ * are run concurrently when the number of threads ("nThreads" in the %YAML configuration) is larger than 1.
+ * The components of a chain are always run in the order of the configuration.
+ *
+ * For example, the cell corrections of the input event and of the embedded event are two chains of the same
+ * stage, while the combination of the cells of the two events is a stage by itself.
+ */
+void AliEmcalCorrectionTask::DetermineComponentChains()
+{
+  std::size_t nComponents = fCorrectionComponents.size();
+  fComponentStage.assign(nComponents, 0);
+  fComponentChain.assign(nComponents, 0);
+  fComponentTime.assign(nComponents, 0);
+
+  // Input objects accessed by each component
+  std::vector <std::set <const TObject *> > inputObjects(nComponents);
+  for (std::size_t i = 0; i < nComponents; i++)
+  {
+    AliEmcalCorrectionComponent * component = fCorrectionComponents[i];
+    if (component->GetCaloCells()) {
+      inputObjects[i].insert(component->GetCaloCells());
+    }
+    for (Int_t iCont = 0; iCont < component->GetNClusterContainers(); iCont++) {
+      AliEmcalContainer * cont = component->GetClusterContainer(iCont);
+      inputObjects[i].insert(cont);
+      if (cont->GetArray()) inputObjects[i].insert(cont->GetArray());
+    }
+    for (Int_t iCont = 0; iCont < component->GetNParticleContainers(); iCont++) {
+      AliEmcalContainer * cont = component->GetParticleContainer(iCont);
+      inputObjects[i].insert(cont);
+      if (cont->GetArray()) inputObjects[i].insert(cont->GetArray());
+    }
+  }
+
+  // Stages
+  Int_t stage = 0;
+  bool stageIsEmpty = true;
+  for (std::size_t i = 0; i < nComponents; i++)
+  {
+    bool standalone = !(fCorrectionComponents[i]->AccessesOnlyInputObjects()) || inputObjects[i].empty();
+    if (standalone && !stageIsEmpty) {
+      stage++;
+    }
+    fComponentStage[i] = stage;
+    stageIsEmpty = false;
+    if (standalone) {
+      stage++;
+      stageIsEmpty = true;
+    }
+  }
+
+  // Chains: each component starts its own chain, which is merged with the chains of the previous components
+  // of the stage that share an input object with it
+  for (std::size_t i = 0; i < nComponents; i++)
+  {
+    fComponentChain[i] = i;
+    for (std::size_t j = 0; j < i; j++)
+    {
+      if (fComponentStage[j] != fComponentStage[i] || fComponentChain[j] == fComponentChain[i]) continue;
+      bool shareInputObject = false;
+      for (auto obj : inputObjects[i]) {
+        if (inputObjects[j].count(obj)) {
+          shareInputObject = true;
+          break;
+        }
+      }
+      if (!shareInputObject) continue;
+      Int_t mergedChain = fComponentChain[i];
+      for (std::size_t k = 0; k <= i; k++) {
+        if (fComponentChain[k] == mergedChain) fComponentChain[k] = fComponentChain[j];
+      }
+    }
+  }
+
+  // Number the chains of each stage from 0, in the order of their first component
+  std::map <Int_t, Int_t> chainNumbers;
+  for (std::size_t i = 0; i < nComponents; i++)
+  {
+    if (i > 0 && fComponentStage[i] != fComponentStage[i - 1]) chainNumbers.clear();
+    auto chainNumber = chainNumbers.insert(std::make_pair(fComponentChain[i], Int_t(chainNumbers.size())));
+    fComponentChain[i] = chainNumber.first->second;
+  }
+
+  if (fNThreads > 1) {
+    std::stringstream tempSS;
+    for (std::size_t i = 0; i < nComponents; i++) {
+      tempSS << "\n\t" << fCorrectionComponents[i]->GetName() << ": stage " << fComponentStage[i] << ", chain " << fComponentChain[i];
+    }
+    AliInfo(TString::Format("Running the correction components with %d threads:%s", fNThreads, tempSS.str().c_str()));
+  }
 }
 
 /**
@@ -1292,10 +1451,16 @@ Bool_t AliEmcalCorrectionTask::RetrieveEventObjects()
 
 /**
  * Executed each event. It sets run-by-run properties in the correction components and calls Run() for each
- * component.
+ * component. The stages of components are run in order (see DetermineComponentChains()). If more than one thread
+ * is requested, the chains of each stage run concurrently, except when the run number of the event of any
+ * component changed, since the components then load their run dependent settings. The cell recalibration of a
+ * component is shared among the threads when the chains of its stage do not run concurrently. The time spent in
+ * each component is filled in fHistComponentTime.
  */
 Bool_t AliEmcalCorrectionTask::Run()
 {
+  TStopwatch eventTimer;
+
   // Run the initialization for all derived classes.
   for (auto component : fCorrectionComponents)
   {
@@ -1304,8 +1469,59 @@ Bool_t AliEmcalCorrectionTask::Run()
     component->SetCentralityBin(fCentBin);
     component->SetCentrality(fCent);
     component->SetVertex(fVertex);
+  }
 
-    component->Run();
+  // The components read the internal or the external (embedded) event, and load their run dependent
+  // settings when the run number of their event changes
+  std::size_t nComponents = fCorrectionComponents.size();
+  bool runNumberChanged = (fComponentRunNumbers.size() != nComponents);
+  fComponentRunNumbers.resize(nComponents, -1);
+  for (std::size_t i = 0; i < nComponents; i++)
+  {
+    AliVEvent * event = fCorrectionComponents[i]->GetInputEvent();
+    Int_t runNumber = event ? event->GetRunNumber() : -1;
+    if (runNumber != fComponentRunNumbers[i]) {
+      runNumberChanged = true;
+      fComponentRunNumbers[i] = runNumber;
+    }
+  }
+  bool runConcurrently = (fNThreads > 1 && !runNumberChanged);
+
+  std::size_t iFirst = 0;
+  while (iFirst < nComponents)
+  {
+    // Components of the stage
+    std::size_t iEnd = iFirst;
+    Int_t nChains = 0;
+    while (iEnd < nComponents && fComponentStage[iEnd] == fComponentStage[iFirst]) {
+      nChains = std::max(nChains, fComponentChain[iEnd] + 1);
+      iEnd++;
+    }
+
+    // The threads are used either for the chains or for the cell recalibration within a component
+    bool runChainsConcurrently = (runConcurrently && nChains > 1);
+    for (std::size_t i = iFirst; i < iEnd; i++) {
+      if (fCorrectionComponents[i]->GetRecoUtils()) {
+        fCorrectionComponents[i]->GetRecoUtils()->SetNThreadsForCellRecalibration(runChainsConcurrently ? 1 : fNThreads);
+      }
+    }
+
+    if (runChainsConcurrently) {
+      RunComponentChainsInThreads(iFirst, iEnd, nChains);
+    }
+    else {
+      for (std::size_t i = iFirst; i < iEnd; i++) {
+        RunComponent(i);
+      }
+    }
+    iFirst = iEnd;
+  }
+
+  if (fHistComponentTime) {
+    for (std::size_t i = 0; i < nComponents; i++) {
+      fHistComponentTime->Fill(i, fComponentTime[i]);
+    }
+    fHistComponentTime->Fill(nComponents, eventTimer.RealTime() * 1e3);
   }
 
   PostData(1, fOutput);
@@ -1313,6 +1529,49 @@ Bool_t AliEmcalCorrectionTask::Run()
   return kTRUE;
 }
 
+/**
+ * Run a correction component and store the time spent in it.
+ *
+ * @param[in] iComponent Index of the component in fCorrectionComponents
+ */
+void AliEmcalCorrectionTask::RunComponent(std::size_t iComponent)
+{
+  TStopwatch timer;
+  fCorrectionComponents[iComponent]->Run();
+  fComponentTime[iComponent] = timer.RealTime() * 1e3;
+}
+
+/**
+ * Run the chains of correction components of a stage concurrently. The chains are handed out one at a time
+ * to the threads, and the components of each chain are run in order by the same thread.
+ *
+ * @param[in] iFirst Index of the first component of the stage
+ * @param[in] iEnd Index after the last component of the stage
+ * @param[in] nChains Number of chains in the stage
+ */
+void AliEmcalCorrectionTask::RunComponentChainsInThreads(std::size_t iFirst, std::size_t iEnd, Int_t nChains)
+{
+  std::atomic<Int_t> nextChain(0);
+  auto runChains = [&]() {
+    for (Int_t iChain = nextChain++; iChain < nChains; iChain = nextChain++) {
+      for (std::size_t i = iFirst; i < iEnd; i++) {
+        if (fComponentChain[i] == iChain) RunComponent(i);
+      }
+    }
+  };
+
+  // This thread also runs chains
+  Int_t nThreads = std::min(fNThreads, nChains);
+  std::vector<std::thread> threads;
+  for (Int_t iThread = 1; iThread < nThreads; iThread++) {
+    threads.push_back(std::thread(runChains));
+  }
+  runChains();
+  for (auto & thread : threads) {
+    thread.join();
+  }
+}
+
 /**
  * Executed when the file is changed. Also calls UserNotify() for each component.
  */
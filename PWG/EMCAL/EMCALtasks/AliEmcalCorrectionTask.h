@@ -5,6 +5,7 @@ class AliEmcalCorrectionCellContainer;
 class AliEmcalCorrectionComponent;
 class AliEMCALGeometry;
 class AliVEvent;
+class TH2;
 
 #include <AliAnalysisTaskSE.h>
 #include <AliVCluster.h>
@@ -32,6 +33,11 @@ class AliVEvent;
  * In general, this steering class handles all of the configuration of the
  * corrections, including passing the relevant EMCal containers and event objects.
  *
+ * The components of independent input objects (for example the cells of the input
+ * and of the embedded events) can be run concurrently by setting the "nThreads"
+ * property of the %YAML configuration. The time spent in each component per event
+ * is filled in the histogram "fHistComponentTime" of the output.
+ *
  * Note: %YAML does not play nicely with CINT and dictionary generation, so it is
  * hidden using conditional inclusion.
  *
@@ -105,6 +111,8 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
   void                        SetCentralityEstimator(const char * c)                { fCentEst           = c                              ; }
   virtual void                SetNCentBins(Int_t n)                                 { fNcentBins         = n                              ; }
   void                        SetCentRange(Double_t min, Double_t max)              { fMinCent           = min  ; fMaxCent = max          ; }
+  // Threads, set with the "nThreads" property of the %YAML configuration
+  Int_t                       GetNThreads()                                   const { return fNThreads                                      ; }
 
   /**
    * Direct access to the correction components.
@@ -191,6 +199,9 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
   // Execute component functions
   void UserCreateOutputObjectsComponents();
   void ExecOnceComponents();
+  void DetermineComponentChains();
+  void RunComponent(std::size_t iComponent);
+  void RunComponentChainsInThreads(std::size_t iFirst, std::size_t iEnd, Int_t nChains);
 
   // Initialization functions
   void InitializeConfiguration();
@@ -248,8 +259,15 @@ class AliEmcalCorrectionTask : public AliAnalysisTaskSE {
   
   TList *                     fOutput;                     //!<! Output for histograms
 
+  Int_t                       fNThreads;                   ///< Number of threads running the components of independent input objects (<=1: sequential)
+  std::vector <Int_t>         fComponentStage;             //!<! Stage of each correction component (see DetermineComponentChains())
+  std::vector <Int_t>         fComponentChain;             //!<! Chain of each correction component in its stage
+  std::vector <Double_t>      fComponentTime;              //!<! Time spent in each correction component in the current event (ms)
+  std::vector <Int_t>         fComponentRunNumbers;        //!<! Run number of the event of each correction component in the previous event
+  TH2 *                       fHistComponentTime;          //!<! Time spent in each correction component per event
+
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionTask, 9); // EMCal correction task
+  ClassDef(AliEmcalCorrectionTask, 10); // EMCal correction task
   /// \endcond
 };
 
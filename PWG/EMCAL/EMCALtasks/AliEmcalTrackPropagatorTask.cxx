@@ -10,7 +10,7 @@
 #include <TClonesArray.h>
 
 #include <AliVTrack.h>
-#include <AliEMCALRecoUtils.h>
+#include "AliEmcalCorrectionEventManager.h"
 
 ClassImp(AliEmcalTrackPropagatorTask)
 
@@ -68,7 +68,7 @@ Bool_t AliEmcalTrackPropagatorTask::Run()
     if (fOnlyIfNotSet && track->IsExtrapolatedToEMCAL()) continue;
     if (fOnlyIfEmcal && !track->IsEMCAL()) continue;
     
-    AliEMCALRecoUtils::ExtrapolateTrackToEMCalSurface(track, fDist);
+    AliEmcalCorrectionEventManager::ExtrapolateTrackToEMCalSurface(InputEvent(), track, fDist);
   }
 
   return kTRUE;
@@ -32,6 +32,7 @@
 #include "AliEMCALTriggerRawPatch.h"
 #include "AliEmcalTriggerMakerKernel.h"
 #include "AliEmcalTriggerSetupInfo.h"
+#include "AliEmcalTriggerSparsePatchFinder.h"
 #include "AliLog.h"
 #include "AliVCaloCells.h"
 #include "AliVCaloTrigger.h"
@@ -50,6 +51,9 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fTriggerBitConfig(nullptr),
   fPatchFinder(nullptr),
   fLevel0PatchFinder(nullptr),
+  fSparsePatchFinder(nullptr),
+  fSparseLevel0PatchFinder(nullptr),
+  fUseSparseFastORGrid(kFALSE),
   fL0MinTime(7),
   fL0MaxTime(10),
   fMinCellAmp(0),
@@ -74,6 +78,8 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fPatchEnergySimpleSmeared(nullptr),
   fLevel0TimeMap(nullptr),
   fTriggerBitMap(nullptr),
+  fNonZeroFastORs(),
+  fIsNonZeroFastOR(),
   fADCtoGeV(1.)
 {
   memset(fThresholdConstants, 0, sizeof(Int_t) * 12);
@@ -92,6 +98,8 @@ AliEmcalTriggerMakerKernel::~AliEmcalTriggerMakerKernel() {
   delete fTriggerBitMap;
   delete fPatchFinder;
   delete fLevel0PatchFinder;
+  delete fSparsePatchFinder;
+  delete fSparseLevel0PatchFinder;
   if(fTriggerBitConfig) delete fTriggerBitConfig;
 }
 
@@ -116,6 +124,8 @@ void AliEmcalTriggerMakerKernel::Init(){
   fPatchADCSimple->Allocate(48, nrows);
   fLevel0TimeMap->Allocate(48, nrows);
   fTriggerBitMap->Allocate(48, nrows);
+  fIsNonZeroFastOR.assign(48 * nrows, 0);
+  fNonZeroFastORs.clear();
 
   if(fSmearModelMean && fSmearModelSigma){
     // Allocate container for energy smearing (if enabled)
@@ -131,6 +141,9 @@ void AliEmcalTriggerMakerKernel::AddL1TriggerAlgorithm(Int_t rowmin, Int_t rowma
   trigger->SetPatchSize(patchSize);
   trigger->SetSubregionSize(subregionSize);
   fPatchFinder->AddTriggerAlgorithm(trigger);
+
+  if (!fSparsePatchFinder) fSparsePatchFinder = new PWG::EMCAL::AliEmcalTriggerSparsePatchFinder;
+  fSparsePatchFinder->AddTriggerAlgorithm(rowmin, rowmax, bitmask, patchSize, subregionSize);
 }
 
 void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize)
@@ -139,6 +152,10 @@ void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowma
   fLevel0PatchFinder = new AliEMCALTriggerAlgorithm<double>(rowmin, rowmax, bitmask);
   fLevel0PatchFinder->SetPatchSize(patchSize);
   fLevel0PatchFinder->SetSubregionSize(subregionSize);
+
+  if (fSparseLevel0PatchFinder) delete fSparseLevel0PatchFinder;
+  fSparseLevel0PatchFinder = new PWG::EMCAL::AliEmcalTriggerSparsePatchFinder;
+  fSparseLevel0PatchFinder->AddTriggerAlgorithm(rowmin, rowmax, bitmask, patchSize, subregionSize);
 }
 
 void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
@@ -149,6 +166,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -167,6 +185,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -184,6 +203,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP20158x8()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -201,6 +221,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPPb2013()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -216,6 +237,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2012()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -231,6 +253,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -246,6 +269,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  if (fSparsePatchFinder) fSparsePatchFinder->ClearTriggerAlgorithms();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   fConfigured = true;
@@ -317,6 +341,17 @@ void AliEmcalTriggerMakerKernel::Reset(){
   fTriggerBitMap->Reset();
   if(fPatchEnergySimpleSmeared) fPatchEnergySimpleSmeared->Reset();
   memset(fL1ThresholdsOffline, 0, sizeof(ULong64_t) * 4);
+  for(auto fastor : fNonZeroFastORs) fIsNonZeroFastOR[fastor] = 0;
+  fNonZeroFastORs.clear();
+}
+
+void AliEmcalTriggerMakerKernel::TrackNonZeroFastOR(Int_t col, Int_t row){
+  if(!fUseSparseFastORGrid) return;
+  if(col < 0 || col >= kColsEta || row < 0) return;
+  Int_t fastor = row * kColsEta + col;
+  if(fastor >= static_cast<Int_t>(fIsNonZeroFastOR.size()) || fIsNonZeroFastOR[fastor]) return;
+  fIsNonZeroFastOR[fastor] = 1;
+  fNonZeroFastORs.push_back(fastor);
 }
 
 void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
@@ -374,6 +409,7 @@ void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
     if (adcAmp >= fMinL1FastORAmp) {
       try {
         (*fPatchADC)(globCol,globRow) = adcAmp;
+        if (adcAmp > 0) TrackNonZeroFastOR(globCol, globRow);
       }
       catch (AliEMCALTriggerDataGrid<double>::OutOfBoundsException &e) {
         std::string dirstring = e.GetDirection() == AliEMCALTriggerDataGrid<double>::OutOfBoundsException::kColDir ? "Col" : "Row";
@@ -395,6 +431,7 @@ void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
     if (amplitude >= fMinL0FastORAmp) {
       try{
         (*fPatchAmplitudes)(globCol,globRow) = amplitude;
+        if (amplitude > 0) TrackNonZeroFastOR(globCol, globRow);
       }
       catch (AliEMCALTriggerDataGrid<int>::OutOfBoundsException &e) {
         std::string dirstring = e.GetDirection() == AliEMCALTriggerDataGrid<int>::OutOfBoundsException::kColDir ? "Col" : "Row";
@@ -447,7 +484,10 @@ void AliEmcalTriggerMakerKernel::ReadCellData(AliVCaloCells *cells){
     // add
     amp /= fADCtoGeV;
     try {
-      if (amp >= fMinCellAmp) (*fPatchADCSimple)(globCol,globRow) += amp;
+      if (amp >= fMinCellAmp) {
+        (*fPatchADCSimple)(globCol,globRow) += amp;
+        if (amp > 0) TrackNonZeroFastOR(globCol, globRow);
+      }
     }
     catch (AliEMCALTriggerDataGrid<double>::OutOfBoundsException &e) {
     }
@@ -518,7 +558,10 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
       //l0PatchMask = 1 << fTriggerBitConfig->GetLevel0Bit();
 
   std::vector<AliEMCALTriggerRawPatch> patches;
-  if (fPatchFinder) {
+  if (fUseSparseFastORGrid && fSparsePatchFinder) {
+    patches = fSparsePatchFinder->FindPatches(useL0amp ? *fPatchAmplitudes : *fPatchADC, *fPatchADCSimple, fNonZeroFastORs);
+  }
+  else if (fPatchFinder) {
     if (useL0amp) {
       patches = fPatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
     }
@@ -580,7 +623,8 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
 
   // Find Level0 patches
   std::vector<AliEMCALTriggerRawPatch> l0patches;
-  if (fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
+  if (fUseSparseFastORGrid && fSparseLevel0PatchFinder) l0patches = fSparseLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple, fNonZeroFastORs);
+  else if (fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
   for(std::vector<AliEMCALTriggerRawPatch>::iterator patchit = l0patches.begin(); patchit != l0patches.end(); ++patchit){
     Int_t offlinebits = 0, onlinebits = 0;
     if(HasPHOSOverlap(*patchit)) continue;
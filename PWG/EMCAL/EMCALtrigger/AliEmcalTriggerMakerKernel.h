@@ -24,6 +24,7 @@ class AliEMCALTriggerBitConfig;
 template<class T> class AliEMCALTriggerDataGrid;
 template<class T> class AliEMCALTriggerAlgorithm;
 template<class T> class AliEMCALTriggerPatchFinder;
+namespace PWG { namespace EMCAL { class AliEmcalTriggerSparsePatchFinder; } }
 
 // To be moved to AliRoot in AliEMCALTriggerConstants.h at the first occasion
 namespace EMCALTrigger {
@@ -329,6 +330,17 @@ public:
    */
   void SetApplyOnlineBadChannelMaskingToOffline(Bool_t doApply = kTRUE) { fApplyOnlineBadChannelsToOffline = doApply; }
 
+  /**
+   * @brief Find the patches only from the non-zero FastORs
+   *
+   * The FastORs filled with non-zero values are tracked while reading the
+   * trigger and cell data, and the patches are found by the sparse patch
+   * finder from summed-area tables of the grids instead of summing each
+   * sliding window. The patches are the same as with the sliding windows.
+   * @param[in] doUse If true the sparse patch finder is used
+   */
+  void SetUseSparseFastORGrid(Bool_t doUse = kTRUE) { fUseSparseFastORGrid = doUse; }
+
   /**
    * @brief Reset all data grids and VZERO-dependent L1 thresholds
    */
@@ -495,6 +507,13 @@ protected:
    */
   bool HasPHOSOverlap(const AliEMCALTriggerRawPatch &patch) const;
 
+  /**
+   * @brief Keep track of a FastOR filled with a non-zero value (for the sparse patch finder)
+   * @param[in] col Column of the FastOR
+   * @param[in] row Row of the FastOR
+   */
+  void TrackNonZeroFastOR(Int_t col, Int_t row);
+
   std::set<Short_t>                         fBadChannels;                 ///< Container of bad channels
   std::set<Short_t>                         fOfflineBadChannels;          ///< Abd ID of offline bad channels
   TArrayF                                   fFastORPedestal;              ///< FastOR pedestal
@@ -502,6 +521,9 @@ protected:
 
   AliEMCALTriggerPatchFinder<double>       *fPatchFinder;                 ///< The actual patch finder
   AliEMCALTriggerAlgorithm<double>         *fLevel0PatchFinder;           ///< Patch finder for Level0 patches
+  PWG::EMCAL::AliEmcalTriggerSparsePatchFinder *fSparsePatchFinder;       ///< Patch finder from the non-zero FastORs (same algorithms as fPatchFinder)
+  PWG::EMCAL::AliEmcalTriggerSparsePatchFinder *fSparseLevel0PatchFinder; ///< Patch finder from the non-zero FastORs for Level0 patches
+  Bool_t                                    fUseSparseFastORGrid;         ///< Switch for finding the patches from the non-zero FastORs only
   Int_t                                     fL0MinTime;                   ///< Minimum L0 time
   Int_t                                     fL0MaxTime;                   ///< Maximum L0 time
   Int_t                                     fMinCellAmp;                  ///< Minimum offline amplitude of the cells used to generate the patches
@@ -531,11 +553,13 @@ protected:
   AliEMCALTriggerDataGrid<char>             *fLevel0TimeMap;              //!<! Map needed to store the level0 times
   AliEMCALTriggerDataGrid<int>              *fTriggerBitMap;              //!<! Map of trigger bits
   Double_t                                  fRhoValues[kNIndRho];         //!<! Rho values for background subtraction (only online ADC)
+  std::vector<Int_t>                        fNonZeroFastORs;              //!<! Positions (row * 48 + col) of the FastORs filled with non-zero values
+  std::vector<char>                         fIsNonZeroFastOR;             //!<! Flags of the FastORs in fNonZeroFastORs
 
   Double_t                                  fADCtoGeV;                    //!<! Conversion factor from ADC to GeV
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalTriggerMakerKernel, 4);
+  ClassDef(AliEmcalTriggerMakerKernel, 5);
   /// \endcond
 };
 
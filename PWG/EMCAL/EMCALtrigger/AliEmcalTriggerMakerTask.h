@@ -181,6 +181,14 @@ public:
     if(fTriggerMaker) fTriggerMaker->SetApplyOnlineBadChannelMaskingToOffline(doApply);
   }
 
+  /**
+   * @brief Find the patches only from the non-zero FastORs, using summed-area tables
+   * @param[in] doUse If true the sparse patch finder of the trigger maker kernel is used
+   */
+  void SetUseSparseFastORGrid(Bool_t doUse = kTRUE) {
+    if(fTriggerMaker) fTriggerMaker->SetUseSparseFastORGrid(doUse);
+  }
+
   void SetTriggerThresholdJetLow   ( Int_t a, Int_t b, Int_t c ) {
     if(fTriggerMaker) fTriggerMaker->SetTriggerThresholdJetLow(a, b, c);
   }
@@ -0,0 +1,174 @@
+/************************************************************************************
+ * Copyright (C) 2026, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+#include <numeric>
+#include "AliEMCALTriggerDataGrid.h"
+#include "AliEMCALTriggerRawPatch.h"
+#include "AliEmcalTriggerSparsePatchFinder.h"
+
+/// \cond CLASSIMP
+ClassImp(PWG::EMCAL::AliEmcalTriggerSparsePatchFinder);
+/// \endcond
+
+using namespace PWG::EMCAL;
+
+AliEmcalTriggerSparsePatchFinder::AliEmcalTriggerSparsePatchFinder():
+  TObject(),
+  fAlgorithms(),
+  fNCols(0),
+  fNRows(0),
+  fADCValues(),
+  fOfflineADCValues(),
+  fADCTable(),
+  fOfflineADCTable(),
+  fADCCountTable(),
+  fOfflineADCCountTable(),
+  fIsCandidate(),
+  fCandidates()
+{
+}
+
+void AliEmcalTriggerSparsePatchFinder::AddTriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize) {
+  TriggerAlgorithm algorithm;
+  algorithm.fRowMin = rowmin;
+  algorithm.fRowMax = rowmax;
+  algorithm.fBitMask = bitmask;
+  algorithm.fPatchSize = patchSize;
+  algorithm.fSubregionSize = subregionSize;
+  fAlgorithms.push_back(algorithm);
+}
+
+std::vector<AliEMCALTriggerRawPatch> AliEmcalTriggerSparsePatchFinder::FindPatches(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, const std::vector<Int_t> &fastors) {
+  std::vector<AliEMCALTriggerRawPatch> patches;
+  // Without non-zero FastOR no patch is above 0
+  if (fastors.empty()) return patches;
+
+  BuildSummedAreaTables(adc, offlineAdc, fastors);
+  for (const auto &algorithm : fAlgorithms) {
+    FindPatchesForAlgorithm(algorithm, fastors, patches);
+  }
+  return patches;
+}
+
+void AliEmcalTriggerSparsePatchFinder::BuildSummedAreaTables(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, const std::vector<Int_t> &fastors) {
+  fNCols = adc.GetNumberOfCols();
+  fNRows = adc.GetNumberOfRows();
+  const Int_t ncells = fNCols * fNRows, stride = fNCols + 1;
+
+  // Only the FastORs which can be non-zero are read from the grids
+  fADCValues.assign(ncells, 0.);
+  fOfflineADCValues.assign(ncells, 0.);
+  for (auto fastor : fastors) {
+    if (fastor < 0 || fastor >= ncells) continue;
+    Int_t col = fastor % fNCols, row = fastor / fNCols;
+    fADCValues[fastor] = adc(col, row);
+    fOfflineADCValues[fastor] = offlineAdc(col, row);
+  }
+
+  // Entry (row, col) of the tables is the sum over all rows < row and all columns < col
+  fADCTable.assign((fNRows + 1) * stride, 0.);
+  fOfflineADCTable.assign((fNRows + 1) * stride, 0.);
+  fADCCountTable.assign((fNRows + 1) * stride, 0);
+  fOfflineADCCountTable.assign((fNRows + 1) * stride, 0);
+  for (Int_t row = 0; row < fNRows; row++) {
+    double rowADC = 0., rowOfflineADC = 0.;
+    Int_t rowADCCount = 0, rowOfflineADCCount = 0;
+    for (Int_t col = 0; col < fNCols; col++) {
+      Int_t cell = row * fNCols + col, entry = (row + 1) * stride + col + 1;
+      rowADC += fADCValues[cell];
+      rowOfflineADC += fOfflineADCValues[cell];
+      if (fADCValues[cell] != 0.) rowADCCount++;
+      if (fOfflineADCValues[cell] != 0.) rowOfflineADCCount++;
+      fADCTable[entry] = fADCTable[entry - stride] + rowADC;
+      fOfflineADCTable[entry] = fOfflineADCTable[entry - stride] + rowOfflineADC;
+      fADCCountTable[entry] = fADCCountTable[entry - stride] + rowADCCount;
+      fOfflineADCCountTable[entry] = fOfflineADCCountTable[entry - stride] + rowOfflineADCCount;
+    }
+  }
+}
+
+void AliEmcalTriggerSparsePatchFinder::FindPatchesForAlgorithm(const TriggerAlgorithm &algorithm, const std::vector<Int_t> &fastors, std::vector<AliEMCALTriggerRawPatch> &patches) {
+  const Int_t size = algorithm.fPatchSize, step = algorithm.fSubregionSize;
+  if (size <= 0 || step <= 0) return;
+
+  // Patch positions of the sliding windows: rows from fRowMin to fRowMax - (size - 1) and
+  // columns from 0 to ncols - size, in steps of the subregion size
+  const Int_t rowStartMax = algorithm.fRowMax - (size - 1), colStartMax = fNCols - size;
+  if (rowStartMax < algorithm.fRowMin || colStartMax < 0) return;
+  const Int_t nRowPos = (rowStartMax - algorithm.fRowMin) / step + 1,
+              nColPos = colStartMax / step + 1,
+              nPos = nRowPos * nColPos,
+              nPosPerFastOR = ((size + step - 1) / step) * ((size + step - 1) / step);
+
+  fCandidates.clear();
+  if (static_cast<Long64_t>(fastors.size()) * nPosPerFastOR < nPos) {
+    // Only the positions of the windows containing a non-zero FastOR
+    if (static_cast<Int_t>(fIsCandidate.size()) < nPos) fIsCandidate.resize(nPos, 0);
+    for (auto fastor : fastors) {
+      if (fastor < 0 || fastor >= fNCols * fNRows) continue;
+      Int_t col = fastor % fNCols, drow = fastor / fNCols - algorithm.fRowMin;
+      if (drow < 0) continue;
+      Int_t rowPosMin = (drow - size + 1 > 0) ? (drow - size + step) / step : 0,
+            rowPosMax = std::min(drow / step, nRowPos - 1),
+            colPosMin = (col - size + 1 > 0) ? (col - size + step) / step : 0,
+            colPosMax = std::min(col / step, nColPos - 1);
+      for (Int_t irow = rowPosMin; irow <= rowPosMax; irow++) {
+        for (Int_t icol = colPosMin; icol <= colPosMax; icol++) {
+          Int_t pos = irow * nColPos + icol;
+          if (fIsCandidate[pos]) continue;
+          fIsCandidate[pos] = 1;
+          fCandidates.push_back(pos);
+        }
+      }
+    }
+    // Same order of the patches as in the sliding windows
+    std::sort(fCandidates.begin(), fCandidates.end());
+    for (auto pos : fCandidates) fIsCandidate[pos] = 0;
+  }
+  else {
+    // Dense event: all positions, the empty windows are rejected below
+    fCandidates.resize(nPos);
+    std::iota(fCandidates.begin(), fCandidates.end(), 0);
+  }
+
+  for (auto pos : fCandidates) {
+    Int_t col = (pos % nColPos) * step, row = algorithm.fRowMin + (pos / nColPos) * step;
+    // Windows outside the grid contain only zeros
+    if (row < 0 || row >= fNRows) continue;
+    Int_t nADC = WindowSum(fADCCountTable, col, row, size),
+          nOfflineADC = WindowSum(fOfflineADCCountTable, col, row, size);
+    if (!nADC && !nOfflineADC) continue;
+    // Sums of empty windows are set to exactly 0, without the rounding of the tables
+    double sumADC = nADC ? WindowSum(fADCTable, col, row, size) : 0.,
+           sumOfflineADC = nOfflineADC ? WindowSum(fOfflineADCTable, col, row, size) : 0.;
+    if (sumADC > 0 || sumOfflineADC > 0) {
+      AliEMCALTriggerRawPatch patch(col, row, size, sumADC, sumOfflineADC);
+      patch.SetBitmask(algorithm.fBitMask);
+      patches.push_back(patch);
+    }
+  }
+}
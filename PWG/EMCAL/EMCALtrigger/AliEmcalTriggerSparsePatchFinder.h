@@ -0,0 +1,168 @@
+/************************************************************************************
+ * Copyright (C) 2026, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef __ALIEMCALTRIGGERSPARSEPATCHFINDER_H__
+#define __ALIEMCALTRIGGERSPARSEPATCHFINDER_H__
+#include <vector>
+#include <TObject.h>
+
+class AliEMCALTriggerRawPatch;
+template<class T> class AliEMCALTriggerDataGrid;
+
+namespace PWG {
+
+namespace EMCAL {
+
+/**
+ * @class AliEmcalTriggerSparsePatchFinder
+ * @brief Patch finder running on the non-zero FastORs only
+ * @ingroup EMCALTRGFW
+ *
+ * Finds the same patches as AliEMCALTriggerPatchFinder with
+ * AliEMCALTriggerAlgorithm (same positions, sizes, bit masks and
+ * order of the patches), but without summing the FastORs of each
+ * window for each patch size:
+ * - The values of the FastORs which can be non-zero are collected into
+ *   summed-area tables of the online and offline ADC grids, in one pass.
+ *   With them the sum of any patch is obtained with 4 lookups.
+ * - Only the patch positions which contain at least one of these FastORs
+ *   are visited, so in low-multiplicity events most of the grid is skipped.
+ *   For dense events, all positions are visited and the empty ones are
+ *   rejected in O(1) via the number of non-zero FastORs in the window.
+ *
+ * As for the sliding windows, patches are kept if the online or the
+ * offline sum is above 0. Masked FastORs are never filled into the grids,
+ * so they do not contribute here either.
+ */
+class AliEmcalTriggerSparsePatchFinder : public TObject {
+public:
+  /**
+   * @struct TriggerAlgorithm
+   * @brief Settings of one sliding window algorithm
+   */
+  struct TriggerAlgorithm {
+    Int_t                 fRowMin;              ///< Minimum row of the patches
+    Int_t                 fRowMax;              ///< Maximum row of the patches
+    UInt_t                fBitMask;             ///< Bit mask assigned to the patches
+    Int_t                 fPatchSize;           ///< Size of the patches (in FastORs)
+    Int_t                 fSubregionSize;       ///< Step between the patch positions (in FastORs)
+  };
+
+  /**
+   * @brief Constructor
+   */
+  AliEmcalTriggerSparsePatchFinder();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalTriggerSparsePatchFinder() {}
+
+  /**
+   * @brief Add a trigger algorithm. Patches are returned in the order the algorithms were added
+   * @param[in] rowmin Minimum row value
+   * @param[in] rowmax Maximum row value
+   * @param[in] bitmask Bit mask to be applied to the patches
+   * @param[in] patchSize Size of the patches
+   * @param[in] subregionSize Size of the sliding sub region
+   */
+  void AddTriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize);
+
+  /**
+   * @brief Remove all trigger algorithms
+   */
+  void ClearTriggerAlgorithms() { fAlgorithms.clear(); }
+
+  /**
+   * @brief Get the trigger algorithms
+   * @return Settings of the trigger algorithms
+   */
+  const std::vector<TriggerAlgorithm> &GetTriggerAlgorithms() const { return fAlgorithms; }
+
+  /**
+   * @brief Find the patches of all trigger algorithms
+   * @param[in] adc Online ADC grid
+   * @param[in] offlineAdc Offline ADC grid (same dimensions as the online grid)
+   * @param[in] fastors Positions (row * number of columns + col) of all the FastORs which can be non-zero in the two grids
+   * @return Patches found by all the trigger algorithms
+   */
+  std::vector<AliEMCALTriggerRawPatch> FindPatches(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, const std::vector<Int_t> &fastors);
+
+protected:
+  /**
+   * @brief Build the summed-area tables and the counts of non-zero FastORs of the two grids
+   * @param[in] adc Online ADC grid
+   * @param[in] offlineAdc Offline ADC grid
+   * @param[in] fastors Positions of the FastORs which can be non-zero
+   */
+  void BuildSummedAreaTables(const AliEMCALTriggerDataGrid<double> &adc, const AliEMCALTriggerDataGrid<double> &offlineAdc, const std::vector<Int_t> &fastors);
+
+  /**
+   * @brief Find the patches of one algorithm from the summed-area tables
+   * @param[in] algorithm Settings of the algorithm
+   * @param[in] fastors Positions of the FastORs which can be non-zero
+   * @param[out] patches Container the patches are appended to
+   */
+  void FindPatchesForAlgorithm(const TriggerAlgorithm &algorithm, const std::vector<Int_t> &fastors, std::vector<AliEMCALTriggerRawPatch> &patches);
+
+  /**
+   * @brief Sum of a table over a window, with the window clipped to the grid
+   * @param[in] table Summed-area table ((number of rows + 1) x (number of columns + 1))
+   * @param[in] col Starting column of the window
+   * @param[in] row Starting row of the window
+   * @param[in] size Size of the window
+   * @return Sum over the window
+   */
+  template<typename T>
+  T WindowSum(const std::vector<T> &table, Int_t col, Int_t row, Int_t size) const {
+    Int_t colEnd = (col + size < fNCols) ? col + size : fNCols,
+          rowEnd = (row + size < fNRows) ? row + size : fNRows,
+          stride = fNCols + 1;
+    return table[rowEnd * stride + colEnd] - table[row * stride + colEnd] - table[rowEnd * stride + col] + table[row * stride + col];
+  }
+
+  std::vector<TriggerAlgorithm>     fAlgorithms;          ///< Trigger algorithms
+
+  Int_t                             fNCols;               //!<! Number of columns of the grids
+  Int_t                             fNRows;               //!<! Number of rows of the grids
+  std::vector<double>               fADCValues;           //!<! Online ADC of the FastORs, filled only at the non-zero positions
+  std::vector<double>               fOfflineADCValues;    //!<! Offline ADC of the FastORs, filled only at the non-zero positions
+  std::vector<double>               fADCTable;            //!<! Summed-area table of the online ADC
+  std::vector<double>               fOfflineADCTable;     //!<! Summed-area table of the offline ADC
+  std::vector<Int_t>                fADCCountTable;       //!<! Summed-area table of the number of FastORs with non-zero online ADC
+  std::vector<Int_t>                fOfflineADCCountTable;//!<! Summed-area table of the number of FastORs with non-zero offline ADC
+  std::vector<char>                 fIsCandidate;         //!<! Flags of the patch positions already selected as candidates
+  std::vector<Int_t>                fCandidates;          //!<! Candidate patch positions of the current algorithm
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalTriggerSparsePatchFinder, 1);
+  /// \endcond
+};
+
+}
+
+}
+#endif
@@ -21,4 +21,7 @@
 #pragma link C++ class PWG::EMCAL::AliEmcalTriggerSelectionCuts++;
 #pragma link C++ class PWG::EMCAL::AliEmcalTriggerSelection+;
 #pragma link C++ class PWG::EMCAL::Triggerinfo+;
+#pragma link C++ class PWG::EMCAL::AliEmcalTriggerSparsePatchFinder+;
+#pragma link C++ struct PWG::EMCAL::AliEmcalTriggerSparsePatchFinder::TriggerAlgorithm+;
+#pragma link C++ class std::vector<PWG::EMCAL::AliEmcalTriggerSparsePatchFinder::TriggerAlgorithm>+;
 #endif
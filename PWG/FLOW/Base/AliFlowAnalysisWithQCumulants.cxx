@@ -234,7 +234,12 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
  fnSubsamples(10),
  fRandom(NULL),
  fBootstrapCorrelations(NULL),
- fBootstrapCumulants(NULL)
+ fBootstrapCumulants(NULL),
+ // 12.) Fast engine:
+ fUseFastEngine(kFALSE),
+ fFastPhi(),
+ fFastWeight(),
+ fFastSums()
  {
   // constructor  
   
@@ -261,6 +266,7 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
   this->InitializeArraysForMixedHarmonics();
   this->InitializeArraysForControlHistograms();
   this->InitializeArraysForBootstrap();
+  this->InitializeArraysForFastEngine();
   
  } // end of constructor
  
@@ -311,6 +317,7 @@ void AliFlowAnalysisWithQCumulants::Init()
  this->BookEverythingForMixedHarmonics();
  this->BookEverythingForControlHistograms();
  this->BookEverythingForBootstrap();
+ this->BookEverythingForFastEngine();
 
  // d) Store flags for integrated and differential flow:
  this->StoreIntFlowFlags();
@@ -379,6 +386,12 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
  AliFlowTrackSimple *aftsTrack = NULL;
  Int_t n = fHarmonic; // shortcut for the harmonic 
+ Int_t nFastRPs = 0; // number of RPs stored in the flat arrays of the fast engine
+ if(fUseFastEngine && (Int_t)fFastPhi.size() < nPrim)
+ {
+  fFastPhi.resize(nPrim);
+  fFastWeight.resize(nPrim);
+ }
  for(Int_t i=0;i<nPrim;i++) 
  { 
   if(fExactNoRPs > 0 && nCounterNoRPs>fExactNoRPs){continue;}
@@ -409,23 +422,31 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     {
      wTrack = aftsTrack->Weight(); 
     }
-    // Calculate Re[Q_{m*n,k}] and Im[Q_{m*n,k}] for this event (m = 1,2,...,12, k = 0,1,...,8):
-    for(Int_t m=0;m<12;m++) // to be improved - hardwired 6 
-    {
-     for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-     {
-      (*fReQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1)*n*dPhi); 
-      (*fImQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1)*n*dPhi); 
-     } 
-    }
-    // Calculate S_{p,k} for this event (Remark: final calculation of S_{p,k} follows after the loop over data bellow):
-    for(Int_t p=0;p<8;p++)
+    if(fUseFastEngine) // Q_{m*n,k} and S_{p,k} are calculated after the loop over data from the flat arrays:
     {
-     for(Int_t k=0;k<9;k++)
-     {     
-      (*fSpk)(p,k)+=pow(wPhi*wPt*wEta*wTrack,k);
-     }
-    } 
+     fFastPhi[nFastRPs] = dPhi;
+     fFastWeight[nFastRPs] = wPhi*wPt*wEta*wTrack;
+     nFastRPs++;
+    } else // to if(fUseFastEngine)
+      {
+       // Calculate Re[Q_{m*n,k}] and Im[Q_{m*n,k}] for this event (m = 1,2,...,12, k = 0,1,...,8):
+       for(Int_t m=0;m<12;m++) // to be improved - hardwired 6 
+       {
+        for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
+        {
+         (*fReQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1)*n*dPhi); 
+         (*fImQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1)*n*dPhi); 
+        } 
+       }
+       // Calculate S_{p,k} for this event (Remark: final calculation of S_{p,k} follows after the loop over data bellow):
+       for(Int_t p=0;p<8;p++)
+       {
+        for(Int_t k=0;k<9;k++)
+        {     
+         (*fSpk)(p,k)+=pow(wPhi*wPt*wEta*wTrack,k);
+        }
+       } 
+      } // end of else // to if(fUseFastEngine)
     // Differential flow:
     if(fCalculateDiffFlow || fCalculate2DDiffFlow)
     {
@@ -547,6 +568,7 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
      printf("\n WARNING (QC): No particle (i.e. aftsTrack is a NULL pointer in AFAWQC::Make())!!!!\n\n");
     }
  } // end of for(Int_t i=0;i<nPrim;i++) 
+ if(fUseFastEngine){this->CalculateQvectorsFast(nFastRPs);}
 
  // e) Calculate the final expressions for S_{p,k} and s_{p,k} (important !!!!):
  for(Int_t p=0;p<8;p++)
@@ -720,6 +742,9 @@ void AliFlowAnalysisWithQCumulants::Finish()
  // i) Calculate cumulants for mixed harmonics;
  // j) Calculate cumulants for bootstrap.
 
+ // Materialize the sums accumulated by the fast engine (if used) in the reference flow profiles:
+ this->FinalizeFastEngine();
+
  // a) Check all pointers used in this method:
  this->CheckPointersUsedInFinish();
   
@@ -4047,10 +4072,10 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   fIntFlowCorrelationsAllEBE->SetBinContent(3,two3n3n);
   fIntFlowCorrelationsAllEBE->SetBinContent(4,two4n4n);         
   // Average 2-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(0.5,two1n1n,dMult*(dMult-1.));
-  fIntFlowCorrelationsAllPro->Fill(1.5,two2n2n,dMult*(dMult-1.)); 
-  fIntFlowCorrelationsAllPro->Fill(2.5,two3n3n,dMult*(dMult-1.)); 
-  fIntFlowCorrelationsAllPro->Fill(3.5,two4n4n,dMult*(dMult-1.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,0.5,two1n1n,dMult*(dMult-1.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,1.5,two2n2n,dMult*(dMult-1.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,2.5,two3n3n,dMult*(dMult-1.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,3.5,two4n4n,dMult*(dMult-1.)); 
   // Store separetately <2>:
   fIntFlowCorrelationsEBE->SetBinContent(1,two1n1n); // <2>  
   // Testing other multiplicity weights:
@@ -4065,8 +4090,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
        mWeight2p = dMult;           
       }          
   fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(1,mWeight2p); // eW_<2>
-  fIntFlowCorrelationsPro->Fill(0.5,two1n1n,mWeight2p);
-  fIntFlowSquaredCorrelationsPro->Fill(0.5,two1n1n*two1n1n,mWeight2p);
+  this->FillIntFlowProfile(kFastCorrelationsPro,0.5,two1n1n,mWeight2p);
+  this->FillIntFlowProfile(kFastSquaredCorrelationsPro,0.5,two1n1n*two1n1n,mWeight2p);
   if(fCalculateCumulantsVsM)
   {
    if(fFillProfilesVsMUsingWeights)  
@@ -4119,10 +4144,10 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   fIntFlowCorrelationsAllEBE->SetBinContent(8,three4n2n2n);
   fIntFlowCorrelationsAllEBE->SetBinContent(9,three4n3n1n);
   // Average 3-particle correlations for all events:                
-  fIntFlowCorrelationsAllPro->Fill(5.5,three2n1n1n,dMult*(dMult-1.)*(dMult-2.)); 
-  fIntFlowCorrelationsAllPro->Fill(6.5,three3n2n1n,dMult*(dMult-1.)*(dMult-2.));
-  fIntFlowCorrelationsAllPro->Fill(7.5,three4n2n2n,dMult*(dMult-1.)*(dMult-2.)); 
-  fIntFlowCorrelationsAllPro->Fill(8.5,three4n3n1n,dMult*(dMult-1.)*(dMult-2.));  
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,5.5,three2n1n1n,dMult*(dMult-1.)*(dMult-2.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,6.5,three3n2n1n,dMult*(dMult-1.)*(dMult-2.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,7.5,three4n2n2n,dMult*(dMult-1.)*(dMult-2.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,8.5,three4n3n1n,dMult*(dMult-1.)*(dMult-2.));  
   // Average 3-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
   {
@@ -4187,13 +4212,13 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   fIntFlowCorrelationsAllEBE->SetBinContent(16,four3n1n2n2n);
   fIntFlowCorrelationsAllEBE->SetBinContent(17,four4n2n1n1n);       
   // Average 4-particle correlations for all events:                
-  fIntFlowCorrelationsAllPro->Fill(10.5,four1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(11.5,four2n1n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(12.5,four2n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(13.5,four3n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(14.5,four3n1n3n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(15.5,four3n1n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));  
-  fIntFlowCorrelationsAllPro->Fill(16.5,four4n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));  
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,10.5,four1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,11.5,four2n1n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,12.5,four2n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,13.5,four3n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,14.5,four3n1n3n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,15.5,four3n1n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));  
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,16.5,four4n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));  
   // Average 4-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
   {
@@ -4219,8 +4244,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
        mWeight4p = dMult;           
       }      
   fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(2,mWeight4p); // eW_<4>
-  fIntFlowCorrelationsPro->Fill(1.5,four1n1n1n1n,mWeight4p);
-  fIntFlowSquaredCorrelationsPro->Fill(1.5,four1n1n1n1n*four1n1n1n1n,mWeight4p);
+  this->FillIntFlowProfile(kFastCorrelationsPro,1.5,four1n1n1n1n,mWeight4p);
+  this->FillIntFlowProfile(kFastSquaredCorrelationsPro,1.5,four1n1n1n1n*four1n1n1n1n,mWeight4p);
   if(fCalculateCumulantsVsM)
   {
    if(fFillProfilesVsMUsingWeights)  
@@ -4285,10 +4310,10 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   fIntFlowCorrelationsAllEBE->SetBinContent(21,five3n1n2n1n1n);
   fIntFlowCorrelationsAllEBE->SetBinContent(22,five4n1n1n1n1n);        
   // Average 5-particle correlations for all events:                         
-  fIntFlowCorrelationsAllPro->Fill(18.5,five2n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)); 
-  fIntFlowCorrelationsAllPro->Fill(19.5,five2n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(20.5,five3n1n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(21.5,five4n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,18.5,five2n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,19.5,five2n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,20.5,five3n1n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,21.5,five4n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)); 
   // Average 5-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
   {
@@ -4352,10 +4377,10 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   fIntFlowCorrelationsAllEBE->SetBinContent(26,six2n2n1n1n1n1n);
   fIntFlowCorrelationsAllEBE->SetBinContent(27,six3n1n1n1n1n1n);
   // Average 6-particle correlations for all events:         
-  fIntFlowCorrelationsAllPro->Fill(23.5,six1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
-  fIntFlowCorrelationsAllPro->Fill(24.5,six2n1n1n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
-  fIntFlowCorrelationsAllPro->Fill(25.5,six2n2n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
-  fIntFlowCorrelationsAllPro->Fill(26.5,six3n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,23.5,six1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,24.5,six2n1n1n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,25.5,six2n2n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,26.5,six3n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.)); 
   // Average 6-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
   {
@@ -4378,8 +4403,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
        mWeight6p = dMult;           
       }
   fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(3,mWeight6p); // eW_<6>
-  fIntFlowCorrelationsPro->Fill(2.5,six1n1n1n1n1n1n,mWeight6p);
-  fIntFlowSquaredCorrelationsPro->Fill(2.5,six1n1n1n1n1n1n*six1n1n1n1n1n1n,mWeight6p);
+  this->FillIntFlowProfile(kFastCorrelationsPro,2.5,six1n1n1n1n1n1n,mWeight6p);
+  this->FillIntFlowProfile(kFastSquaredCorrelationsPro,2.5,six1n1n1n1n1n1n*six1n1n1n1n1n1n,mWeight6p);
   if(fCalculateCumulantsVsM)
   {
    if(fFillProfilesVsMUsingWeights)  
@@ -4423,7 +4448,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   // Average 7-particle correlations for single event: 
   fIntFlowCorrelationsAllEBE->SetBinContent(29,seven2n1n1n1n1n1n1n);       
   // Average 7-particle correlations for all events:                      
-  fIntFlowCorrelationsAllPro->Fill(28.5,seven2n1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,28.5,seven2n1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)
                                                                  *(dMult-4.)*(dMult-5.)*(dMult-6.));
   // Average 7-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
@@ -4462,7 +4487,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   // Average 8-particle correlations for single event: 
   fIntFlowCorrelationsAllEBE->SetBinContent(31,eight1n1n1n1n1n1n1n1n);      
   // Average 8-particle correlations for all events:                       
-  fIntFlowCorrelationsAllPro->Fill(30.5,eight1n1n1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,30.5,eight1n1n1n1n1n1n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)
                                                                    *(dMult-4.)*(dMult-5.)*(dMult-6.)*(dMult-7.));
   // Average 8-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
@@ -4484,8 +4509,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
        mWeight8p = dMult;           
       }        
   fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(4,mWeight8p); // eW_<8>
-  fIntFlowCorrelationsPro->Fill(3.5,eight1n1n1n1n1n1n1n1n,mWeight8p);
-  fIntFlowSquaredCorrelationsPro->Fill(3.5,eight1n1n1n1n1n1n1n1n*eight1n1n1n1n1n1n1n1n,mWeight8p);  
+  this->FillIntFlowProfile(kFastCorrelationsPro,3.5,eight1n1n1n1n1n1n1n1n,mWeight8p);
+  this->FillIntFlowProfile(kFastSquaredCorrelationsPro,3.5,eight1n1n1n1n1n1n1n1n*eight1n1n1n1n1n1n1n1n,mWeight8p);  
   if(fCalculateCumulantsVsM)
   {
    if(fFillProfilesVsMUsingWeights)  
@@ -4515,7 +4540,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
                + 2.*(2.*(pow(dReQ3n,2.)+pow(dImQ3n,2.))+(pow(dReQ2n,2.)+pow(dImQ2n,2.))
                + (pow(dReQ1n,2.)+pow(dImQ1n,2.))-3.*dMult))
                / (dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));               
-  fIntFlowCorrelationsAllPro->Fill(32.5,four4n2n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,32.5,four4n2n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
   // Average 4-particle correlations vs M for all events:                
   if(fCalculateAllCorrelationsVsM)
   {
@@ -4537,7 +4562,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
                  + 9.*(pow(dReQ2n,2.)+pow(dImQ2n,2.))
                  + 6.*(pow(dReQ1n,2.)+pow(dImQ1n,2.))-12.*dMult))
                  / (dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(33.5,five3n3n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,33.5,five3n3n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[33]->Fill(dMultiplicityBin,five3n3n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
@@ -4553,8 +4578,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
   two5n5n = (pow(dReQ5n,2.)+pow(dImQ5n,2.)-dMult)/(dMult*(dMult-1.)); 
   two6n6n = (pow(dReQ6n,2.)+pow(dImQ6n,2.)-dMult)/(dMult*(dMult-1.));        
   // Average 2-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(34.5,two5n5n,dMult*(dMult-1.));
-  fIntFlowCorrelationsAllPro->Fill(35.5,two6n6n,dMult*(dMult-1.)); 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,34.5,two5n5n,dMult*(dMult-1.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,35.5,two6n6n,dMult*(dMult-1.)); 
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[34]->Fill(dMultiplicityBin,two5n5n,dMult*(dMult-1.));
@@ -4590,11 +4615,11 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
               - (pow(dReQ1n,2.)+pow(dImQ1n,2.))+2.*dMult)
               / (dMult*(dMult-1.)*(dMult-2.));            
   // Average 3-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(36.5,three5n3n2n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(5*phi1-3*phi2-2*phi3)>> 
-  fIntFlowCorrelationsAllPro->Fill(37.5,three5n4n1n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(5*phi1-4*phi2-1*phi3)>> 
-  fIntFlowCorrelationsAllPro->Fill(38.5,three6n3n3n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-3*phi2-3*phi3)>> 
-  fIntFlowCorrelationsAllPro->Fill(39.5,three6n4n2n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-4*phi2-2*phi3)>>
-  fIntFlowCorrelationsAllPro->Fill(40.5,three6n5n1n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-5*phi2-1*phi3)>>
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,36.5,three5n3n2n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(5*phi1-3*phi2-2*phi3)>> 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,37.5,three5n4n1n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(5*phi1-4*phi2-1*phi3)>> 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,38.5,three6n3n3n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-3*phi2-3*phi3)>> 
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,39.5,three6n4n2n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-4*phi2-2*phi3)>>
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,40.5,three6n5n1n,dMult*(dMult-1.)*(dMult-2.)); // <<cos(n(6*phi1-5*phi2-1*phi3)>>
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[36]->Fill(dMultiplicityBin,three5n3n2n,dMult*(dMult-1.)*(dMult-2.));
@@ -4686,19 +4711,19 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
                + 6.*(pow(dReQ2n,2.)+pow(dImQ2n,2.))-6.*dMult)
                / (dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
   // Average 4-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(41.5,four6n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(42.5,four3n2n3n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(43.5,four4n1n3n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(44.5,four3n3n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  //fIntFlowCorrelationsAllPro->Fill(45.5,four4n2n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)); // I already have this one above
-  fIntFlowCorrelationsAllPro->Fill(46.5,four5n1n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(47.5,four4n2n4n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(48.5,four5n1n4n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(49.5,four5n3n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(50.5,four5n2n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(51.5,four5n1n5n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(58.5,four6n4n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
-  fIntFlowCorrelationsAllPro->Fill(59.5,four6n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,41.5,four6n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,42.5,four3n2n3n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,43.5,four4n1n3n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,44.5,four3n3n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  //this->FillIntFlowProfile(kFastCorrelationsAllPro,45.5,four4n2n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)); // I already have this one above
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,46.5,four5n1n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,47.5,four4n2n4n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,48.5,four5n1n4n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,49.5,four5n3n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,50.5,four5n2n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,51.5,four5n1n5n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,58.5,four6n4n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,59.5,four6n2n2n2n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[41]->Fill(dMultiplicityBin,four6n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.));
@@ -4808,13 +4833,13 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
                  + 4.*reQ5nQ3nstarQ2nstar + 24.*dMult)
                  / (dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
   // Average 5-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(52.5,five3n3n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(53.5,five4n2n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(54.5,five3n2n3n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(55.5,five3n2n2n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(56.5,five5n1n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(60.5,five6n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
-  fIntFlowCorrelationsAllPro->Fill(61.5,five4n1n1n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,52.5,five3n3n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,53.5,five4n2n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,54.5,five3n2n3n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,55.5,five3n2n2n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,56.5,five5n1n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,60.5,five6n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,61.5,five4n1n1n3n3n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[52]->Fill(dMultiplicityBin,five3n3n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.));
@@ -4890,8 +4915,8 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelations()
                   / (dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
 
   // Average 6-particle correlations for all events:      
-  fIntFlowCorrelationsAllPro->Fill(57.5,six3n2n1n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
-  fIntFlowCorrelationsAllPro->Fill(62.5,six3n3n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,57.5,six3n2n1n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
+  this->FillIntFlowProfile(kFastCorrelationsAllPro,62.5,six3n3n2n2n1n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
   if(fCalculateAllCorrelationsVsM)
   {
    fIntFlowCorrelationsAllVsMPro[57]->Fill(dMultiplicityBin,six3n2n1n3n2n1n,dMult*(dMult-1.)*(dMult-2.)*(dMult-3.)*(dMult-4.)*(dMult-5.));
@@ -13223,11 +13248,11 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowProductOfCorrelations()
  {
   for(Int_t ci2=ci1+1;ci2<=4;ci2++)
   {
-   fIntFlowProductOfCorrelationsPro->Fill(0.5+counter,
-                                          fIntFlowCorrelationsEBE->GetBinContent(ci1)*
-                                          fIntFlowCorrelationsEBE->GetBinContent(ci2),
-                                          fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci1)*
-                                          fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci2));
+   this->FillIntFlowProfile(kFastProductOfCorrelationsPro,0.5+counter,
+                            fIntFlowCorrelationsEBE->GetBinContent(ci1)*
+                            fIntFlowCorrelationsEBE->GetBinContent(ci2),
+                            fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci1)*
+                            fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci2));
    // products versus multiplicity:  // [0=<<2><4>>,1=<<2><6>>,2=<<2><8>>,3=<<4><6>>,4=<<4><8>>,5=<<6><8>>]
    if(fCalculateCumulantsVsM)
    {
@@ -15146,31 +15171,31 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelationsUsingParticleWei
    fIntFlowCorrelationsEBE->SetBinContent(1,two1n1nW1W1);
    fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(1,dM11);
    // average correlation <w1 w2 cos(n*(phi1-phi2))> for all events:
-   fIntFlowCorrelationsPro->Fill(0.5,two1n1nW1W1,dM11);  
+   this->FillIntFlowProfile(kFastCorrelationsPro,0.5,two1n1nW1W1,dM11);  
    // average squared correlation <w1 w2 cos(n*(phi1-phi2))> for all events:
-   fIntFlowSquaredCorrelationsPro->Fill(0.5,two1n1nW1W1*two1n1nW1W1,dM11); 
-   fIntFlowCorrelationsAllPro->Fill(0.5,two1n1nW1W1,dM11);   
+   this->FillIntFlowProfile(kFastSquaredCorrelationsPro,0.5,two1n1nW1W1*two1n1nW1W1,dM11); 
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,0.5,two1n1nW1W1,dM11);   
   }
   if(dM22)
   {
    two2n2nW2W2 = (pow(dReQ2n2k,2)+pow(dImQ2n2k,2)-(*fSpk)(0,4))/dM22; 
    // ...
    // average correlation <w1^2 w2^2 cos(2n*(phi1-phi2))> for all events:
-   fIntFlowCorrelationsAllPro->Fill(1.5,two2n2nW2W2,dM22);   
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,1.5,two2n2nW2W2,dM22);   
   }
   if(dM33)
   {
    two3n3nW3W3 = (pow(dReQ3n3k,2)+pow(dImQ3n3k,2)-(*fSpk)(0,6))/dM33;
    // ...
    // average correlation <w1^3 w2^3 cos(3n*(phi1-phi2))> for all events:
-   fIntFlowCorrelationsAllPro->Fill(2.5,two3n3nW3W3,dM33);   
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,2.5,two3n3nW3W3,dM33);   
   }
   if(dM44)
   {
    two4n4nW4W4 = (pow(dReQ4n4k,2)+pow(dImQ4n4k,2)-(*fSpk)(0,8))/dM44; 
    // ...
    // average correlation <w1^4 w2^4 cos(4n*(phi1-phi2))> for all events:
-   fIntFlowCorrelationsAllPro->Fill(3.5,two4n4nW4W4,dM44);      
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,3.5,two4n4nW4W4,dM44);      
   }
  } // end of if(dMult>1) 
 
@@ -15206,7 +15231,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelationsUsingParticleWei
                      - 2.*(dReQ1n3k*dReQ1n1k+dImQ1n3k*dImQ1n1k)
                      - pow(dReQ2n2k,2)-pow(dImQ2n2k,2)
                      + 2.*(*fSpk)(0,4))/dM211;                                                                               
-   fIntFlowCorrelationsAllPro->Fill(5.5,three2n1n1nW2W1W1,dM211);
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,5.5,three2n1n1nW2W1W1,dM211);
   } 
  } // end of if(dMult>2) 
  //..............................................................................................
@@ -15229,10 +15254,10 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowCorrelationsUsingParticleWei
    fIntFlowCorrelationsEBE->SetBinContent(2,four1n1n1n1nW1W1W1W1);
    fIntFlowEventWeightsForCorrelationsEBE->SetBinContent(2,dM1111);
    // average correlation <w1 w2 w3 w4 cos(n*(phi1+phi2-phi3-phi4))> for all events:
-   fIntFlowCorrelationsPro->Fill(1.5,four1n1n1n1nW1W1W1W1,dM1111);   
+   this->FillIntFlowProfile(kFastCorrelationsPro,1.5,four1n1n1n1nW1W1W1W1,dM1111);   
    // average squared correlation <w1 w2 w3 w4 cos(n*(phi1+phi2-phi3-phi4))> for all events:
-   fIntFlowSquaredCorrelationsPro->Fill(1.5,four1n1n1n1nW1W1W1W1*four1n1n1n1nW1W1W1W1,dM1111);      
-   fIntFlowCorrelationsAllPro->Fill(10.5,four1n1n1n1nW1W1W1W1,dM1111);   
+   this->FillIntFlowProfile(kFastSquaredCorrelationsPro,1.5,four1n1n1n1nW1W1W1W1*four1n1n1n1nW1W1W1W1,dM1111);      
+   this->FillIntFlowProfile(kFastCorrelationsAllPro,10.5,four1n1n1n1nW1W1W1W1,dM1111);   
   } 
  } // end of if(dMult>3) 
  //..............................................................................................
@@ -16374,7 +16399,7 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowSumOfEventWeights()
  {
   for(Int_t ci=0;ci<4;ci++) // correlation index
   { 
-   fIntFlowSumOfEventWeights[p]->Fill(ci+0.5,pow(fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci+1),p+1)); 
+   this->FillIntFlowHistogram(kFastSumOfEventWeights1+p,ci+0.5,pow(fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci+1),p+1)); 
    if(fCalculateCumulantsVsM)
    {
     if(fFillProfilesVsMUsingWeights)
@@ -16436,9 +16461,9 @@ void AliFlowAnalysisWithQCumulants::CalculateIntFlowSumOfProductOfEventWeights()
  {
   for(Int_t ci2=ci1+1;ci2<=4;ci2++)
   {
-   fIntFlowSumOfProductOfEventWeights->Fill(0.5+counter,
-                                            fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci1)*
-                                            fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci2));
+   this->FillIntFlowHistogram(kFastSumOfProductOfEventWeights,0.5+counter,
+                              fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci1)*
+                              fIntFlowEventWeightsForCorrelationsEBE->GetBinContent(ci2));
    if(fCalculateCumulantsVsM)
    {                                                                                    
     if(fFillProfilesVsMUsingWeights)
@@ -24949,3 +24974,242 @@ void AliFlowAnalysisWithQCumulants::CheckPointersUsedInMake()
 } // end of void AliFlowAnalysisWithQCumulants::CheckPointersUsedInMake()
  
 
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::InitializeArraysForFastEngine()
+{
+ // Initialize arrays of all objects relevant for the fast engine.
+
+ for(Int_t hi=0;hi<kNFastEngineHistograms;hi++) // histogram index
+ {
+  fFastHistograms[hi] = NULL;
+  fFastOffset[hi] = 0;
+  fFastNonUnitWeight[hi] = kFALSE;
+  for(Int_t s=0;s<7;s++)
+  {
+   fFastStats[hi][s] = 0.;
+  }
+ }
+
+} // end of void AliFlowAnalysisWithQCumulants::InitializeArraysForFastEngine()
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::BookEverythingForFastEngine()
+{
+ // Book the plain arrays in which the fast engine accumulates the event-weighted sums for reference flow.
+ 
+ // Remark: The histograms are always registered, so that FillIntFlowProfile() and FillIntFlowHistogram()
+ //         can fill them directly when the fast engine is not used.
+
+ fFastHistograms[kFastCorrelationsPro] = fIntFlowCorrelationsPro;
+ fFastHistograms[kFastSquaredCorrelationsPro] = fIntFlowSquaredCorrelationsPro;
+ fFastHistograms[kFastCorrelationsAllPro] = fIntFlowCorrelationsAllPro;
+ fFastHistograms[kFastProductOfCorrelationsPro] = fIntFlowProductOfCorrelationsPro;
+ fFastHistograms[kFastSumOfEventWeights1] = fIntFlowSumOfEventWeights[0];
+ fFastHistograms[kFastSumOfEventWeights2] = fIntFlowSumOfEventWeights[1];
+ fFastHistograms[kFastSumOfProductOfEventWeights] = fIntFlowSumOfProductOfEventWeights;
+
+ if(!fUseFastEngine){return;}
+
+ Int_t nSums = 0;
+ for(Int_t hi=0;hi<kNFastEngineHistograms;hi++) // histogram index
+ {
+  if(!fFastHistograms[hi])
+  {
+   printf("\n WARNING (QC): fFastHistograms[%i] is NULL in BookEverythingForFastEngine() !!!!\n\n",hi);
+   exit(0);
+  }
+  fFastOffset[hi] = nSums;
+  nSums += 4*(fFastHistograms[hi]->GetNbinsX()+2); // 4 sums per bin, including underflow and overflow 
+ }
+ fFastSums.assign(nSums,0.);
+ 
+} // end of void AliFlowAnalysisWithQCumulants::BookEverythingForFastEngine()
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::CalculateQvectorsFast(Int_t nRPs)
+{
+ // Calculate Re[Q_{m*n,k}], Im[Q_{m*n,k}] and S_{p,k} (before taking the power p+1) in one pass over 
+ // the flat arrays with the RPs of the current event.
+
+ // Remark: cos((m+1)*n*phi), sin((m+1)*n*phi) and w^k are evaluated only once per particle. The terms and 
+ //         the order of summation are the same as in Make() without the fast engine, so that the results 
+ //         are bit-by-bit the same.
+
+ Int_t n = fHarmonic; // shortcut for the harmonic 
+ Double_t dReQ[12][9] = {{0.}}; // Re[Q_{m*n,k}]
+ Double_t dImQ[12][9] = {{0.}}; // Im[Q_{m*n,k}]
+ Double_t dSumW[9] = {0.}; // sum of w^k
+ Double_t dCos[12] = {0.}; // cos((m+1)*n*phi)
+ Double_t dSin[12] = {0.}; // sin((m+1)*n*phi)
+ Double_t dWPow[9] = {0.}; // w^k
+ for(Int_t i=0;i<nRPs;i++)
+ {
+  Double_t dPhi = fFastPhi[i];
+  Double_t dW = fFastWeight[i];
+  for(Int_t k=0;k<9;k++)
+  {
+   dWPow[k] = (1. == dW ? 1. : pow(dW,k)); // pow(1.,k) is exactly 1.
+  }
+  for(Int_t m=0;m<12;m++)
+  {
+   dCos[m] = TMath::Cos((m+1)*n*dPhi);
+   dSin[m] = TMath::Sin((m+1)*n*dPhi);
+  }
+  for(Int_t m=0;m<12;m++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    dReQ[m][k]+=dWPow[k]*dCos[m];
+    dImQ[m][k]+=dWPow[k]*dSin[m];
+   }
+  }
+  for(Int_t k=0;k<9;k++)
+  {
+   dSumW[k]+=dWPow[k];
+  }
+ } // end of for(Int_t i=0;i<nRPs;i++)
+
+ for(Int_t m=0;m<12;m++)
+ {
+  for(Int_t k=0;k<9;k++)
+  {
+   (*fReQ)(m,k)+=dReQ[m][k];
+   (*fImQ)(m,k)+=dImQ[m][k];
+  }
+ }
+ for(Int_t p=0;p<8;p++)
+ {
+  for(Int_t k=0;k<9;k++)
+  {
+   (*fSpk)(p,k)+=dSumW[k];
+  }
+ }
+
+} // end of void AliFlowAnalysisWithQCumulants::CalculateQvectorsFast(Int_t nRPs)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FillIntFlowProfile(Int_t hi, Double_t x, Double_t y, Double_t w)
+{
+ // Fill the reference flow profile hi (see EFastEngineHistograms). With the fast engine the sums are only 
+ // accumulated in plain arrays, in the same way and in the same order as in TProfile::Fill(x,y,w).
+
+ if(!fUseFastEngine)
+ {
+  static_cast<TProfile*>(fFastHistograms[hi])->Fill(x,y,w);
+  return;
+ }
+
+ TH1D *hist = fFastHistograms[hi];
+ Int_t bin = hist->GetXaxis()->FindFixBin(x);
+ Double_t *sums = &fFastSums[fFastOffset[hi]+4*bin];
+ Double_t *stats = fFastStats[hi];
+ stats[6]++;
+ sums[0] += w*y;
+ sums[1] += w*y*y;
+ if(w != 1.){fFastNonUnitWeight[hi] = kTRUE;}
+ sums[3] += w*w;
+ sums[2] += w;
+ if(bin == 0 || bin > hist->GetNbinsX()){return;}
+ stats[0] += w;
+ stats[1] += w*w;
+ stats[2] += w*x;
+ stats[3] += w*x*x;
+ stats[4] += w*y;
+ stats[5] += w*y*y;
+
+} // end of void AliFlowAnalysisWithQCumulants::FillIntFlowProfile(Int_t hi, Double_t x, Double_t y, Double_t w)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FillIntFlowHistogram(Int_t hi, Double_t x, Double_t w)
+{
+ // Fill the reference flow histogram hi (see EFastEngineHistograms). With the fast engine the sums are only 
+ // accumulated in plain arrays, in the same way and in the same order as in TH1::Fill(x,w).
+
+ if(!fUseFastEngine)
+ {
+  fFastHistograms[hi]->Fill(x,w);
+  return;
+ }
+
+ TH1D *hist = fFastHistograms[hi];
+ Int_t bin = hist->GetXaxis()->FindFixBin(x);
+ Double_t *sums = &fFastSums[fFastOffset[hi]+4*bin];
+ Double_t *stats = fFastStats[hi];
+ stats[6]++;
+ if(w != 1.){fFastNonUnitWeight[hi] = kTRUE;}
+ sums[3] += w*w;
+ sums[0] += w;
+ if(bin == 0 || bin > hist->GetNbinsX()){return;}
+ stats[0] += w;
+ stats[1] += w*w;
+ stats[2] += w*x;
+ stats[3] += w*x*x;
+
+} // end of void AliFlowAnalysisWithQCumulants::FillIntFlowHistogram(Int_t hi, Double_t x, Double_t w)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FinalizeFastEngine()
+{
+ // Materialize the sums accumulated by the fast engine in the reference flow histograms and reset them.
+
+ // Remark: This method has to be called before the histograms are written or merged (it is called at the 
+ //         beginning of Finish(), in the task it is called in FinishTaskOutput()). For histograms which were 
+ //         empty before, the content, errors, entries and statistics are bit-by-bit the same as when 
+ //         filling the histograms event-by-event.
+
+ if(fFastSums.empty()){return;}
+
+ for(Int_t hi=0;hi<kNFastEngineHistograms;hi++) // histogram index
+ {
+  TH1D *hist = fFastHistograms[hi];
+  Double_t *stats = fFastStats[hi];
+  if(!hist || 0. == stats[6]){continue;}
+  TProfile *profile = dynamic_cast<TProfile*>(hist);
+  Double_t histStats[13] = {0.}; // TH1::kNstat
+  hist->GetStats(histStats); // has to be taken before the bin contents are modified
+  Double_t dEntries = hist->GetEntries();
+  // As in TH1::Fill() and TProfile::Fill(), the sum of squared weights is enabled by the first weight != 1: 
+  if(fFastNonUnitWeight[hi] && !hist->TestBit(TH1::kIsNotW))
+  {
+   if(profile && 0 == profile->GetBinSumw2()->fN){profile->Sumw2();}
+   if(!profile && 0 == hist->GetSumw2()->fN){hist->Sumw2();}
+  }
+  Double_t *content = hist->GetArray();
+  TArrayD *sumw2 = hist->GetSumw2();
+  for(Int_t b=0;b<=hist->GetNbinsX()+1;b++) // including underflow and overflow
+  {
+   Double_t *sums = &fFastSums[fFastOffset[hi]+4*b];
+   content[b] += sums[0];
+   if(profile)
+   {
+    if(sumw2->fN){sumw2->fArray[b] += sums[1];}
+    profile->SetBinEntries(b,profile->GetBinEntries(b)+sums[2]);
+    if(profile->GetBinSumw2()->fN){profile->GetBinSumw2()->fArray[b] += sums[3];}
+   } else if(sumw2->fN)
+     {
+      sumw2->fArray[b] += sums[3];
+     }
+   for(Int_t s=0;s<4;s++)
+   {
+    sums[s] = 0.;
+   }
+  } // end of for(Int_t b=0;b<=hist->GetNbinsX()+1;b++)
+  for(Int_t s=0;s<6;s++)
+  {
+   histStats[s] += stats[s];
+   stats[s] = 0.;
+  }
+  hist->PutStats(histStats);
+  hist->SetEntries(dEntries+stats[6]);
+  stats[6] = 0.;
+  fFastNonUnitWeight[hi] = kFALSE;
+ } // end of for(Int_t hi=0;hi<kNFastEngineHistograms;hi++)
+
+} // end of void AliFlowAnalysisWithQCumulants::FinalizeFastEngine()
+
@@ -14,6 +14,7 @@
 #ifndef ALIFLOWANALYSISWITHQCUMULANTS_H
 #define ALIFLOWANALYSISWITHQCUMULANTS_H
 
+#include <vector>
 #include "TMatrixD.h"
 #include "TH2D.h"
 #include "TRandom3.h"
@@ -50,6 +51,7 @@ class AliFlowAnalysisWithQCumulants{
   virtual void InitializeArraysForMixedHarmonics();
   virtual void InitializeArraysForControlHistograms();
   virtual void InitializeArraysForBootstrap();
+  virtual void InitializeArraysForFastEngine();
   // 1.) method Init() and methods called within Init():
   virtual void Init();
     virtual void CrossCheckSettings();
@@ -74,6 +76,7 @@ class AliFlowAnalysisWithQCumulants{
     virtual void StoreMixedHarmonicsFlags();
     virtual void StoreControlHistogramsFlags();
     virtual void StoreBootstrapFlags();
+    virtual void BookEverythingForFastEngine();
   // 2.) method Make() and methods called within Make():
   virtual void Make(AliFlowEventSimple *anEvent);
     // 2a.) Common:
@@ -82,6 +85,9 @@ class AliFlowAnalysisWithQCumulants{
     virtual void FillCommonControlHistograms(AliFlowEventSimple *anEvent);
     virtual void FillControlHistograms(AliFlowEventSimple *anEvent);
     virtual void ResetEventByEventQuantities();
+    virtual void CalculateQvectorsFast(Int_t nRPs);
+    virtual void FillIntFlowProfile(Int_t hi, Double_t x, Double_t y, Double_t w);
+    virtual void FillIntFlowHistogram(Int_t hi, Double_t x, Double_t w);
     // 2b.) Reference flow:
     virtual void CalculateIntFlowCorrelations(); 
     virtual void CalculateIntFlowCorrelationsUsingParticleWeights();
@@ -167,6 +173,8 @@ class AliFlowAnalysisWithQCumulants{
     virtual void CalculateCumulantsMixedHarmonics(); 
     // 3f.) Bootstrap:
     virtual void CalculateCumulantsForBootstrap();
+    // 3g.) Fast engine:
+    virtual void FinalizeFastEngine();
     
   // 4.)  method GetOutputHistograms() and methods called within GetOutputHistograms(): 
   virtual void GetOutputHistograms(TList *outputListHistos);
@@ -550,6 +558,14 @@ class AliFlowAnalysisWithQCumulants{
   void SetBootstrapCumulantsVsM(TH2D* const bcpVsM, Int_t const qvti) {this->fBootstrapCumulantsVsM[qvti] = bcpVsM;};
   TH2D* GetBootstrapCumulantsVsM(Int_t qvti) const {return this->fBootstrapCumulantsVsM[qvti];};
 
+  // 12.) Fast engine:
+  void SetUseFastEngine(Bool_t const ufe) {this->fUseFastEngine = ufe;};
+  Bool_t GetUseFastEngine() const {return this->fUseFastEngine;};
+
+  // Indices of the reference flow histograms filled via the fast engine:
+  enum EFastEngineHistograms {kFastCorrelationsPro,kFastSquaredCorrelationsPro,kFastCorrelationsAllPro,kFastProductOfCorrelationsPro,
+                              kFastSumOfEventWeights1,kFastSumOfEventWeights2,kFastSumOfProductOfEventWeights,kNFastEngineHistograms};
+
  private:
   
   AliFlowAnalysisWithQCumulants(const AliFlowAnalysisWithQCumulants& afawQc);
@@ -846,8 +862,20 @@ class AliFlowAnalysisWithQCumulants{
   //  11d) histograms:  
   TH2D *fBootstrapCumulants; // x-axis => QC{2}, QC{4}, QC{6}, QC{8}; y-axis => subsample # 
   TH2D *fBootstrapCumulantsVsM[4]; // index => QC{2}, QC{4}, QC{6}, QC{8}; x-axis => multiplicity; y-axis => subsample # 
+  // 12.) Fast engine:
+  //  12a) flags:
+  Bool_t fUseFastEngine; // Q-vectors from flat arrays and reference flow profiles accumulated in plain arrays until Finish()
+  //  12b) flat arrays with the RPs of the current event:
+  std::vector<Double_t> fFastPhi; //! azimuthal angles of the RPs 
+  std::vector<Double_t> fFastWeight; //! particle weights of the RPs
+  //  12c) plain arrays with the event-weighted sums:
+  TH1D *fFastHistograms[kNFastEngineHistograms]; //! histograms which are materialized from the sums in FinalizeFastEngine()
+  Int_t fFastOffset[kNFastEngineHistograms]; //! offset of the histogram in fFastSums
+  Bool_t fFastNonUnitWeight[kNFastEngineHistograms]; //! at least one fill with weight != 1 (triggers Sumw2() as in TH1::Fill())
+  Double_t fFastStats[kNFastEngineHistograms][7]; //! sum w, w^2, w*x, w*x^2, w*y, w*y^2 and number of entries
+  std::vector<Double_t> fFastSums; //! per bin (incl. under/overflow): sum w*y, w*y^2, w, w^2 (profiles) or w, -, -, w^2 (histograms)
 
-  ClassDef(AliFlowAnalysisWithQCumulants, 4);
+  ClassDef(AliFlowAnalysisWithQCumulants, 5);
 
 };
 
@@ -88,6 +88,14 @@ AliFlowEventSimple::AliFlowEventSimple():
   fZPCM(0.),
   fZPAM(0.),
   fAbsOrbit(0),
+  fTrackPhi(),
+  fTrackEta(),
+  fTrackPt(),
+  fTrackWeight(),
+  fTrackPOIBits(),
+  fTrackSubeventBits(),
+  fNumberOfTracksInArrays(-1),
+  fTrackChangeCountInArrays(0),
   fNumberOfPOItypes(2),
   fNumberOfPOIs(NULL)
 {
@@ -147,6 +155,14 @@ AliFlowEventSimple::AliFlowEventSimple( Int_t n,
   fZPCM(0.),
   fZPAM(0.),
   fAbsOrbit(0),
+  fTrackPhi(),
+  fTrackEta(),
+  fTrackPt(),
+  fTrackWeight(),
+  fTrackPOIBits(),
+  fTrackSubeventBits(),
+  fNumberOfTracksInArrays(-1),
+  fTrackChangeCountInArrays(0),
   fNumberOfPOItypes(2),
   fNumberOfPOIs(new Int_t[fNumberOfPOItypes])
 {
@@ -210,6 +226,14 @@ AliFlowEventSimple::AliFlowEventSimple(const AliFlowEventSimple& anEvent):
   fZPCM(anEvent.fZPCM),
   fZPAM(anEvent.fZPAM),
   fAbsOrbit(anEvent.fAbsOrbit),
+  fTrackPhi(),
+  fTrackEta(),
+  fTrackPt(),
+  fTrackWeight(),
+  fTrackPOIBits(),
+  fTrackSubeventBits(),
+  fNumberOfTracksInArrays(-1),
+  fTrackChangeCountInArrays(0),
   fNumberOfPOItypes(anEvent.fNumberOfPOItypes),
   fNumberOfPOIs(new Int_t[fNumberOfPOItypes])
 {
@@ -307,6 +331,7 @@ AliFlowEventSimple& AliFlowEventSimple::operator=(const AliFlowEventSimple& anEv
     fV0A[i] = anEvent.fV0A[i];
   }
   delete [] fShuffledIndexes;
+  InvalidateTrackArrays();
   return *this;
 }
 
@@ -434,6 +459,7 @@ AliFlowTrackSimple* AliFlowEventSimple::GetTrack(Int_t i)
 void AliFlowEventSimple::ShuffleTracks()
 {
   //shuffle track indexes
+  InvalidateTrackArrays();
   if (!fShuffledIndexes)
   {
     //initialize the table with shuffled indexes
@@ -469,6 +495,7 @@ void AliFlowEventSimple::AddTrack( AliFlowTrackSimple* track )
 void AliFlowEventSimple::TrackAdded()
 {
   //book keeping after a new track has been added
+  InvalidateTrackArrays();
   fNumberOfTracks++;
   if (fShuffledIndexes)
   {
@@ -488,6 +515,43 @@ AliFlowTrackSimple* AliFlowEventSimple::MakeNewTrack()
    return t;
 }
 
+//-----------------------------------------------------------------------
+void AliFlowEventSimple::UpdateTrackArrays()
+{
+  //fill the flat arrays with the tracks in the order of GetTrack(i), the memory
+  //of the arrays is reused across events; nothing is done if they are up to date,
+  //i.e. if the number of tracks is the same and no track was changed since the last fill
+  if (fNumberOfTracksInArrays == fNumberOfTracks &&
+      fTrackChangeCountInArrays == AliFlowTrackSimple::GetChangeCount()) return;
+  if (fShuffleTracks && !fShuffledIndexes) ShuffleTracks();
+  fTrackPhi.resize(fNumberOfTracks);
+  fTrackEta.resize(fNumberOfTracks);
+  fTrackPt.resize(fNumberOfTracks);
+  fTrackWeight.resize(fNumberOfTracks);
+  fTrackPOIBits.resize(fNumberOfTracks);
+  fTrackSubeventBits.resize(fNumberOfTracks);
+  for (Int_t i=0; i<fNumberOfTracks; i++)
+  {
+    Int_t trackIndex = (fShuffleTracks) ? fShuffledIndexes[i] : i;
+    AliFlowTrackSimple* pTrack = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(trackIndex));
+    if (!pTrack)
+    {
+      //no particle: keep the slot, but without any tags it is never selected
+      fTrackPhi[i] = 0.; fTrackEta[i] = 0.; fTrackPt[i] = 0.; fTrackWeight[i] = 0.;
+      fTrackPOIBits[i] = 0; fTrackSubeventBits[i] = 0;
+      continue;
+    }
+    fTrackPhi[i] = pTrack->Phi();
+    fTrackEta[i] = pTrack->Eta();
+    fTrackPt[i] = pTrack->Pt();
+    fTrackWeight[i] = pTrack->Weight();
+    fTrackPOIBits[i] = AliFlowTrackSimple::GetBitsAsMask(pTrack->GetPOItype());
+    fTrackSubeventBits[i] = AliFlowTrackSimple::GetBitsAsMask(pTrack->GetSubeventBits());
+  }
+  fNumberOfTracksInArrays = fNumberOfTracks;
+  fTrackChangeCountInArrays = AliFlowTrackSimple::GetChangeCount();
+}
+
 //-----------------------------------------------------------------------
 AliFlowVector AliFlowEventSimple::GetQ( Int_t n,
                                         TList *weightsList,
@@ -508,8 +572,6 @@ AliFlowVector AliFlowEventSimple::GetQ( Int_t n,
   Double_t dEta = 0.;
   Double_t dWeight = 1.;
 
-  AliFlowTrackSimple* pTrack = NULL;
-
   Int_t nBinsPhi = 0;
   Double_t dBinWidthPt = 0.;
   Double_t dPtMin = 0.;
@@ -551,48 +613,41 @@ AliFlowVector AliFlowEventSimple::GetQ( Int_t n,
     }
   } // end of if(weightsList)
 
-  // loop over tracks
+  // loop over tracks (via the flat arrays)
+  UpdateTrackArrays();
   for(Int_t i=0; i<fNumberOfTracks; i++)
   {
-    pTrack = (AliFlowTrackSimple*)fTrackCollection->At(i);
-    if(pTrack)
+    if(fTrackPOIBits[i] & (1u<<AliFlowTrackSimple::kRP))
     {
-      if(pTrack->InRPSelection())
-      {
-        dPhi = pTrack->Phi();
-        dPt  = pTrack->Pt();
-        dEta = pTrack->Eta();
-	      dWeight = pTrack->Weight();
+      dPhi = fTrackPhi[i];
+      dPt  = fTrackPt[i];
+      dEta = fTrackEta[i];
+	      dWeight = fTrackWeight[i];
 
-        // determine Phi weight: (to be improved, I should here only access it + the treatment of gaps in the if statement)
-        if(phiWeights && nBinsPhi)
-        {
-          wPhi = phiWeights->GetBinContent(1+(Int_t)(TMath::Floor(dPhi*nBinsPhi/TMath::TwoPi())));
-        }
-        // determine v'(pt) weight:
-        if(ptWeights && dBinWidthPt)
-        {
-          wPt=ptWeights->GetBinContent(1+(Int_t)(TMath::Floor((dPt-dPtMin)/dBinWidthPt)));
-        }
-        // determine v'(eta) weight:
-        if(etaWeights && dBinWidthEta)
-        {
-          wEta=etaWeights->GetBinContent(1+(Int_t)(TMath::Floor((dEta-dEtaMin)/dBinWidthEta)));
-        }
+      // determine Phi weight: (to be improved, I should here only access it + the treatment of gaps in the if statement)
+      if(phiWeights && nBinsPhi)
+      {
+        wPhi = phiWeights->GetBinContent(1+(Int_t)(TMath::Floor(dPhi*nBinsPhi/TMath::TwoPi())));
+      }
+      // determine v'(pt) weight:
+      if(ptWeights && dBinWidthPt)
+      {
+        wPt=ptWeights->GetBinContent(1+(Int_t)(TMath::Floor((dPt-dPtMin)/dBinWidthPt)));
+      }
+      // determine v'(eta) weight:
+      if(etaWeights && dBinWidthEta)
+      {
+        wEta=etaWeights->GetBinContent(1+(Int_t)(TMath::Floor((dEta-dEtaMin)/dBinWidthEta)));
+      }
 
-        // building up the weighted Q-vector:
-        dQX += dWeight*wPhi*wPt*wEta*TMath::Cos(iOrder*dPhi);
-        dQY += dWeight*wPhi*wPt*wEta*TMath::Sin(iOrder*dPhi);
+      // building up the weighted Q-vector:
+      dQX += dWeight*wPhi*wPt*wEta*TMath::Cos(iOrder*dPhi);
+      dQY += dWeight*wPhi*wPt*wEta*TMath::Sin(iOrder*dPhi);
 
-        // weighted multiplicity:
-        sumOfWeights += dWeight*wPhi*wPt*wEta;
+      // weighted multiplicity:
+      sumOfWeights += dWeight*wPhi*wPt*wEta;
 
-      } // end of if (pTrack->InRPSelection())
-    } // end of if (pTrack)
-    else
-    {
-      cerr << "no particle!!!"<<endl;
-    }
+    } // end of if (RP)
   } // loop over particles
 
   vQ.Set(dQX,dQY);
@@ -896,6 +951,14 @@ AliFlowEventSimple::AliFlowEventSimple( TTree* inputTree,
   fZPCM(0.),
   fZPAM(0.),
   fAbsOrbit(0),
+  fTrackPhi(),
+  fTrackEta(),
+  fTrackPt(),
+  fTrackWeight(),
+  fTrackPOIBits(),
+  fTrackSubeventBits(),
+  fNumberOfTracksInArrays(-1),
+  fTrackChangeCountInArrays(0),
   fNumberOfPOItypes(2),
   fNumberOfPOIs(new Int_t[fNumberOfPOItypes])
 {
@@ -958,6 +1021,7 @@ AliFlowEventSimple::AliFlowEventSimple( TTree* inputTree,
 void AliFlowEventSimple::CloneTracks(Int_t n)
 {
   //clone every track n times to add non-flow
+  InvalidateTrackArrays();
   if (n<=0) return; //no use to clone stuff zero or less times
   Int_t ntracks = fNumberOfTracks;
   fTrackCollection->Expand((n+1)*fNumberOfTracks);
@@ -977,6 +1041,7 @@ void AliFlowEventSimple::CloneTracks(Int_t n)
 void AliFlowEventSimple::ResolutionPt(Double_t res)
 {
   //smear pt of all tracks by gaussian with sigma=res
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -992,6 +1057,7 @@ void AliFlowEventSimple::TagSubeventsInEta( Double_t etaMinA,
                                             Double_t etaMaxB )
 {
   //Flag two subevents in given eta ranges
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1007,6 +1073,7 @@ void AliFlowEventSimple::TagSubeventsInEta( Double_t etaMinA,
 void AliFlowEventSimple::TagSubeventsByCharge()
 {
   //Flag two subevents in given eta ranges
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1022,6 +1089,7 @@ void AliFlowEventSimple::TagSubeventsByCharge()
 void AliFlowEventSimple::AddV1( Double_t v1 )
 {
   //add v2 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1039,6 +1107,7 @@ void AliFlowEventSimple::AddV1( Double_t v1 )
 void AliFlowEventSimple::AddV2( Double_t v2 )
 {
   //add v2 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1056,6 +1125,7 @@ void AliFlowEventSimple::AddV2( Double_t v2 )
 void AliFlowEventSimple::AddV3( Double_t v3 )
 {
   //add v3 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1073,6 +1143,7 @@ void AliFlowEventSimple::AddV3( Double_t v3 )
 void AliFlowEventSimple::AddV4( Double_t v4 )
 {
   //add v4 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1090,6 +1161,7 @@ void AliFlowEventSimple::AddV4( Double_t v4 )
 void AliFlowEventSimple::AddV5( Double_t v5 )
 {
   //add v4 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1108,6 +1180,7 @@ void AliFlowEventSimple::AddFlow( Double_t v1, Double_t v2, Double_t v3, Double_
                                   Double_t rp1, Double_t rp2, Double_t rp3, Double_t rp4, Double_t rp5 )
 {
   //add flow to all tracks wrt the reaction plane angle, for all harmonic separate angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1120,6 +1193,7 @@ void AliFlowEventSimple::AddFlow( Double_t v1, Double_t v2, Double_t v3, Double_
 void AliFlowEventSimple::AddFlow( Double_t v1, Double_t v2, Double_t v3, Double_t v4, Double_t v5 )
 {
   //add flow to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1132,6 +1206,7 @@ void AliFlowEventSimple::AddFlow( Double_t v1, Double_t v2, Double_t v3, Double_
 void AliFlowEventSimple::AddV2( TF1* ptDepV2 )
 {
   //add v2 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1146,6 +1221,7 @@ void AliFlowEventSimple::AddV2( TF1* ptDepV2 )
 void AliFlowEventSimple::AddV2( TF2* ptEtaDepV2 )
 {
   //add v2 to all tracks wrt the reaction plane angle
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1160,6 +1236,7 @@ void AliFlowEventSimple::AddV2( TF2* ptEtaDepV2 )
 void AliFlowEventSimple::TagRP( const AliFlowTrackSimpleCuts* cuts )
 {
   //tag tracks as reference particles (RPs)
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1182,6 +1259,7 @@ void AliFlowEventSimple::TagRP( const AliFlowTrackSimpleCuts* cuts )
 void AliFlowEventSimple::TagPOI( const AliFlowTrackSimpleCuts* cuts, Int_t poiType )
 {
   //tag tracks as particles of interest (POIs)
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1215,6 +1293,7 @@ void AliFlowEventSimple::DefineDeadZone( Double_t etaMin,
 {
   //mark tracks in given eta-phi region as dead
   //by resetting the flow bits
+  InvalidateTrackArrays();
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
     AliFlowTrackSimple* track = static_cast<AliFlowTrackSimple*>(fTrackCollection->At(i));
@@ -1237,6 +1316,7 @@ Int_t AliFlowEventSimple::CleanUpDeadTracks()
 {
   //remove tracks that have no flow tags set and cleanup the container
   //returns number of cleaned tracks
+  InvalidateTrackArrays();
   Int_t ncleaned=0;
   for (Int_t i=0; i<fNumberOfTracks; i++)
   {
@@ -1275,6 +1355,7 @@ TF1* AliFlowEventSimple::SimplePtSpectrum()
 void AliFlowEventSimple::ClearFast()
 {
   //clear the counters without deleting allocated objects so they can be reused
+  InvalidateTrackArrays();
   fReferenceMultiplicity = 0;
   fNumberOfTracks = 0;
   for (Int_t i=0; i<fNumberOfPOItypes; i++)
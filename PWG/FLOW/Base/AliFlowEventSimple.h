@@ -16,6 +16,7 @@
 #ifndef ALIFLOWEVENTSIMPLE_H
 #define ALIFLOWEVENTSIMPLE_H
 
+#include <vector>
 #include "TObject.h"
 #include "TParameter.h"
 #include "TMath.h"
@@ -117,6 +118,19 @@ class AliFlowEventSimple: public TObject {
   void TrackAdded();
   AliFlowTrackSimple* MakeNewTrack();
 
+  // flat (structure-of-arrays) view of the tracks, index i is the track GetTrack(i);
+  // the arrays are rebuilt on first access after a track was added, removed or changed (the
+  // setters of AliFlowTrackSimple count the changes, see AliFlowTrackSimple::GetChangeCount());
+  // InvalidateTrackArrays() is only needed after reordering the track collection directly
+  void            UpdateTrackArrays();
+  void            InvalidateTrackArrays()           { fNumberOfTracksInArrays = -1; }
+  const Double_t* GetTrackPhiArray()                { UpdateTrackArrays(); return fTrackPhi.data(); }
+  const Double_t* GetTrackEtaArray()                { UpdateTrackArrays(); return fTrackEta.data(); }
+  const Double_t* GetTrackPtArray()                 { UpdateTrackArrays(); return fTrackPt.data(); }
+  const Double_t* GetTrackWeightArray()             { UpdateTrackArrays(); return fTrackWeight.data(); }
+  const UInt_t*   GetTrackPOIBitsArray()            { UpdateTrackArrays(); return fTrackPOIBits.data(); }
+  const UInt_t*   GetTrackSubeventBitsArray()       { UpdateTrackArrays(); return fTrackSubeventBits.data(); }
+
   virtual AliFlowVector GetQ(Int_t n=2, TList *weightsList=NULL, Bool_t usePhiWeights=kFALSE, Bool_t usePtWeights=kFALSE, Bool_t useEtaWeights=kFALSE);
   virtual void Get2Qsub(AliFlowVector* Qarray, Int_t n=2, TList *weightsList=NULL, Bool_t usePhiWeights=kFALSE, Bool_t usePtWeights=kFALSE, Bool_t useEtaWeights=kFALSE);
   virtual void GetZDC2Qsub(AliFlowVector* Qarray);
@@ -204,6 +218,14 @@ class AliFlowEventSimple: public TObject {
   Double_t                fZPAM;                      // total energy from ZPC-A
   Double_t                fVtxPos[3];                 // Primary vertex position (x,y,z)
   UInt_t                  fAbsOrbit;                  // Absolute orbit number
+  std::vector<Double_t>   fTrackPhi;                  //! flat array with phi of the tracks
+  std::vector<Double_t>   fTrackEta;                  //! flat array with eta of the tracks
+  std::vector<Double_t>   fTrackPt;                   //! flat array with pt of the tracks
+  std::vector<Double_t>   fTrackWeight;               //! flat array with weight of the tracks
+  std::vector<UInt_t>     fTrackPOIBits;              //! flat array with POI type bits of the tracks (bit 0 = RP)
+  std::vector<UInt_t>     fTrackSubeventBits;         //! flat array with subevent bits of the tracks
+  Int_t                   fNumberOfTracksInArrays;    //! number of tracks in the flat arrays, -1 if they have to be rebuilt
+  ULong64_t               fTrackChangeCountInArrays;  //! AliFlowTrackSimple::GetChangeCount() when the flat arrays were filled
 
  private:
   Int_t                   fNumberOfPOItypes;    // how many different flow particle types do we have? (RP,POI,POI_2,...)
@@ -53,11 +53,11 @@ public:
   Bool_t InSubevent(Int_t i) const;
   void TagRP(Bool_t b=kTRUE) {SetForRPSelection(b);} 
   void TagPOI(Bool_t b=kTRUE) {SetForPOISelection(b);} 
-  void Tag(Int_t n, Bool_t b=kTRUE) {fPOItype.SetBitNumber(n,b);}
+  void Tag(Int_t n, Bool_t b=kTRUE) {fPOItype.SetBitNumber(n,b); TrackChanged();}
   Bool_t CheckTag(Int_t n) {return fPOItype.TestBitNumber(n);}
   void SetForSubevent(Int_t i); 
-  void ResetPOItype() {fPOItype.ResetAllBits();}
-  void ResetSubEventTags() {fSubEventBits.ResetAllBits();}
+  void ResetPOItype() {fPOItype.ResetAllBits(); TrackChanged();}
+  void ResetSubEventTags() {fSubEventBits.ResetAllBits(); TrackChanged();}
   Bool_t IsDead() const {return (fPOItype.CountBits()==0);}
       
   void SetEta(Double_t eta);
@@ -123,6 +123,8 @@ public:
 
   const TBits* GetPOItype() const {return &fPOItype;}
   const TBits* GetFlowBits() const {return GetPOItype();}
+  const TBits* GetSubeventBits() const {return &fSubEventBits;}
+  static UInt_t GetBitsAsMask(const TBits* bits);
 
   void  SetID(Int_t i) {fID=i;}
   Int_t GetID() const {return fID;}
@@ -133,6 +135,10 @@ public:
   virtual void SetDaughter(Int_t /*value*/, AliFlowTrackSimple* /*track*/) {}
   virtual AliFlowTrackSimple *GetDaughter(Int_t /*value*/) const {return NULL;}
 
+  // increased at every change of the kinematics, weight or tags of any track, so that
+  // AliFlowEventSimple can tell when its flat track arrays have to be rebuilt
+  static ULong64_t GetChangeCount() {return fgChangeCount;}
+
  private:
   AliFlowTrackSimple(Double_t phi, Double_t eta, Double_t pt, Double_t weight, Int_t charge, Double_t mass=-1);
   Double_t fEta;         // eta
@@ -146,6 +152,9 @@ public:
   Int_t    fID;          // Unique track ID, point back to the ESD track
   Int_t    fITStype;     // ITS hits identifier (test purpose only)
 
+  static void TrackChanged() {fgChangeCount++;}
+  static ULong64_t fgChangeCount; // number of changes of the tracks, see GetChangeCount()
+
   ClassDef(AliFlowTrackSimple,2)                 // macro for rootcint
 
 };
@@ -174,16 +183,22 @@ inline Bool_t AliFlowTrackSimple::IsPOItype(Int_t poiType) const {
   return fPOItype.TestBitNumber(poiType); }
 inline Bool_t AliFlowTrackSimple::InSubevent(Int_t i) const { 
   return this->fSubEventBits.TestBitNumber(i); }
+inline UInt_t AliFlowTrackSimple::GetBitsAsMask(const TBits* bits) {
+  //the first 32 bits as a mask, bit n set if TestBitNumber(n)
+  UInt_t mask = 0;
+  UInt_t nBits = bits->GetNbits() < 32 ? bits->GetNbits() : 32;
+  for (UInt_t n=0; n<nBits; n++) { if (bits->TestBitNumber(n)) mask |= (1u<<n); }
+  return mask; }
 
 //Setters
 inline void AliFlowTrackSimple::SetEta(Double_t val) {
-  fEta = val; }
+  fEta = val; TrackChanged(); }
 inline void AliFlowTrackSimple::SetPt(Double_t val) {
-  fPt = val; }
+  fPt = val; TrackChanged(); }
 inline void AliFlowTrackSimple::SetPhi(Double_t val) {
-  fPhi = val; }
+  fPhi = val; TrackChanged(); }
 inline void AliFlowTrackSimple::SetWeight(Double_t val) {
-  fTrackWeight = val; }
+  fTrackWeight = val; TrackChanged(); }
 inline void AliFlowTrackSimple::SetCharge(Int_t val) {
   fCharge = val; }
 inline void AliFlowTrackSimple::SetMass(Double_t val) {
@@ -193,14 +208,14 @@ inline void AliFlowTrackSimple::SetITStype(Int_t val) {
 
   //TBits
 inline void AliFlowTrackSimple::SetForRPSelection(Bool_t val) {
-  fPOItype.SetBitNumber(kRP,val); }
+  fPOItype.SetBitNumber(kRP,val); TrackChanged(); }
 inline void AliFlowTrackSimple::SetForPOISelection(Bool_t val) {
-  fPOItype.SetBitNumber(kPOI,val); }
+  fPOItype.SetBitNumber(kPOI,val); TrackChanged(); }
 inline void AliFlowTrackSimple::SetForSubevent(Int_t i) {
-  fSubEventBits.SetBitNumber(i,kTRUE); }
+  fSubEventBits.SetBitNumber(i,kTRUE); TrackChanged(); }
 
 inline void AliFlowTrackSimple::SetPOItype(Int_t poiType, Bool_t b) {
-  fPOItype.SetBitNumber(poiType,b); }
+  fPOItype.SetBitNumber(poiType,b); TrackChanged(); }
 
 #endif
 
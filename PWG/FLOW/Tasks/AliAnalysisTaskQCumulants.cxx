@@ -84,7 +84,8 @@ AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants(const char *name, Bool_t us
  fnBinsForCorrelations(10000),
  fUseBootstrap(kFALSE),
  fUseBootstrapVsM(kFALSE),
- fnSubsamples(10)
+ fnSubsamples(10),
+ fUseFastEngine(kFALSE)
 {
  // constructor
  AliDebug(2,"AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants(const char *name, Bool_t useParticleWeights)");
@@ -182,7 +183,8 @@ AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants():
  fnBinsForCorrelations(0), 
  fUseBootstrap(kFALSE),
  fUseBootstrapVsM(kFALSE),
- fnSubsamples(10)
+ fnSubsamples(10),
+ fUseFastEngine(kFALSE)
 
 {
  // Dummy constructor
@@ -317,6 +319,9 @@ void AliAnalysisTaskQCumulants::UserCreateOutputObjects()
  fQC->SetUseBootstrapVsM(fUseBootstrapVsM);
  fQC->SetnSubsamples(fnSubsamples);
 
+ // Fast engine:
+ fQC->SetUseFastEngine(fUseFastEngine);
+
  fQC->Init();
  
  if(fQC->GetHistList()) 
@@ -354,6 +359,17 @@ void AliAnalysisTaskQCumulants::UserExec(Option_t *)
 
 //================================================================================================================
 
+void AliAnalysisTaskQCumulants::FinishTaskOutput()
+{
+ // Called once per worker before the output is merged. With the fast engine the reference flow 
+ // profiles are materialized here from the sums accumulated in plain arrays.
+
+ if(fQC){fQC->FinalizeFastEngine();}
+ 
+} // end of void AliAnalysisTaskQCumulants::FinishTaskOutput()
+
+//================================================================================================================
+
 void AliAnalysisTaskQCumulants::Terminate(Option_t *) 
 {
  //accessing the merged output list: 
@@ -36,6 +36,7 @@ class AliAnalysisTaskQCumulants : public AliAnalysisTaskSE{
   
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
+  virtual void FinishTaskOutput();
   virtual void Terminate(Option_t *);
   
   // Common:
@@ -132,6 +133,9 @@ class AliAnalysisTaskQCumulants : public AliAnalysisTaskSE{
   Bool_t GetUseBootstrapVsM() const {return this->fUseBootstrapVsM;};
   void SetnSubsamples(Int_t const ns) {this->fnSubsamples = ns;};
   Int_t GetnSubsamples() const {return this->fnSubsamples;};
+  // Fast engine:
+  void SetUseFastEngine(Bool_t const ufe) {this->fUseFastEngine = ufe;};
+  Bool_t GetUseFastEngine() const {return this->fUseFastEngine;};
 
  private:
   AliAnalysisTaskQCumulants(const AliAnalysisTaskQCumulants& aatqc);
@@ -191,8 +195,10 @@ class AliAnalysisTaskQCumulants : public AliAnalysisTaskSE{
   Bool_t fUseBootstrap; // use bootstrap to estimate statistical spread
   Bool_t fUseBootstrapVsM; // use bootstrap to estimate statistical spread for results vs M
   Int_t fnSubsamples; // number of subsamples (SS), by default 10
+  // Fast engine:
+  Bool_t fUseFastEngine; // Q-vectors from flat arrays and reference flow profiles accumulated in plain arrays
   
-  ClassDef(AliAnalysisTaskQCumulants, 2); 
+  ClassDef(AliAnalysisTaskQCumulants, 3); 
 };
 
 //================================================================================================================
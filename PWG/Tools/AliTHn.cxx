@@ -53,7 +53,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fAxisMin(0),
+  fAxisMax(0),
+  fAxisEdges(0),
+  fNThreads(0),
+  fNThreadBlocks(0),
+  fThreadValues(0),
+  fThreadSumw2(0),
+  fThreadWeighted(0),
+  fThreadLastVars(0),
+  fThreadLastBins(0)
 {
   // Constructor
 }
@@ -69,7 +79,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fAxisMin(0),
+  fAxisMax(0),
+  fAxisEdges(0),
+  fNThreads(0),
+  fNThreadBlocks(0),
+  fThreadValues(0),
+  fThreadSumw2(0),
+  fThreadWeighted(0),
+  fThreadLastVars(0),
+  fThreadLastBins(0)
 {
   // Constructor
 
@@ -106,7 +126,17 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fAxisMin(0),
+  fAxisMax(0),
+  fAxisEdges(0),
+  fNThreads(0),
+  fNThreadBlocks(0),
+  fThreadValues(0),
+  fThreadSumw2(0),
+  fThreadWeighted(0),
+  fThreadLastVars(0),
+  fThreadLastBins(0)
 {
   //
   // AliTHnT copy constructor
@@ -127,6 +157,7 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
 {
   // Destructor
   
+  DeleteThreadBuffers();
   DeleteContainers();
   
   delete[] fValues;
@@ -135,6 +166,9 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   delete[] fNbinsCache;
   delete[] fLastVars;
   delete[] fLastBins;
+  delete[] fAxisMin;
+  delete[] fAxisMax;
+  delete[] fAxisEdges;
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -165,6 +199,9 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
   // assigment operator
 
   if (this != &c) {
+    // content of the thread buffers is replaced as well (before fNSteps changes)
+    DeleteThreadBuffers();
+
     AliCFContainer::operator=(c);
     fNBins=c.fNBins;
     fNVars=c.fNVars;
@@ -194,6 +231,14 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
     delete [] axisCache;
     axisCache = new TAxis*[fNVars];
     memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
+
+    // rebuilt at the next FillN
+    delete [] fAxisMin;
+    delete [] fAxisMax;
+    delete [] fAxisEdges;
+    fAxisMin = 0;
+    fAxisMax = 0;
+    fAxisEdges = 0;
   }
   return *this;
 }
@@ -244,6 +289,8 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
   
   AliCFContainer::Merge(list);
 
+  MergeThreadBuffers();
+
   TIterator* iter = list->MakeIterator();
   TObject* obj;
   
@@ -254,6 +301,8 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
     if (entry == 0) 
       continue;
 
+    entry->MergeThreadBuffers();
+
     for (Int_t i=0; i<fNSteps; i++)
     {
       if (entry->fValues[i])
@@ -282,57 +331,90 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
 }
 
 template <class TemplateArray, typename TemplateType>
-void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+void AliTHnT<TemplateArray, TemplateType>::InitAxisCache(const Double_t* var)
 {
-  // fills an entry
+  // fills the axis cache, <var> (if given) is used as first entry of the last used bins
 
-  // fill axis cache
-  if (!axisCache)
+  axisCache = new TAxis*[fNVars];
+  fNbinsCache = new Int_t[fNVars];
+  for (Int_t i=0; i<fNVars; i++)
   {
-    axisCache = new TAxis*[fNVars];
-    fNbinsCache = new Int_t[fNVars];
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      axisCache[i] = GetAxis(i, 0);
-      fNbinsCache[i] = axisCache[i]->GetNbins();
-    }
-    
-    fLastVars = new Double_t[fNVars];
-    fLastBins = new Int_t[fNVars];
-    
-    // initial values to prevent checking for 0 below
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      fLastBins[i] = axisCache[i]->FindBin(var[i]);
-      fLastVars[i] = var[i];
-    }
+    axisCache[i] = GetAxis(i, 0);
+    fNbinsCache[i] = axisCache[i]->GetNbins();
   }
   
-  // calculate global bin index
+  fLastVars = new Double_t[fNVars];
+  fLastBins = new Int_t[fNVars];
+  
+  // initial values to prevent checking for 0 below (an underflow value if var is not given)
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    fLastVars[i] = (var) ? var[i] : axisCache[i]->GetXmin() - 1;
+    fLastBins[i] = axisCache[i]->FindBin(fLastVars[i]);
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::InitBinningCache()
+{
+  // caches the axis ranges and, for axes with variable bin size, the bin edges used by FillN
+
+  fAxisMin = new Double_t[fNVars];
+  fAxisMax = new Double_t[fNVars];
+  fAxisEdges = new const Double_t*[fNVars];
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    fAxisMin[i] = axisCache[i]->GetXmin();
+    fAxisMax[i] = axisCache[i]->GetXmax();
+    fAxisEdges[i] = (axisCache[i]->GetXbins()->fN > 0) ? axisCache[i]->GetXbins()->GetArray() : 0;
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::FindGlobalBin(const Double_t* var, Double_t* lastVars, Int_t* lastBins)
+{
+  // calculates the global bin index of the entry <var>, -1 for entries in under/overflow bins
+  // lastVars and lastBins cache the last used bins
+  
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
   {
     bin *= fNbinsCache[i];
     
     Int_t tmpBin = 0;
-    if (fLastVars[i] == var[i])
-      tmpBin = fLastBins[i];
+    if (lastVars[i] == var[i])
+      tmpBin = lastBins[i];
     else
     {
       tmpBin = axisCache[i]->FindBin(var[i]);
-      fLastBins[i] = tmpBin;
-      fLastVars[i] = var[i];
+      lastBins[i] = tmpBin;
+      lastVars[i] = var[i];
     }
-    //Printf("%d", tmpBin);
 
     // under/overflow not supported
     if (tmpBin < 1 || tmpBin > fNbinsCache[i])
-      return;
+      return -1;
     
     // bins start from 0 here
     bin += tmpBin - 1;
-//     Printf("%lld", bin);
   }
+  
+  return bin;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+{
+  // fills an entry
+
+  // fill axis cache
+  if (!axisCache)
+    InitAxisCache(var);
+  
+  // calculate global bin index
+  Long64_t bin = FindGlobalBin(var, fLastVars, fLastBins);
+  if (bin < 0)
+    return;
 
   if (!fValues[istep])
   {
@@ -360,6 +442,277 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 //   AliCFContainer::Fill(var, istep, weight);
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillN(Int_t nEntries, const Double_t *vars, const Double_t *weights, Int_t istep)
+{
+  // fills nEntries entries, entry j has the values vars[j*fNVars ... (j+1)*fNVars-1] and the weight weights[j] (1 if weights == 0)
+  // same result as calling Fill for each entry, but the global bin indices are computed for blocks of entries
+  // and axis by axis: for equidistant axes the bin is computed directly (the loop over the entries can be
+  // vectorized by the compiler), for axes with variable bin size by binary search over the bin edges
+
+  if (nEntries <= 0)
+    return;
+
+  if (!axisCache)
+    InitAxisCache(vars);
+  if (!fAxisMin)
+    InitBinningCache();
+
+  if (!fValues[istep])
+  {
+    fValues[istep] = new TemplateArray(fNBins);
+    AliInfo(Form("Created values container for step %d", istep));
+  }
+
+  if (weights && !fSumw2[istep])
+  {
+    for (Int_t j=0; j<nEntries; j++)
+    {
+      if (weights[j] != 1)
+      {
+        // initialize with already filled entries (which have been filled with weight == 1), in this case fSumw2 := fValues
+        fSumw2[istep] = new TemplateArray(*fValues[istep]);
+        AliInfo(Form("Created sumw2 container for step %d", istep));
+        break;
+      }
+    }
+  }
+
+  TemplateType* values = fValues[istep]->GetArray();
+  TemplateType* sumw2 = (fSumw2[istep]) ? fSumw2[istep]->GetArray() : 0;
+
+  const Int_t kBlockSize = 256;
+  Long64_t bins[kBlockSize];
+  Int_t inside[kBlockSize];
+
+  for (Int_t start=0; start<nEntries; start+=kBlockSize)
+  {
+    const Int_t nBlock = TMath::Min(kBlockSize, nEntries - start);
+    const Double_t* blockVars = vars + (Long64_t) start * fNVars;
+
+    for (Int_t j=0; j<nBlock; j++)
+    {
+      bins[j] = 0;
+      inside[j] = 1;
+    }
+
+    for (Int_t i=0; i<fNVars; i++)
+    {
+      const Int_t nBins = fNbinsCache[i];
+      const Double_t xMin = fAxisMin[i];
+      const Double_t xMax = fAxisMax[i];
+
+      if (!fAxisEdges[i])
+      {
+        // same arithmetic as TAxis::FindBin, under/overflow not supported
+        const Double_t width = xMax - xMin;
+        for (Int_t j=0; j<nBlock; j++)
+        {
+          const Double_t x = blockVars[j*fNVars + i];
+          const Int_t inRange = (x >= xMin) & (x < xMax);
+          const Int_t tmpBin = inRange ? (Int_t) (nBins * (x - xMin) / width) : 0;
+          inside[j] &= inRange & (tmpBin < nBins);
+          bins[j] = bins[j] * nBins + tmpBin;
+        }
+      }
+      else
+      {
+        const Double_t* edges = fAxisEdges[i];
+        for (Int_t j=0; j<nBlock; j++)
+        {
+          const Double_t x = blockVars[j*fNVars + i];
+          if (fLastVars[i] != x)
+          {
+            fLastVars[i] = x;
+            fLastBins[i] = (x >= xMin && x < xMax) ? 1 + TMath::BinarySearch(nBins + 1, edges, x) : 0;
+          }
+          inside[j] &= (fLastBins[i] >= 1) & (fLastBins[i] <= nBins);
+          bins[j] = bins[j] * nBins + fLastBins[i] - 1;
+        }
+      }
+    }
+
+    for (Int_t j=0; j<nBlock; j++)
+    {
+      if (!inside[j])
+        continue;
+
+      const Double_t weight = (weights) ? weights[start + j] : 1.;
+      values[bins[j]] += weight;
+      if (sumw2)
+        sumw2[bins[j]] += weight * weight;
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetThreadBuffers(Int_t nThreads)
+{
+  // creates nThreads (empty) thread buffers, the content of existing buffers is merged first
+  // has to be called before the threads start filling
+
+  MergeThreadBuffers();
+  DeleteThreadBuffers();
+
+  if (nThreads <= 0)
+    return;
+
+  // the axis cache is shared (read-only) by the threads
+  if (!axisCache)
+    InitAxisCache(0);
+
+  fNThreads = nThreads;
+  fNThreadBlocks = (fNBins + kThreadBlockSize - 1) / kThreadBlockSize;
+
+  const Int_t nBuffers = fNThreads * fNSteps;
+  fThreadValues = new TemplateType**[nBuffers];
+  fThreadSumw2 = new TemplateType**[nBuffers];
+  fThreadWeighted = new Bool_t[nBuffers];
+  for (Int_t i=0; i<nBuffers; i++)
+  {
+    fThreadValues[i] = new TemplateType*[fNThreadBlocks];
+    fThreadSumw2[i] = new TemplateType*[fNThreadBlocks];
+    memset(fThreadValues[i], 0, fNThreadBlocks*sizeof(TemplateType*));
+    memset(fThreadSumw2[i], 0, fNThreadBlocks*sizeof(TemplateType*));
+    fThreadWeighted[i] = kFALSE;
+  }
+
+  fThreadLastVars = new Double_t[fNThreads * fNVars];
+  fThreadLastBins = new Int_t[fNThreads * fNVars];
+  for (Int_t t=0; t<fNThreads; t++)
+  {
+    memcpy(fThreadLastVars + t * fNVars, fLastVars, fNVars*sizeof(Double_t));
+    memcpy(fThreadLastBins + t * fNVars, fLastBins, fNVars*sizeof(Int_t));
+  }
+
+  AliInfo(Form("Created %d thread buffers with %lld blocks per step", fNThreads, fNThreadBlocks));
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillThread(Int_t thread, const Double_t *var, Int_t istep, Double_t weight)
+{
+  // fills an entry into the buffer of thread <thread>
+  // only the buffer of this thread is modified, so that different threads can fill at the same time without locking
+
+  Long64_t bin = FindGlobalBin(var, fThreadLastVars + thread * fNVars, fThreadLastBins + thread * fNVars);
+  if (bin < 0)
+    return;
+
+  const Int_t buffer = thread * fNSteps + istep;
+  const Long64_t block = bin / kThreadBlockSize;
+  TemplateType*& values = fThreadValues[buffer][block];
+  TemplateType*& sumw2 = fThreadSumw2[buffer][block];
+  if (!values)
+  {
+    values = new TemplateType[kThreadBlockSize];
+    sumw2 = new TemplateType[kThreadBlockSize];
+    memset(values, 0, kThreadBlockSize*sizeof(TemplateType));
+    memset(sumw2, 0, kThreadBlockSize*sizeof(TemplateType));
+  }
+
+  if (weight != 1)
+    fThreadWeighted[buffer] = kTRUE;
+
+  const Long64_t binInBlock = bin - block * kThreadBlockSize;
+  values[binInBlock] += weight;
+  sumw2[binInBlock] += weight * weight;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::MergeThreadBuffers()
+{
+  // adds the content of the thread buffers to the data containers and empties the buffers
+
+  if (fNThreads == 0)
+    return;
+
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    Bool_t filled = kFALSE;
+    Bool_t weighted = kFALSE;
+    for (Int_t t=0; t<fNThreads; t++)
+    {
+      const Int_t buffer = t * fNSteps + i;
+      weighted |= fThreadWeighted[buffer];
+      for (Long64_t b=0; b<fNThreadBlocks && !filled; b++)
+        filled = (fThreadValues[buffer][b] != 0);
+    }
+    if (!filled)
+      continue;
+
+    if (!fValues[i])
+    {
+      fValues[i] = new TemplateArray(fNBins);
+      AliInfo(Form("Created values container for step %d", i));
+    }
+
+    // as in Fill: initialize with already filled entries (which have been filled with weight == 1)
+    if (weighted && !fSumw2[i])
+    {
+      fSumw2[i] = new TemplateArray(*fValues[i]);
+      AliInfo(Form("Created sumw2 container for step %d", i));
+    }
+
+    TemplateType* values = fValues[i]->GetArray();
+    TemplateType* sumw2 = (fSumw2[i]) ? fSumw2[i]->GetArray() : 0;
+    for (Int_t t=0; t<fNThreads; t++)
+    {
+      const Int_t buffer = t * fNSteps + i;
+      for (Long64_t b=0; b<fNThreadBlocks; b++)
+      {
+        TemplateType* blockValues = fThreadValues[buffer][b];
+        TemplateType* blockSumw2 = fThreadSumw2[buffer][b];
+        if (!blockValues)
+          continue;
+
+        const Long64_t offset = b * kThreadBlockSize;
+        const Long64_t nBins = TMath::Min((Long64_t) kThreadBlockSize, fNBins - offset);
+        for (Long64_t l=0; l<nBins; l++)
+          values[offset + l] += blockValues[l];
+        if (sumw2)
+          for (Long64_t l=0; l<nBins; l++)
+            sumw2[offset + l] += blockSumw2[l];
+
+        delete[] blockValues;
+        delete[] blockSumw2;
+        fThreadValues[buffer][b] = 0;
+        fThreadSumw2[buffer][b] = 0;
+      }
+      fThreadWeighted[buffer] = kFALSE;
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteThreadBuffers()
+{
+  // deletes the thread buffers (without merging their content)
+
+  for (Int_t i=0; i<fNThreads * fNSteps; i++)
+  {
+    for (Long64_t b=0; b<fNThreadBlocks; b++)
+    {
+      delete[] fThreadValues[i][b];
+      delete[] fThreadSumw2[i][b];
+    }
+    delete[] fThreadValues[i];
+    delete[] fThreadSumw2[i];
+  }
+  delete[] fThreadValues;
+  delete[] fThreadSumw2;
+  delete[] fThreadWeighted;
+  delete[] fThreadLastVars;
+  delete[] fThreadLastBins;
+
+  fNThreads = 0;
+  fNThreadBlocks = 0;
+  fThreadValues = 0;
+  fThreadSumw2 = 0;
+  fThreadWeighted = 0;
+  fThreadLastVars = 0;
+  fThreadLastBins = 0;
+}
+
 template <class TemplateArray, typename TemplateType>
 Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* binIdx)
 {
@@ -448,6 +801,7 @@ void AliTHnT<TemplateArray, TemplateType>::FillParent()
 {
   // fills the information stored in the buffer in this class into the baseclass containers
   
+  MergeThreadBuffers();
   FillContainer(this);
 }
 
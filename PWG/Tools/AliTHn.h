@@ -26,6 +26,10 @@ public:
   AliTHnBase(const Char_t* name, const Char_t* title,const Int_t nSelStep, const Int_t nVarIn, const Int_t* nBinIn) : AliCFContainer(name, title, nSelStep, nVarIn, nBinIn) { }
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void FillN(Int_t nEntries, const Double_t *vars, const Double_t *weights, Int_t istep) = 0;
+  virtual void SetThreadBuffers(Int_t nThreads) = 0;
+  virtual void FillThread(Int_t thread, const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void MergeThreadBuffers() = 0;
   virtual void FillParent() = 0;
   virtual void FillContainer(AliCFContainer* cont) = 0;
 
@@ -48,6 +52,17 @@ class AliTHnT : public AliTHnBase
   virtual ~AliTHnT();
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  // fills nEntries entries, vars contains fNVars values per entry (entry after entry), weights can be 0 (all weights 1)
+  virtual void FillN(Int_t nEntries, const Double_t *vars, const Double_t *weights, Int_t istep);
+  
+  // filling from several threads: each thread fills its own buffer with FillThread (thread = 0..nThreads-1),
+  // the buffers are allocated in blocks of bins when first touched and are added to the content with
+  // MergeThreadBuffers, which has to be called once the threads are done and before the object is written
+  // (it is called by FillParent and Merge)
+  virtual void SetThreadBuffers(Int_t nThreads);
+  virtual void FillThread(Int_t thread, const Double_t *var, Int_t istep, Double_t weight=1.);
+  virtual void MergeThreadBuffers();
+  
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
@@ -65,8 +80,14 @@ class AliTHnT : public AliTHnBase
   
 protected:
   void Init();
+  void InitAxisCache(const Double_t* var);
+  void InitBinningCache();
+  Long64_t FindGlobalBin(const Double_t* var, Double_t* lastVars, Int_t* lastBins);
+  void DeleteThreadBuffers();
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
   
+  enum { kThreadBlockSize = 4096 }; // number of bins per block of the thread buffers
+  
   Long64_t fNBins;   // number of total bins
   Int_t    fNVars;   // number of variables
   Int_t    fNSteps;  // number of selection steps
@@ -77,6 +98,17 @@ protected:
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
+  Double_t* fAxisMin;   //! lower edge per axis (FillN)
+  Double_t* fAxisMax;   //! upper edge per axis (FillN)
+  const Double_t** fAxisEdges; //! bin edges per axis, 0 for equidistant axes (FillN)
+  
+  Int_t fNThreads;                  //! number of thread buffers
+  Long64_t fNThreadBlocks;          //! number of blocks per step of a thread buffer
+  TemplateType*** fThreadValues;    //! [thread*fNSteps+step][block] values filled by the threads, 0 for untouched blocks
+  TemplateType*** fThreadSumw2;     //! [thread*fNSteps+step][block] sum of squared weights filled by the threads
+  Bool_t* fThreadWeighted;          //! [thread*fNSteps+step] weight != 1 used
+  Double_t* fThreadLastVars;        //! [thread*fNVars+var] last used values per thread
+  Int_t* fThreadLastBins;           //! [thread*fNVars+var] last used bins per thread
   
   ClassDef(AliTHnT, 5) // THn like container
 };
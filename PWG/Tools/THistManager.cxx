@@ -30,6 +30,7 @@
 #include <TObjArray.h>
 #include <TObjString.h>
 #include <TProfile.h>
+#include <TStopwatch.h>
 #include <TString.h>
 
 #include "TBinning.h"
@@ -42,14 +43,18 @@ ClassImp(THistManager)
 THistManager::THistManager():
 		TNamed(),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHandleObjects(),
+		fHandleTypes()
 {
 }
 
 THistManager::THistManager(const char *name):
 		TNamed(name, Form("Histogram container %s", name)),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHandleObjects(),
+		fHandleTypes()
 {
 	fHistos = new THashList();
 	fHistos->SetName(Form("histos%s", name));
@@ -420,6 +425,10 @@ void THistManager::FillTH1(const char *name, double x, double weight, Option_t *
 		Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
 		return;
 	}
+	DoFillTH1(hist, x, weight, opt);
+}
+
+void THistManager::DoFillTH1(TH1 *hist, double x, double weight, Option_t *opt) {
 	TString optionstring(opt);
 	if(optionstring.Contains("w")){
 	  // use bin width as weight
@@ -467,6 +476,10 @@ void THistManager::FillTH2(const char *name, double x, double y, double weight,
 		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
 		return;
 	}
+	DoFillTH2(hist, x, y, weight, opt);
+}
+
+void THistManager::DoFillTH2(TH2 *hist, double x, double y, double weight, Option_t *opt) {
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -542,6 +555,10 @@ void THistManager::FillTH3(const char* name, double x, double y, double z, doubl
 		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
 		return;
 	}
+	DoFillTH3(hist, x, y, z, weight, opt);
+}
+
+void THistManager::DoFillTH3(TH3 *hist, double x, double y, double z, double weight, Option_t *opt) {
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	if(optstring.Contains("wx")){
@@ -600,6 +617,10 @@ void THistManager::FillTHnSparse(const char *name, const double *x, double weigh
 		Fatal("THistManager::FillTHnSparse", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
 		return;
 	}
+	DoFillTHnSparse(hist, x, weight, opt);
+}
+
+void THistManager::DoFillTHnSparse(THnSparse *hist, const double *x, double weight, Option_t *opt) {
 	TString optstring(opt);
 	Double_t myweight = optstring.Contains("w") ? 1. : weight;
 	for(Int_t iaxis = 0; iaxis < hist->GetNdimensions(); iaxis++){
@@ -625,6 +646,69 @@ void THistManager::FillProfile(const char* name, double x, double y, double weig
   hist->Fill(x, y, weight);
 }
 
+THistManager::THistHandle THistManager::GetHandle(const char *name) {
+	TString dirname(basename(name)), hname(histname(name));
+	THashList *parent(FindGroup(dirname));
+	if(!parent){
+		Fatal("THistManager::GetHandle", "Parent group %s does not exist", dirname.Data());
+		return THistHandle();
+	}
+	TObject *hist = parent->FindObject(hname);
+	if(!hist){
+		Fatal("THistManager::GetHandle", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		return THistHandle();
+	}
+	for(size_t index = 0; index < fHandleObjects.size(); index++){
+		if(fHandleObjects[index] == hist) return THistHandle(index);
+	}
+	THistType_t type;
+	// order matters: TProfile inherits from TH1, TH3 and TH2 as well
+	if(hist->InheritsFrom(TProfile::Class())) type = kTProfile;
+	else if(hist->InheritsFrom(TH3::Class())) type = kTH3;
+	else if(hist->InheritsFrom(TH2::Class())) type = kTH2;
+	else if(hist->InheritsFrom(TH1::Class())) type = kTH1;
+	else if(hist->InheritsFrom(THnSparse::Class())) type = kTHnSparse;
+	else {
+		Fatal("THistManager::GetHandle", "Object %s is not of a histogram type", name);
+		return THistHandle();
+	}
+	fHandleObjects.push_back(hist);
+	fHandleTypes.push_back(type);
+	return THistHandle(fHandleObjects.size() - 1);
+}
+
+TObject *THistManager::GetHistogram(const THistHandle &handle, THistType_t type, const char *method) const {
+	if(handle.fIndex < 0 || handle.fIndex >= static_cast<Int_t>(fHandleObjects.size())){
+		Fatal(method, "Invalid histogram handle %d", handle.fIndex);
+		return nullptr;
+	}
+	if(fHandleTypes[handle.fIndex] != type){
+		Fatal(method, "Histogram %s is not of the requested type", fHandleObjects[handle.fIndex]->GetName());
+		return nullptr;
+	}
+	return fHandleObjects[handle.fIndex];
+}
+
+void THistManager::FillTH1(const THistHandle &handle, double x, double weight, Option_t *opt) {
+	DoFillTH1(static_cast<TH1 *>(GetHistogram(handle, kTH1, "THistManager::FillTH1")), x, weight, opt);
+}
+
+void THistManager::FillTH2(const THistHandle &handle, double x, double y, double weight, Option_t *opt) {
+	DoFillTH2(static_cast<TH2 *>(GetHistogram(handle, kTH2, "THistManager::FillTH2")), x, y, weight, opt);
+}
+
+void THistManager::FillTH3(const THistHandle &handle, double x, double y, double z, double weight, Option_t *opt) {
+	DoFillTH3(static_cast<TH3 *>(GetHistogram(handle, kTH3, "THistManager::FillTH3")), x, y, z, weight, opt);
+}
+
+void THistManager::FillTHnSparse(const THistHandle &handle, const double *x, double weight, Option_t *opt) {
+	DoFillTHnSparse(static_cast<THnSparse *>(GetHistogram(handle, kTHnSparse, "THistManager::FillTHnSparse")), x, weight, opt);
+}
+
+void THistManager::FillProfile(const THistHandle &handle, double x, double y, double weight) {
+	static_cast<TProfile *>(GetHistogram(handle, kTProfile, "THistManager::FillTProfile"))->Fill(x, y, weight);
+}
+
 TObject *THistManager::FindObject(const char *name) const {
 	TString dirname(basename(name)), hname(histname(name));
 	THashList *parent(FindGroup(dirname));
@@ -1030,6 +1114,77 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandleHistograms(){
+    // same histograms in two managers, one filled by name, one via handles
+    THistManager namemgr("namemgr"), handlemgr("handlemgr");
+    THistManager *managers[2] = {&namemgr, &handlemgr};
+    int nbins[3] = {10, 10, 10}; double min[3] = {0., 0., 0.}, max[3] = {1., 1., 1.};
+    for(auto mgr : managers){
+      mgr->CreateTH1("Group1/Subgroup1/Test1", "Test 1D", 10, 0., 1.);
+      mgr->CreateTH2("Group1/Subgroup1/Test2", "Test 2D", 10, 0., 1., 10, 0., 1.);
+      mgr->CreateTHnSparse("Group2/TestN", "Test THnSparse", 3, nbins, min, max);
+    }
+
+    bool success(true);
+    THistManager::THistHandle h1 = handlemgr.GetHandle("Group1/Subgroup1/Test1"),
+                              h2 = handlemgr.GetHandle("Group1/Subgroup1/Test2"),
+                              hN = handlemgr.GetHandle("Group2/TestN");
+    if(!(h1.IsValid() && h2.IsValid() && hN.IsValid())){
+      std::cout << "Invalid handle" << std::endl;
+      success = false;
+    }
+    if(!(handlemgr.GetHandle("Group1/Subgroup1/Test1") == h1)){
+      std::cout << "Handles for the same histogram differ" << std::endl;
+      success = false;
+    }
+
+    const int kNfill = 100000;
+    TStopwatch timer;
+    timer.Start();
+    for(int i = 0; i < kNfill; i++){
+      double point[3] = {(i % 10) * 0.1 + 0.05, (i % 7) * 0.1 + 0.05, (i % 3) * 0.1 + 0.05};
+      namemgr.FillTH1("Group1/Subgroup1/Test1", point[0]);
+      namemgr.FillTH2("Group1/Subgroup1/Test2", point[0], point[1]);
+      namemgr.FillTHnSparse("Group2/TestN", point);
+    }
+    timer.Stop();
+    double timename = timer.RealTime();
+    timer.Start();
+    for(int i = 0; i < kNfill; i++){
+      double point[3] = {(i % 10) * 0.1 + 0.05, (i % 7) * 0.1 + 0.05, (i % 3) * 0.1 + 0.05};
+      handlemgr.FillTH1(h1, point[0]);
+      handlemgr.FillTH2(h2, point[0], point[1]);
+      handlemgr.FillTHnSparse(hN, point);
+    }
+    timer.Stop();
+    double timehandle = timer.RealTime();
+    std::cout << "Filling " << kNfill << " times 3 histograms: by name " << timename << " s, via handles " << timehandle << " s" << std::endl;
+
+    // Evaluate test
+    const char *histnames[3] = {"Group1/Subgroup1/Test1", "Group1/Subgroup1/Test2", "Group2/TestN"};
+    for(auto histname : histnames){
+      TObject *byname = namemgr.FindObject(histname), *byhandle = handlemgr.FindObject(histname);
+      double entriesname(0), entrieshandle(0), sumname(0), sumhandle(0);
+      if(byname && byname->InheritsFrom(TH1::Class())){
+        TH1 *hname = static_cast<TH1 *>(byname), *hhandle = static_cast<TH1 *>(byhandle);
+        entriesname = hname->GetEntries(); entrieshandle = hhandle->GetEntries();
+        for(int ibin = 0; ibin < hname->GetNcells(); ibin++){
+          sumname += ibin * hname->GetBinContent(ibin);
+          sumhandle += ibin * hhandle->GetBinContent(ibin);
+        }
+      } else if(byname){
+        THnSparse *hname = static_cast<THnSparse *>(byname), *hhandle = static_cast<THnSparse *>(byhandle);
+        entriesname = hname->GetEntries(); entrieshandle = hhandle->GetEntries();
+        sumname = hname->GetNbins(); sumhandle = hhandle->GetNbins();
+      }
+      if(!byname || !byhandle || entriesname != kNfill || entriesname != entrieshandle || TMath::Abs(sumname - sumhandle) > DBL_EPSILON){
+        std::cout << histname << ": Mismatch between name-based and handle-based filling" << std::endl;
+        success = false;
+      }
+    }
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1050,6 +1205,10 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handle" << std::endl;
+    testresult += testsuite.TestFillHandleHistograms();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1072,4 +1231,9 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandle(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandleHistograms();
+  }
 }
@@ -7,6 +7,7 @@
 #include <TIterator.h>
 #include <TNamed.h>
 #include <iterator>
+#include <vector>
 
 class TArrayD;
 class TAxis;
@@ -95,10 +96,68 @@ class TProfile;
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
  * the weight is calculated for all directions at the same time.
+ *
+ * ## Filling via handles
+ *
+ * Name-based filling needs to resolve the group path and to look up the histogram
+ * by name in each call. For histograms filled many times per event (i.e. per track)
+ * a handle can be obtained once after the histogram is created and used in the
+ * corresponding Fill method instead of the name:
+ *
+ * ~~~{.cxx}
+ * mgr.CreateTH1("tracks/hPt", "pt-distribution", TLinearBinning(100, 0., 100.));
+ * THistManager::THistHandle ptHandle = mgr.GetHandle("tracks/hPt");
+ * ...
+ * mgr.FillTH1(ptHandle, pt);
+ * ~~~
+ *
+ * Handles are only valid for the histogram manager which created them and
+ * are not persistent, they need to be obtained again after the histogram manager
+ * is read from file.
  */
 class THistManager : public TNamed {
 public:
 
+  /**
+   * @class THistHandle
+   * @brief Handle to a histogram inside the histogram manager
+   * @ingroup Histmanager
+   *
+   * Opaque handle obtained via GetHandle, pointing to the histogram
+   * inside the histogram manager without the need of a name lookup.
+   * A default-constructed handle is invalid.
+   */
+  class THistHandle {
+  public:
+    /**
+     * @brief Default constructor, creating an invalid handle
+     */
+    THistHandle(): fIndex(-1) { }
+
+    /**
+     * @brief Destructor
+     */
+    ~THistHandle() { }
+
+    /**
+     * @brief Check whether the handle points to a histogram
+     * @return True if the handle is valid
+     */
+    Bool_t IsValid() const { return fIndex >= 0; }
+
+    /**
+     * @brief Comparison operator
+     * @param[in] other Handle to compare to
+     * @return True if both handles point to the same histogram
+     */
+    Bool_t operator==(const THistHandle &other) const { return fIndex == other.fIndex; }
+
+  private:
+    friend class THistManager;
+    explicit THistHandle(Int_t index): fIndex(index) { }
+    Int_t fIndex;                                 ///< Index of the histogram in the handle table
+  };
+
   /**
    * @class iterator
    * @brief stl-iterator for the histogram manager
@@ -634,6 +693,66 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+  /**
+   * @brief Get a handle to a histogram inside the container.
+   *
+   * The name of the histogram is resolved (following the common group notation)
+   * only once, the handle can be used in the handle-based Fill functions.
+   * Handles for the same histogram are identical.
+   * @param[in] name Name of the histogram
+   * @return Handle to the histogram
+   * @throw Fatal if the histogram does not exist
+   */
+  THistHandle GetHandle(const char *name);
+
+  /**
+   * @brief Fill a 1D histogram within the container accessed via handle
+   * @param[in] handle Handle of the histogram (see GetHandle)
+   * @param[in] x x-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] option Optional filling arguments
+   */
+  void FillTH1(const THistHandle &handle, double x, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a 2D histogram within the container accessed via handle
+   * @param[in] handle Handle of the histogram (see GetHandle)
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] option Optional filling arguments
+   */
+  void FillTH2(const THistHandle &handle, double x, double y, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a 3D histogram within the container accessed via handle
+   * @param[in] handle Handle of the histogram (see GetHandle)
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] z z-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] option Optional filling arguments
+   */
+  void FillTH3(const THistHandle &handle, double x, double y, double z, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a nD histogram within the container accessed via handle
+   * @param[in] handle Handle of the histogram (see GetHandle)
+   * @param[in] x coordinates of the data
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] option Optional filling arguments
+   */
+  void FillTHnSparse(const THistHandle &handle, const double *x, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a profile histogram within the container accessed via handle
+   * @param[in] handle Handle of the histogram (see GetHandle)
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillProfile(const THistHandle &handle, double x, double y, double weight = 1.);
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -695,6 +814,37 @@ private:
 	THistManager(const THistManager &);
 	THistManager &operator=(const THistManager &);
 
+	/**
+	 * @enum THistType_t
+	 * @brief Histogram types handled in the handle table
+	 */
+	enum THistType_t {
+	  kTH1 = 0,        ///< 1D histogram
+	  kTH2 = 1,        ///< 2D histogram
+	  kTH3 = 2,        ///< 3D histogram
+	  kTHnSparse = 3,  ///< THnSparse
+	  kTProfile = 4    ///< Profile histogram
+	};
+
+	/**
+	 * @brief Get the histogram connected to a handle.
+	 *
+	 * Checks whether the handle is valid and the histogram of the expected type.
+	 * @param[in] handle Handle of the histogram
+	 * @param[in] type Expected histogram type
+	 * @param[in] method Name of the calling method (for error messages)
+	 * @return The histogram
+	 */
+	TObject *GetHistogram(const THistHandle &handle, THistType_t type, const char *method) const;
+
+	/**
+	 * @brief Fill functions on the resolved histograms, common to name- and handle-based filling
+	 */
+	void DoFillTH1(TH1 *hist, double x, double weight, Option_t *opt);
+	void DoFillTH2(TH2 *hist, double x, double y, double weight, Option_t *opt);
+	void DoFillTH3(TH3 *hist, double x, double y, double z, double weight, Option_t *opt);
+	void DoFillTHnSparse(THnSparse *hist, const double *x, double weight, Option_t *opt);
+
 
 	/**
 	 * @brief Find histogram group.
@@ -721,6 +871,8 @@ private:
 
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
+	std::vector<TObject *> fHandleObjects;    //!<! Histograms connected to handles
+	std::vector<THistType_t> fHandleTypes;    //!<! Types of the histograms connected to handles
 
   /// \cond CLASSIMP
 	ClassDef(THistManager, 1);  // Container for histograms
@@ -845,6 +997,21 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Compare name-based and handle-based filling
+   * Relies on: TestFillGroupedHistograms
+   *
+   * Filling a TH1, a TH2 and a THnSparse in groups 100000 times each,
+   * once via the name and once via handles, and printing the time needed
+   * for both methods.
+   *
+   * Test passed:
+   * - Handles for the same histogram are identical
+   * - Histograms filled by name and via handles have the same content
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandleHistograms();
 };
 
 /**
@@ -882,5 +1049,12 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test comparing name-based and handle-based filling.
+ * See @ref THistManagerTestSuite for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandle();
+
 }
 #endif
@@ -272,6 +272,8 @@ class AliFemtoDreamBasePart {
     fEvtMultiplicity = evtMulti;
   }
   void DumpParticleInformation();
+  //reads the members directly to avoid the copies of the getters
+  friend class AliFemtoDreamPartBlock;
 
  protected:
   bool fIsReset;
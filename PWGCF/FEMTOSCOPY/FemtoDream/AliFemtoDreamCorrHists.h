@@ -71,6 +71,10 @@ class AliFemtoDreamCorrHists {
     fSameEventDist[i]->Fill(RelK);
   }
   ;
+  void FillSameEventDist(int i, int nPairs, const double *RelK) {
+    fSameEventDist[i]->FillN(nPairs, RelK, nullptr);
+  }
+  ;
   void FillSameEventMultDist(int i, int iMult, float RelK) {
     if (fSameEventMultDist[i])
       fSameEventMultDist[i]->Fill(RelK, iMult);
@@ -102,6 +106,10 @@ class AliFemtoDreamCorrHists {
     fMixedEventDist[i]->Fill(RelK);
   }
   ;
+  void FillMixedEventDist(int i, int nPairs, const double *RelK) {
+    fMixedEventDist[i]->FillN(nPairs, RelK, nullptr);
+  }
+  ;
   void FillPtQADist(int i, float kstar, float pt1, float pt2) {
     if (!fMinimalBooking) {
       // TODO for the moment the threshold is hardcoded to 200 MeV/c
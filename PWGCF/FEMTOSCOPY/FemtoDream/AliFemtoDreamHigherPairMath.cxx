@@ -8,6 +8,8 @@
 #include <AliFemtoDreamHigherPairMath.h>
 #include "TMath.h"
 #include "TDatabasePDG.h"
+#include <algorithm>
+#include <cmath>
 static const float piHi = TMath::Pi();
 
 AliFemtoDreamHigherPairMath::AliFemtoDreamHigherPairMath(
@@ -17,7 +19,11 @@ AliFemtoDreamHigherPairMath::AliFemtoDreamHigherPairMath(
       fBField(-99.),
       fDeltaPhiEtaMax(conf->GetSqDeltaPhiEtaMax()),
       fRandom(),
-      fPi(TMath::Pi()) {
+      fPi(TMath::Pi()),
+      fKernelMask(),
+      fKernelRelK(),
+      fKernelkT(),
+      fKernelPassRelK() {
   fRandom.SetSeed(0);
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
@@ -34,7 +40,11 @@ AliFemtoDreamHigherPairMath::AliFemtoDreamHigherPairMath(
       fBField(-99.),
       fDeltaPhiEtaMax(samp.fDeltaPhiEtaMax),
       fRandom(),
-      fPi(TMath::Pi()) {
+      fPi(TMath::Pi()),
+      fKernelMask(),
+      fKernelRelK(),
+      fKernelkT(),
+      fKernelPassRelK() {
   fRandom.SetSeed(0);
 }
 AliFemtoDreamHigherPairMath& AliFemtoDreamHigherPairMath::operator=(
@@ -138,6 +148,219 @@ void AliFemtoDreamHigherPairMath::RecalculatePhiStar(
   part.SetPhiAtRadius(tmpVec);
 }
 
+unsigned int AliFemtoDreamHigherPairMath::PairKernel(
+    const AliFemtoDreamPartBlock &block1, unsigned int iPart1, float mass1,
+    const AliFemtoDreamPartBlock &block2, unsigned int first2, float mass2,
+    bool doCPR) {
+  //Same pair selection as PassesPairSelection (without recalculation of
+  //phi*) and same k* as RelativePairMomentum, but for all the partners at
+  //once. The loops over the partners run over flat arrays without branches,
+  //such that the compiler can vectorize them. k* is obtained from the
+  //invariant k*^2 = ((q.P)^2/P^2 - q^2)/4 with q.P = m1^2 - m2^2 instead of
+  //boosting to the pair rest frame.
+  const unsigned int nPart2 = block2.GetNParticles();
+  const unsigned int nPartners = (first2 < nPart2) ? nPart2 - first2 : 0;
+  fKernelMask.assign(nPartners, 1);
+  fKernelRelK.resize(nPartners);
+  fKernelkT.resize(nPartners);
+  if (nPartners == 0) {
+    return 0;
+  }
+  int *mask = fKernelMask.data();
+  float *relK = fKernelRelK.data();
+  float *kT = fKernelkT.data();
+
+  const double px1 = block1.GetPx()[iPart1];
+  const double py1 = block1.GetPy()[iPart1];
+  const double pz1 = block1.GetPz()[iPart1];
+  const double e1 = std::sqrt(
+      px1 * px1 + py1 * py1 + pz1 * pz1 + (double) mass1 * mass1);
+  const double qP = (double) mass1 * mass1 - (double) mass2 * mass2;
+  const float *px2 = block2.GetPx() + first2;
+  const float *py2 = block2.GetPy() + first2;
+  const float *pz2 = block2.GetPz() + first2;
+  for (unsigned int i2 = 0; i2 < nPartners; ++i2) {
+    const double e2 = std::sqrt(
+        (double) px2[i2] * px2[i2] + (double) py2[i2] * py2[i2]
+            + (double) pz2[i2] * pz2[i2] + (double) mass2 * mass2);
+    const double sx = px1 + px2[i2];
+    const double sy = py1 + py2[i2];
+    const double sz = pz1 + pz2[i2];
+    const double se = e1 + e2;
+    const double dx = px1 - px2[i2];
+    const double dy = py1 - py2[i2];
+    const double dz = pz1 - pz2[i2];
+    const double de = e1 - e2;
+    const double PP = se * se - sx * sx - sy * sy - sz * sz;
+    const double qq = de * de - dx * dx - dy * dy - dz * dz;
+    //k2 can only be negative by rounding for k* ~ 0
+    const double k2 = qP * qP / PP - qq;
+    relK[i2] = 0.5 * std::sqrt(std::fabs(k2));
+    kT[i2] = 0.5 * std::sqrt(sx * sx + sy * sy);
+  }
+
+  if (!doCPR) {
+    return nPartners;
+  }
+  const float twoPi = 2.f * piHi;
+  const float maxDist = fDeltaPhiEtaMax;
+  const int nPart1 = block1.GetNParticles();
+  const int maxRadii2 = block2.GetMaxRadii();
+  const int *nTracks2 = block2.GetNTracks() + first2;
+  const int nTracks1 = block1.GetNTracks()[iPart1];
+  for (int iTrack1 = 0; iTrack1 < nTracks1; ++iTrack1) {
+    const int index1 = iTrack1 * nPart1 + iPart1;
+    const float eta1 = block1.GetEta()[index1];
+    const int nRad1 = block1.GetNRadii()[index1];
+    for (int iTrack2 = 0; iTrack2 < (int) block2.GetMaxTracks(); ++iTrack2) {
+      const int index2 = iTrack2 * nPart2 + first2;
+      const float *eta2 = block2.GetEta() + index2;
+      const int *nRadii2 = block2.GetNRadii() + index2;
+      for (int iRad = 0; iRad < nRad1 && iRad < maxRadii2; ++iRad) {
+        const float phiStar1 = block1.GetPhiStar()[(iTrack1
+            * block1.GetMaxRadii() + iRad) * nPart1 + iPart1];
+        const float *phiStar2 = block2.GetPhiStar()
+            + (iTrack2 * maxRadii2 + iRad) * nPart2 + first2;
+        //Partners with less tracks or radii are masked out, the pair is
+        //rejected if any of the track pairs is too close at any radius.
+        for (unsigned int i2 = 0; i2 < nPartners; ++i2) {
+          const float deta = eta1 - eta2[i2];
+          //phi* is within [-3/2 pi, 3/2 pi], the distance in phi is folded
+          //to [0, pi] without comparisons to keep the loop vectorizable
+          float dphi = std::fabs(phiStar1 - phiStar2[i2]);
+          dphi = std::min(dphi, std::fabs(twoPi - dphi));
+          const float dist = dphi * dphi + deta * deta;
+          //Written as !(dist < maxDist) such that a NaN phi* (ASin of
+          //low pT tracks at the outer radii) keeps the pair, as in
+          //PassesPairSelection
+          mask[i2] &= !(dist < maxDist) | (iTrack2 >= nTracks2[i2])
+              | (iRad >= nRadii2[i2]);
+        }
+      }
+    }
+  }
+  return nPartners;
+}
+
+bool AliFemtoDreamHigherPairMath::UsePairKernel(int iHC) {
+  if (!fWhichPairs.at(iHC)) {
+    return true;
+  }
+  return !(fHists->GetEtaPhiPlots() || fHists->GetDodPhidEtaPlots()
+      || fHists->GetObtainMomentumResolution() || fHists->GetDoMassQA());
+}
+
+void AliFemtoDreamHigherPairMath::FillSameEventBlock(
+    int iHC, int Mult, float cent, const AliFemtoDreamPartBlock &block1,
+    unsigned int iPart1, float mass1, const AliFemtoDreamPartBlock &block2,
+    unsigned int first2, float mass2, bool doCPR) {
+  FillBlock(iHC, Mult, cent, block1, iPart1, mass1, block2, first2, mass2,
+            doCPR, true);
+}
+
+void AliFemtoDreamHigherPairMath::FillMixedEventBlock(
+    int iHC, int Mult, float cent, const AliFemtoDreamPartBlock &block1,
+    unsigned int iPart1, float mass1, const AliFemtoDreamPartBlock &block2,
+    float mass2, bool doCPR) {
+  FillBlock(iHC, Mult, cent, block1, iPart1, mass1, block2, 0, mass2, doCPR,
+            false);
+}
+
+void AliFemtoDreamHigherPairMath::FillBlock(
+    int iHC, int Mult, float cent, const AliFemtoDreamPartBlock &block1,
+    unsigned int iPart1, float mass1, const AliFemtoDreamPartBlock &block2,
+    unsigned int first2, float mass2, bool doCPR, bool SEorME) {
+  //Fills the same distributions as FillSameEvent/FillMixedEvent for the
+  //pairs accepted by the kernel. The k* distribution is filled in one go,
+  //the differential ones pair by pair.
+  const unsigned int nPartners = PairKernel(block1, iPart1, mass1, block2,
+                                            first2, mass2, doCPR);
+  const int *mask = fKernelMask.data();
+  const float *relK = fKernelRelK.data();
+  fKernelPassRelK.resize(nPartners);
+  int nPass = 0;
+  for (unsigned int i2 = 0; i2 < nPartners; ++i2) {
+    fKernelPassRelK[nPass] = relK[i2];
+    nPass += mask[i2];
+  }
+  if (nPass == 0) {
+    return;
+  }
+  if (SEorME) {
+    fHists->FillSameEventDist(iHC, nPass, fKernelPassRelK.data());
+  } else {
+    fHists->FillMixedEventDist(iHC, nPass, fKernelPassRelK.data());
+  }
+
+  const bool fillHists = fWhichPairs.at(iHC);
+  const bool doMult = fHists->GetDoMultBinning();
+  const bool doCent = fillHists && fHists->GetDoCentBinning();
+  const bool dokT = fillHists && fHists->GetDokTBinning();
+  const bool domT = fillHists && fHists->GetDomTBinning();
+  const bool dokTandMult = fillHists && fHists->GetDokTandMultBinning();
+  const bool doPtQA = fillHists && fHists->GetDoPtQA();
+  if (!(doMult || doCent || dokT || domT || dokTandMult || doPtQA)) {
+    return;
+  }
+  const float *kT = fKernelkT.data();
+  const float avgMass = 0.5 * (mass1 + mass2);
+  const float pt1 = std::sqrt(
+      block1.GetPx()[iPart1] * block1.GetPx()[iPart1]
+          + block1.GetPy()[iPart1] * block1.GetPy()[iPart1]);
+  const float *px2 = block2.GetPx() + first2;
+  const float *py2 = block2.GetPy() + first2;
+  for (unsigned int i2 = 0; i2 < nPartners; ++i2) {
+    if (!mask[i2]) {
+      continue;
+    }
+    const float RelativeK = relK[i2];
+    const float mT = std::sqrt(kT[i2] * kT[i2] + avgMass * avgMass);
+    const float pt2 = std::sqrt(px2[i2] * px2[i2] + py2[i2] * py2[i2]);
+    if (SEorME) {
+      if (doMult) {
+        fHists->FillSameEventMultDist(iHC, Mult + 1, RelativeK);
+      }
+      if (doCent) {
+        fHists->FillSameEventCentDist(iHC, cent, RelativeK);
+      }
+      if (dokT) {
+        fHists->FillSameEventkTDist(iHC, kT[i2], RelativeK, cent);
+      }
+      if (domT) {
+        fHists->FillSameEventmTDist(iHC, mT, RelativeK);
+      }
+      if (dokTandMult) {
+        fHists->FillSameEventkTandMultDist(iHC, kT[i2], RelativeK, Mult + 1);
+      }
+      if (doPtQA) {
+        fHists->FillPtQADist(iHC, RelativeK, pt1, pt2);
+        fHists->FillPtSEOneQADist(iHC, pt1, Mult + 1);
+        fHists->FillPtSETwoQADist(iHC, pt2, Mult + 1);
+      }
+    } else {
+      if (doMult) {
+        fHists->FillMixedEventMultDist(iHC, Mult + 1, RelativeK);
+      }
+      if (doCent) {
+        fHists->FillMixedEventCentDist(iHC, cent, RelativeK);
+      }
+      if (dokT) {
+        fHists->FillMixedEventkTDist(iHC, kT[i2], RelativeK, cent);
+      }
+      if (domT) {
+        fHists->FillMixedEventmTDist(iHC, mT, RelativeK);
+      }
+      if (dokTandMult) {
+        fHists->FillMixedEventkTandMultDist(iHC, kT[i2], RelativeK, Mult + 1);
+      }
+      if (doPtQA) {
+        fHists->FillPtMEOneQADist(iHC, pt1, Mult + 1);
+        fHists->FillPtMETwoQADist(iHC, pt2, Mult + 1);
+      }
+    }
+  }
+}
+
 float AliFemtoDreamHigherPairMath::FillSameEvent(int iHC, int Mult, float cent,
                                                  TVector3 Part1Momentum,
                                                  int PDGPart1,
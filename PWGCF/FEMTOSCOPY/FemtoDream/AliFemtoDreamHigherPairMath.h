@@ -13,6 +13,7 @@
 #include "AliFemtoDreamBasePart.h"
 #include "AliFemtoDreamCollConfig.h"
 #include "AliFemtoDreamCorrHists.h"
+#include "AliFemtoDreamPartBlock.h"
 #include <vector>
 class AliFemtoDreamHigherPairMath {
  public:
@@ -33,6 +34,35 @@ class AliFemtoDreamHigherPairMath {
   bool PassesPairSelection(AliFemtoDreamBasePart& part1,
                            AliFemtoDreamBasePart& part2, bool Recalculate);
   void RecalculatePhiStar(AliFemtoDreamBasePart &part);
+  //Pairs particle iPart1 of block1 with the particles first2 ... end of
+  //block2 at once. The pair mask (close pair rejection, if doCPR) and k* of
+  //all the partners are stored in flat arrays, the number of partners is
+  //returned.
+  unsigned int PairKernel(const AliFemtoDreamPartBlock &block1,
+                          unsigned int iPart1, float mass1,
+                          const AliFemtoDreamPartBlock &block2,
+                          unsigned int first2, float mass2, bool doCPR);
+  const int *GetKernelMask() const {
+    return fKernelMask.data();
+  }
+  ;
+  const float *GetKernelRelK() const {
+    return fKernelRelK.data();
+  }
+  ;
+  //The block pairing can only be used if no QA requiring the particle objects
+  //is requested for this pair
+  bool UsePairKernel(int iHC);
+  void FillSameEventBlock(int iHC, int Mult, float cent,
+                          const AliFemtoDreamPartBlock &block1,
+                          unsigned int iPart1, float mass1,
+                          const AliFemtoDreamPartBlock &block2,
+                          unsigned int first2, float mass2, bool doCPR);
+  void FillMixedEventBlock(int iHC, int Mult, float cent,
+                           const AliFemtoDreamPartBlock &block1,
+                           unsigned int iPart1, float mass1,
+                           const AliFemtoDreamPartBlock &block2,
+                           float mass2, bool doCPR);
   float FillSameEvent(int iHC, int Mult, float cent, TVector3 Part1Momentum,
                       int PDGPart1, TVector3 Part2Momentum, int PDGPart2);
   void MassQA(int iHC, float RelK, AliFemtoDreamBasePart &part1,
@@ -88,12 +118,20 @@ class AliFemtoDreamHigherPairMath {
   void DeltaEtaDeltaPhi(int Hist, AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2, bool SEorME, float relk,
                         bool recalculate);
+  void FillBlock(int iHC, int Mult, float cent,
+                 const AliFemtoDreamPartBlock &block1, unsigned int iPart1,
+                 float mass1, const AliFemtoDreamPartBlock &block2,
+                 unsigned int first2, float mass2, bool doCPR, bool SEorME);
   AliFemtoDreamCorrHists *fHists;
   std::vector<unsigned int> fWhichPairs;
   float fBField;
   float fDeltaPhiEtaMax;
   TRandom3 fRandom;
   double fPi;
+  std::vector<int> fKernelMask;
+  std::vector<float> fKernelRelK;
+  std::vector<float> fKernelkT;
+  std::vector<double> fKernelPassRelK;
 
 };
 
@@ -0,0 +1,80 @@
+/*
+ * AliFemtoDreamPartBlock.cxx
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "AliFemtoDreamPartBlock.h"
+ClassImp(AliFemtoDreamPartBlock)
+AliFemtoDreamPartBlock::AliFemtoDreamPartBlock()
+    : fNParticles(0),
+      fMaxTracks(0),
+      fMaxRadii(0),
+      fPx(),
+      fPy(),
+      fPz(),
+      fCharge(),
+      fPDGCode(),
+      fNTracks(),
+      fEta(),
+      fNRadii(),
+      fPhiStar() {
+}
+
+AliFemtoDreamPartBlock::~AliFemtoDreamPartBlock() {
+}
+
+void AliFemtoDreamPartBlock::SetParticles(
+    const std::vector<AliFemtoDreamBasePart> &Particles) {
+  //The arrays are only resized, the memory of the previous event is reused.
+  //Eta of the tracks is taken as in the close pair rejection: eta of the
+  //particle for single tracks, eta of the daughters (index + 1) for decays.
+  //The track arrays are ordered by particle in the innermost index, such that
+  //the values of consecutive pair partners are adjacent in memory.
+  fNParticles = Particles.size();
+  fMaxTracks = 1;
+  fMaxRadii = 1;
+  for (auto itPart = Particles.begin(); itPart != Particles.end(); ++itPart) {
+    const std::vector<std::vector<float>> &phiAtRad = itPart->fPhiAtRadius;
+    if (phiAtRad.size() > fMaxTracks) {
+      fMaxTracks = phiAtRad.size();
+    }
+    for (auto itTrack = phiAtRad.begin(); itTrack != phiAtRad.end();
+        ++itTrack) {
+      if (itTrack->size() > fMaxRadii) {
+        fMaxRadii = itTrack->size();
+      }
+    }
+  }
+  fPx.resize(fNParticles);
+  fPy.resize(fNParticles);
+  fPz.resize(fNParticles);
+  fCharge.resize(fNParticles);
+  fPDGCode.resize(fNParticles);
+  fNTracks.resize(fNParticles);
+  fEta.assign(fNParticles * fMaxTracks, 0.f);
+  fNRadii.assign(fNParticles * fMaxTracks, 0);
+  fPhiStar.assign(fNParticles * fMaxTracks * fMaxRadii, 0.f);
+
+  for (unsigned int iPart = 0; iPart < fNParticles; ++iPart) {
+    const AliFemtoDreamBasePart &part = Particles[iPart];
+    fPx[iPart] = part.fP.X();
+    fPy[iPart] = part.fP.Y();
+    fPz[iPart] = part.fP.Z();
+    fCharge[iPart] = part.fCharge.empty() ? 0 : part.fCharge[0];
+    fPDGCode[iPart] = part.fPDGCode;
+    const unsigned int nTracks = part.fPhiAtRadius.size();
+    fNTracks[iPart] = nTracks;
+    for (unsigned int iTrack = 0; iTrack < nTracks; ++iTrack) {
+      const unsigned int iEta = (nTracks == 1) ? 0 : iTrack + 1;
+      const unsigned int index = iTrack * fNParticles + iPart;
+      fEta[index] = (iEta < part.fEta.size()) ? part.fEta[iEta] : 0.f;
+      const std::vector<float> &phiStar = part.fPhiAtRadius[iTrack];
+      fNRadii[index] = phiStar.size();
+      for (unsigned int iRad = 0; iRad < phiStar.size(); ++iRad) {
+        fPhiStar[(iTrack * fMaxRadii + iRad) * fNParticles + iPart] =
+            phiStar[iRad];
+      }
+    }
+  }
+}
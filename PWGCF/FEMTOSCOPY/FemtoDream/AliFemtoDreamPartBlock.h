@@ -0,0 +1,97 @@
+/*
+ * AliFemtoDreamPartBlock.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef ALIFEMTODREAMPARTBLOCK_H_
+#define ALIFEMTODREAMPARTBLOCK_H_
+#include <vector>
+#include "Rtypes.h"
+
+#include "AliFemtoDreamBasePart.h"
+
+//Compact projection of the particles of one species in one event, containing
+//only what is needed for the pairing (momentum, charge, PDG code, eta and
+//phi* at the TPC radii of the tracks used in the close pair rejection).
+//The values are stored in flat arrays (one entry per particle, per track or
+//per track and radius), so that the pair loops can run over a whole block
+//without accessing the AliFemtoDreamBasePart objects.
+class AliFemtoDreamPartBlock {
+ public:
+  AliFemtoDreamPartBlock();
+  virtual ~AliFemtoDreamPartBlock();
+  void SetParticles(const std::vector<AliFemtoDreamBasePart> &Particles);
+  unsigned int GetNParticles() const {
+    return fNParticles;
+  }
+  ;
+  //Number of tracks per particle
+  unsigned int GetMaxTracks() const {
+    return fMaxTracks;
+  }
+  ;
+  //Number of radii per track
+  unsigned int GetMaxRadii() const {
+    return fMaxRadii;
+  }
+  ;
+  const float *GetPx() const {
+    return fPx.data();
+  }
+  ;
+  const float *GetPy() const {
+    return fPy.data();
+  }
+  ;
+  const float *GetPz() const {
+    return fPz.data();
+  }
+  ;
+  const int *GetCharge() const {
+    return fCharge.data();
+  }
+  ;
+  const int *GetPDGCode() const {
+    return fPDGCode.data();
+  }
+  ;
+  //Number of tracks with phi* of each particle (1 for tracks, daughters for decays)
+  const int *GetNTracks() const {
+    return fNTracks.data();
+  }
+  ;
+  //eta of the track iTrack of particle iPart at [iTrack * GetNParticles() + iPart]
+  const float *GetEta() const {
+    return fEta.data();
+  }
+  ;
+  //Number of radii with phi* of the track iTrack of particle iPart at [iTrack * GetNParticles() + iPart]
+  const int *GetNRadii() const {
+    return fNRadii.data();
+  }
+  ;
+  //phi* at [(iTrack * GetMaxRadii() + iRadius) * GetNParticles() + iPart]
+  const float *GetPhiStar() const {
+    return fPhiStar.data();
+  }
+  ;
+ private:
+  unsigned int fNParticles;
+  unsigned int fMaxTracks;
+  unsigned int fMaxRadii;
+  std::vector<float> fPx;
+  std::vector<float> fPy;
+  std::vector<float> fPz;
+  std::vector<int> fCharge;
+  std::vector<int> fPDGCode;
+  std::vector<int> fNTracks;
+  std::vector<float> fEta;
+  std::vector<int> fNRadii;
+  std::vector<float> fPhiStar;
+
+ClassDef(AliFemtoDreamPartBlock, 1)
+  ;
+};
+
+#endif /* ALIFEMTODREAMPARTBLOCK_H_ */
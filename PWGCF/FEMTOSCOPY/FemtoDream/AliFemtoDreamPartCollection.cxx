@@ -34,7 +34,8 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
       fZVtxMultBuffer(
           conf->GetNZVtxBins(),
           std::vector<AliFemtoDreamZVtxMultContainer>(
-              conf->GetNMultBins(), AliFemtoDreamZVtxMultContainer(conf))),
+              conf->GetNMultBins(),
+              AliFemtoDreamZVtxMultContainer(conf, fHigherMath))),
       fValuesZVtxBins(conf->GetZVtxBins()),
       fValuesMultBins(conf->GetMultBins()) {
 }
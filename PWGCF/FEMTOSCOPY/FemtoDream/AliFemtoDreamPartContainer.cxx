@@ -12,13 +12,24 @@
 ClassImp(AliFemtoDreamPartContainer)
 AliFemtoDreamPartContainer::AliFemtoDreamPartContainer()
     : fPartBuffer(),
-      fMixingDepth(0) {
+      fBlockBuffer(),
+      fBlock(),
+      fKeepParticles(true),
+      fMixingDepth(0),
+      fFirstEvent(0),
+      fNEvents(0) {
 
 }
 
-AliFemtoDreamPartContainer::AliFemtoDreamPartContainer(int MixingDepth)
-    : fPartBuffer(),
-      fMixingDepth(MixingDepth) {
+AliFemtoDreamPartContainer::AliFemtoDreamPartContainer(int MixingDepth,
+                                                       bool KeepParticles)
+    : fPartBuffer(KeepParticles ? MixingDepth : 0),
+      fBlockBuffer(KeepParticles ? 0 : MixingDepth),
+      fBlock(),
+      fKeepParticles(KeepParticles),
+      fMixingDepth(MixingDepth),
+      fFirstEvent(0),
+      fNEvents(0) {
 
 }
 
@@ -27,15 +38,12 @@ AliFemtoDreamPartContainer& AliFemtoDreamPartContainer::operator=(
   if (this == &obj) {
     return *this;
   }
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator copyIter;
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator objIter;
-//  for (objIter=obj.fPartBuffer.begin();objIter!=obj.fPartBuffer.end();
-//      ++objIter)
-//  {
-//
-//  }
   this->fMixingDepth = obj.fMixingDepth;
   this->fPartBuffer = obj.fPartBuffer;
+  this->fBlockBuffer = obj.fBlockBuffer;
+  this->fKeepParticles = obj.fKeepParticles;
+  this->fFirstEvent = obj.fFirstEvent;
+  this->fNEvents = obj.fNEvents;
   return (*this);
 }
 
@@ -44,31 +52,57 @@ AliFemtoDreamPartContainer::~AliFemtoDreamPartContainer() {
 
 void AliFemtoDreamPartContainer::SetEvent(
     std::vector<AliFemtoDreamBasePart> &Particles) {
-  if (!(fPartBuffer.size() < fMixingDepth)) {
-//    std::cout << "Popping Front" << std::endl;
-    fPartBuffer.pop_front();
+  if (fMixingDepth == 0) {
+    return;
+  }
+  unsigned int slot;
+  if (fNEvents < fMixingDepth) {
+    slot = Slot(fNEvents);
+    ++fNEvents;
+  } else {
+    //Buffer full, overwrite the oldest event
+    slot = fFirstEvent;
+    fFirstEvent = (fFirstEvent + 1) % fMixingDepth;
+  }
+  //the assignment reuses the memory of the overwritten event, the particles
+  //are copied since the caller keeps using them after the pairing
+  if (fKeepParticles) {
+    fPartBuffer[slot] = Particles;
+  } else {
+    fBlockBuffer[slot].SetParticles(Particles);
   }
-  fPartBuffer.push_back(Particles);
-//  std::cout << "PartBuffer Size: "<<fPartBuffer.size()<<'\t'<<"Input Size: "
-//      << Particles.size() << '\n';
   return;
 }
 
+const AliFemtoDreamPartBlock &AliFemtoDreamPartContainer::GetEventBlock(
+    int Depth) {
+  if (!fKeepParticles) {
+    return fBlockBuffer[Slot(Depth)];
+  }
+  fBlock.SetParticles(fPartBuffer[Slot(Depth)]);
+  return fBlock;
+}
+
 void AliFemtoDreamPartContainer::PrintLastEvent() {
-  for (std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt =
-      fPartBuffer.begin(); itEvt != fPartBuffer.end(); ++itEvt) {
-    std::cout << "Printing Last Event with size: " << itEvt->size() << '\n';
-    for (std::vector<AliFemtoDreamBasePart>::iterator itPart = itEvt->begin();
-        itPart != itEvt->end(); ++itPart) {
+  for (unsigned int iDepth = 0; iDepth < fNEvents; ++iDepth) {
+    if (!fKeepParticles) {
+      const AliFemtoDreamPartBlock &block = GetEventBlock(iDepth);
+      std::cout << "Printing Last Event with size: " << block.GetNParticles()
+                << '\n';
+      for (unsigned int iPart = 0; iPart < block.GetNParticles(); ++iPart) {
+        std::cout << "Px: " << block.GetPx()[iPart] << '\t' << "Py: "
+                  << block.GetPy()[iPart] << '\t' << "Pz: "
+                  << block.GetPz()[iPart] << std::endl;
+      }
+      continue;
+    }
+    std::vector<AliFemtoDreamBasePart> &evt = GetEvent(iDepth);
+    std::cout << "Printing Last Event with size: " << evt.size() << '\n';
+    for (std::vector<AliFemtoDreamBasePart>::iterator itPart = evt.begin();
+        itPart != evt.end(); ++itPart) {
       TVector3 P(itPart->GetMomentum());
       std::cout << "Px: " << P.X() << '\t' << "Py: " << P.Y() << '\t' << "Pz: "
                 << P.Z() << std::endl;
     }
   }
 }
-std::vector<AliFemtoDreamBasePart> &AliFemtoDreamPartContainer::GetEvent(
-    int Depth) {
-  std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt = fPartBuffer
-      .begin() + Depth;
-  return *itEvt;
-}
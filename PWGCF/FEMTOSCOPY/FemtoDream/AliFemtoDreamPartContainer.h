@@ -7,35 +7,53 @@
 
 #ifndef ALIFEMTODREAMPARTCONTAINER_H_
 #define ALIFEMTODREAMPARTCONTAINER_H_
-#include <deque>
 #include <vector>
 #include "Rtypes.h"
 
 #include "AliFemtoDreamBasePart.h"
+#include "AliFemtoDreamPartBlock.h"
 
 //Class Containing the Particles from previous Events up to a certain mixing
 //depth for one Particle Species and Mult/ZVtx Bin
 //ZVtx bin.
+//The events are stored in a ring buffer of fMixingDepth slots, a new event
+//overwrites the oldest one reusing its memory. Each event is stored once:
+//as the particles if any pairing of the species needs the particle objects
+//(KeepParticles), otherwise only as the compact projection used in the pair
+//kernel.
 class AliFemtoDreamPartContainer {
  public:
   AliFemtoDreamPartContainer();
-  AliFemtoDreamPartContainer(int MixingDepth);
+  AliFemtoDreamPartContainer(int MixingDepth, bool KeepParticles = true);
   AliFemtoDreamPartContainer& operator=(const AliFemtoDreamPartContainer& obj);
   virtual ~AliFemtoDreamPartContainer();
   void PrintLastEvent();
   void SetEvent(std::vector<AliFemtoDreamBasePart> &Particles);
-  std::deque<std::vector<AliFemtoDreamBasePart>> GetEventBuffer() const {
-    return fPartBuffer;
+  //Depth 0 is the oldest stored event, the returned reference stays valid
+  //until the event is overwritten. Only available if the particles are kept.
+  std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth) {
+    return fPartBuffer[Slot(Depth)];
   }
   ;
-  std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth);
+  //If the particles are kept the projection is built from them on demand,
+  //the returned reference stays valid until the next call.
+  const AliFemtoDreamPartBlock &GetEventBlock(int Depth);
   unsigned int GetMixingDepth() const {
-    return fPartBuffer.size();
+    return fNEvents;
   }
   ;
  private:
-  std::deque<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
-  unsigned int fMixingDepth;ClassDef(AliFemtoDreamPartContainer,2)
+  unsigned int Slot(int Depth) const {
+    return (fFirstEvent + Depth) % fMixingDepth;
+  }
+  ;
+  std::vector<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
+  std::vector<AliFemtoDreamPartBlock> fBlockBuffer;
+  AliFemtoDreamPartBlock fBlock;//!
+  bool fKeepParticles;
+  unsigned int fMixingDepth;
+  unsigned int fFirstEvent;
+  unsigned int fNEvents;ClassDef(AliFemtoDreamPartContainer,4)
   ;
 };
 
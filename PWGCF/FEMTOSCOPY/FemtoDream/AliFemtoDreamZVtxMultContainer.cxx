@@ -9,6 +9,7 @@
 #include "AliFemtoDreamZVtxMultContainer.h"
 #include "TLorentzVector.h"
 #include "TDatabasePDG.h"
+#include "TParticlePDG.h"
 #include "TVector2.h"
 
 ClassImp(AliFemtoDreamPartContainer)
@@ -20,13 +21,13 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDeltaPhiEtaMax(0.f),
-      fDoDeltaEtaDeltaPhiCut(false) {
+      fDoDeltaEtaDeltaPhiCut(false),
+      fEventBlocks() {
 }
 
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
-    AliFemtoDreamCollConfig *conf)
-    : fPartContainer(conf->GetNParticles(),
-                     AliFemtoDreamPartContainer(conf->GetMixingDepth())),
+    AliFemtoDreamCollConfig *conf, AliFemtoDreamHigherPairMath *HigherMath)
+    : fPartContainer(),
       fPDGParticleSpecies(conf->GetPDGCodes()),
       fWhichPairs(conf->GetWhichPairs()),
       fRejPairs(conf->GetClosePairRej()),
@@ -34,10 +35,32 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
       fDeltaPhiMax(conf->GetDeltaPhiMax()),
       fDeltaPhiEtaMax(
           fDeltaPhiMax * fDeltaPhiMax + fDeltaEtaMax * fDeltaEtaMax),
-      fDoDeltaEtaDeltaPhiCut(conf->GetDoDeltaEtaDeltaPhiCut()) {
+      fDoDeltaEtaDeltaPhiCut(conf->GetDoDeltaEtaDeltaPhiCut()),
+      fEventBlocks() {
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
   TDatabasePDG::Instance()->AddAntiParticle("anti-deuteron", -1000010020);
+  //The mixing pool of a species keeps the particles only if one of its mixed
+  //event pairings does not run in the pair kernel, otherwise it keeps only
+  //their compact projection.
+  const unsigned int nSpecies = conf->GetNParticles();
+  std::vector<bool> keepParticles(nSpecies, false);
+  int HistCounter = 0;
+  for (unsigned int iSpec1 = 0; iSpec1 < nSpecies; ++iSpec1) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < nSpecies; ++iSpec2) {
+      if (!HigherMath->UsePairKernel(HistCounter)
+          || GetMass(fPDGParticleSpecies[iSpec1]) < 0
+          || GetMass(fPDGParticleSpecies[iSpec2]) < 0) {
+        keepParticles[iSpec2] = true;
+      }
+      ++HistCounter;
+    }
+  }
+  for (unsigned int iSpec = 0; iSpec < nSpecies; ++iSpec) {
+    fPartContainer.push_back(
+        AliFemtoDreamPartContainer(conf->GetMixingDepth(),
+                                   keepParticles[iSpec]));
+  }
 }
 
 AliFemtoDreamZVtxMultContainer::~AliFemtoDreamZVtxMultContainer() {
@@ -67,11 +90,30 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
   }
   //  }
 }
+void AliFemtoDreamZVtxMultContainer::SetEventBlocks(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles) {
+  //Compact copy of the particles of the current event used by the pair
+  //kernel, the memory of the blocks is reused from event to event.
+  fEventBlocks.resize(Particles.size());
+  for (unsigned int iSpec = 0; iSpec < Particles.size(); ++iSpec) {
+    fEventBlocks[iSpec].SetParticles(Particles[iSpec]);
+  }
+}
+
+float AliFemtoDreamZVtxMultContainer::GetMass(int PDGCode) const {
+  //Returns -1 for unknown PDG codes, such pairs go through the pairing
+  //of the particle objects, which reports the invalid PDG code.
+  TParticlePDG *part =
+      (PDGCode != 0) ? TDatabasePDG::Instance()->GetParticle(PDGCode) : nullptr;
+  return part ? part->Mass() : -1.f;
+}
+
 void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   float RelativeK = 0;
   int HistCounter = 0;
+  SetEventBlocks(Particles);
   //First loop over all the different Species
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
@@ -83,9 +125,28 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
                                     itSpec2->size());
       //Now loop over the actual Particles and correlate them
       bool CPR = fRejPairs.at(HistCounter);
+      const float mass1 = GetMass(*itPDGPar1);
+      const float mass2 = GetMass(*itPDGPar2);
+      if (HigherMath->UsePairKernel(HistCounter) && mass1 >= 0
+          && mass2 >= 0) {
+        //each particle is paired with all its partners at once
+        const AliFemtoDreamPartBlock &block1 = fEventBlocks[itSpec1
+            - Particles.begin()];
+        const AliFemtoDreamPartBlock &block2 = fEventBlocks[itSpec2
+            - Particles.begin()];
+        for (unsigned int iPart1 = 0; iPart1 < block1.GetNParticles();
+            ++iPart1) {
+          HigherMath->FillSameEventBlock(
+              HistCounter, iMult, cent, block1, iPart1, mass1, block2,
+              (itSpec1 == itSpec2) ? iPart1 + 1 : 0, mass2,
+              fDoDeltaEtaDeltaPhiCut && CPR);
+        }
+        ++HistCounter;
+        itPDGPar2++;
+        continue;
+      }
       for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
           ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
         std::vector<AliFemtoDreamBasePart>::iterator itPart2;
         if (itSpec1 == itSpec2) {
           itPart2 = itPart1 + 1;
@@ -93,7 +154,6 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
           itPart2 = itSpec2->begin();
         }
         while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
           // Delta eta - Delta phi* cut
           if (fDoDeltaEtaDeltaPhiCut && CPR) {
             if (!HigherMath->PassesPairSelection(*itPart1, *itPart2, false)) {
@@ -127,6 +187,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   float RelativeK = 0;
   int HistCounter = 0;
+  SetEventBlocks(Particles);
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
@@ -142,8 +203,31 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
                                              (int) itSpec2->GetMixingDepth());
       }
       bool CPR = fRejPairs.at(HistCounter);
+      const float mass1 = GetMass(*itPDGPar1);
+      const float mass2 = GetMass(*itPDGPar2);
+      if (HigherMath->UsePairKernel(HistCounter) && mass1 >= 0
+          && mass2 >= 0) {
+        //each particle is paired with all particles of a stored event at once
+        const AliFemtoDreamPartBlock &block1 = fEventBlocks[SkipPart];
+        for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth();
+            ++iDepth) {
+          const AliFemtoDreamPartBlock &block2 = itSpec2->GetEventBlock(
+              iDepth);
+          HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
+                                        block2.GetNParticles());
+          for (unsigned int iPart1 = 0; iPart1 < block1.GetNParticles();
+              ++iPart1) {
+            HigherMath->FillMixedEventBlock(HistCounter, iMult, cent, block1,
+                                            iPart1, mass1, block2, mass2,
+                                            fDoDeltaEtaDeltaPhiCut && CPR);
+          }
+        }
+        ++HistCounter;
+        ++itPDGPar2;
+        continue;
+      }
       for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
+        std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = itSpec2->GetEvent(
             iDepth);
         HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
                                       ParticlesOfEvent.size());
@@ -20,7 +20,8 @@
 class AliFemtoDreamZVtxMultContainer {
  public:
   AliFemtoDreamZVtxMultContainer();
-  AliFemtoDreamZVtxMultContainer(AliFemtoDreamCollConfig *conf);
+  AliFemtoDreamZVtxMultContainer(AliFemtoDreamCollConfig *conf,
+                                 AliFemtoDreamHigherPairMath *HigherMath);
   virtual ~AliFemtoDreamZVtxMultContainer();
   void PairParticlesSE(
       std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
@@ -41,6 +42,9 @@ class AliFemtoDreamZVtxMultContainer {
   }
   ;
  private:
+  void SetEventBlocks(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles);
+  float GetMass(int PDGCode) const;
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
@@ -49,6 +53,7 @@ class AliFemtoDreamZVtxMultContainer {
   float fDeltaPhiMax;
   float fDeltaPhiEtaMax;
   bool fDoDeltaEtaDeltaPhiCut;
+  std::vector<AliFemtoDreamPartBlock> fEventBlocks;//!
 
 ClassDef(AliFemtoDreamZVtxMultContainer, 4)
   ;
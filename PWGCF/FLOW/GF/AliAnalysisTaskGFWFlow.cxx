@@ -394,6 +394,9 @@ void AliAnalysisTaskGFWFlow::UserExec(Option_t*) {
     fGFW->Clear();
     AliAODTrack *lTrack;
     if(!fSelections[fCurrSystFlag]->AcceptVertex(fAOD,1)) return;
+    //Tracks are collected and filled to the GFW at once
+    vector<Double_t> lEtas, lPhis, lWeights;
+    vector<Int_t> lPtBins, lMasks;
     // mywatchFill.Start(kFALSE);
     for(Int_t lTr=0;lTr<fAOD->GetNumberOfTracks();lTr++) {
       lTrack = (AliAODTrack*)fAOD->GetTrack(lTr);
@@ -419,12 +422,17 @@ void AliAnalysisTaskGFWFlow::UserExec(Option_t*) {
       //Double_t nuaITS = fExtraWeights->GetWeight(lTrack->Phi(),lTrack->Eta(),vz,lTrack->Pt(),cent,0);
       //Double_t nue = fPtAxis->GetNbins()>1?1:fWeights->GetWeight(lTrack->Phi(),lTrack->Eta(),vz,cent,l_pT,1);
       if(fSelections[fCurrSystFlag]->AcceptTrack(lTrack, lDCA)) {
-      	if(WithinPtPOI) fGFW->Fill(lTrack->Eta(),fPtAxis->FindBin(l_pT)-1,lTrack->Phi(),nua*nue,1); //Fill POI (mask = 1)
-        if(WithinPtRF)  fGFW->Fill(lTrack->Eta(),fPtAxis->FindBin(l_pT)-1,lTrack->Phi(),nua*nue,2); //Fit RF (mask = 2)
+        //POI (mask = 1) and RF (mask = 2); each region only has one of the bits, so a track can be added once with both
+        lEtas.push_back(lTrack->Eta());
+        lPtBins.push_back(fPtAxis->FindBin(l_pT)-1);
+        lPhis.push_back(lTrack->Phi());
+        lWeights.push_back(nua*nue);
+        lMasks.push_back((WithinPtPOI?1:0)|(WithinPtRF?2:0));
       }
       /*if(fSelections[9]->AcceptTrack(lTrack, lDCA)) //No ITS for now
 	fGFW->Fill(lTrack->Eta(),fPtAxis->FindBin(lTrack->Pt())-1,lTrack->Phi(),nuaITS*nue,2);*/
     };
+    fGFW->Fill(lEtas.size(),lEtas.data(),lPtBins.data(),lPhis.data(),lWeights.data(),lMasks.data());
     // mywatchFill.Stop();
     TRandom rndm(0);
     Double_t rndmn=rndm.Rndm();
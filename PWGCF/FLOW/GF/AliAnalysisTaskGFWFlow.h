@@ -50,7 +50,7 @@ class AliAnalysisTaskGFWFlow : public AliAnalysisTaskSE {
   void SetWeightDir(const char *newval) { fWeightDir.Clear(); fWeightDir.Append(newval); };
   Bool_t SetInputWeightList(TList *inList);
   vector<AliGFW::CorrConfig> corrconfigs; //! do not store
-  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { return fGFW->GetCorrelatorConfig(desc,head,ptdif);};
+  AliGFW::CorrConfig GetConf(TString head, TString desc, Bool_t ptdif) { AliGFW::CorrConfig conf = fGFW->GetCorrelatorConfig(desc,head,ptdif); fGFW->AddCorrelator(conf); return conf; }; //Compiled once, evaluated from cached Q-vectors
   void CreateCorrConfigs();
   void SetTriggerType(AliVEvent::EOfflineTriggerTypes newval) { fTriggerType = newval; };
  protected:
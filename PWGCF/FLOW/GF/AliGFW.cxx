@@ -3,7 +3,10 @@
 need to add flags to have control over what is added, e.g. what happens, when I have several overlapping regions of different types: reference, pT-diff unID and pT-diff. ID?
 */
 AliGFW::AliGFW():
-  fInitialized(kFALSE)
+  fInitialized(kFALSE),
+  fMaxPtBins(1),
+  fStamp(0),
+  fQsChanged(kTRUE)
 {
 };
 
@@ -81,9 +84,14 @@ Int_t AliGFW::CreateRegions() {
       lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
     fCumulants.push_back(*lCumulant);
+    if(pItr->NpT>fMaxPtBins) fMaxPtBins=pItr->NpT;
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
+  //Compile the correlators added so far; the Q-vector cache is sized with the max. number of pT bins
+  fQFactorCache.resize(fQFactors.size()*fMaxPtBins);
+  fQFactorStamp.resize(fQFactors.size()*fMaxPtBins,0);
+  for(Int_t i=fCompiledCorrs.size();i<(Int_t)fCorrConfigs.size();i++) CompileCorrelator(i);
   return nRegions;
 };
 void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask) {
@@ -93,6 +101,33 @@ void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t
     if(fRegions.at(i).EtaMin<eta && fRegions.at(i).EtaMax>eta && (fRegions.at(i).BitMask&mask))
       fCumulants.at(i).FillArray(eta,ptin,phi,weight);
   };
+  fQsChanged=kTRUE;
+};
+void AliGFW::Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask) {
+  if(!fInitialized) CreateRegions();
+  if(!fInitialized) return;
+  //cos and sin of phi are only calculated once per track, the higher harmonics are obtained by recurrence in the cumulants
+  vector<Double_t> lCosPhi(nTracks), lSinPhi(nTracks);
+  for(Int_t i=0;i<nTracks;++i) {
+    lCosPhi[i] = TMath::Cos(phi[i]);
+    lSinPhi[i] = TMath::Sin(phi[i]);
+  };
+  vector<Int_t> lPt;
+  vector<Double_t> lCos, lSin, lW;
+  lPt.reserve(nTracks); lCos.reserve(nTracks); lSin.reserve(nTracks); lW.reserve(nTracks);
+  for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
+    const Region &lRegion = fRegions.at(i);
+    lPt.clear(); lCos.clear(); lSin.clear(); lW.clear();
+    for(Int_t j=0;j<nTracks;++j) {
+      if(!(lRegion.EtaMin<eta[j] && lRegion.EtaMax>eta[j] && (lRegion.BitMask&mask[j]))) continue;
+      lPt.push_back(ptin[j]);
+      lCos.push_back(lCosPhi[j]);
+      lSin.push_back(lSinPhi[j]);
+      lW.push_back(weight[j]);
+    };
+    if(lPt.size()) fCumulants.at(i).FillArray(lPt.size(),lPt.data(),lCos.data(),lSin.data(),lW.data());
+  };
+  fQsChanged=kTRUE;
 };
 TComplex AliGFW::TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant *r1, AliGFWCumulant *r2, AliGFWCumulant *r3) {
   TComplex part1 = r1->Vec(n1,p1,ptbin);
@@ -128,30 +163,35 @@ void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
   fCalculatedNames.clear();
   fCalculatedQs.clear();
+  fQsChanged=kTRUE;
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
     printf("Configuration empty!\n");
     return TComplex(0,0);
   };
-  TString tmp;
-  Ssiz_t sz1=0;
-  TComplex ret(1,0);
-  while(config.Tokenize(tmp,sz1,"}")) {
-    if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+  if(!fInitialized) CreateRegions();
+  if(!fInitialized) return TComplex(0,0);
+  //Each configuration string is parsed and compiled only once:
+  TString key(config);
+  if(SetHarmsToZero) key.Append("|0");
+  auto compiled = fCompiledStrings.find(key);
+  if(compiled==fCompiledStrings.end()) {
+    vector<Int_t> parts;
+    TString tmp;
+    Ssiz_t sz1=0;
+    while(config.Tokenize(tmp,sz1,"}")) {
+      if(SetHarmsToZero) SetHarmonicsToZero(tmp);
+      parts.push_back(CompileSingle(tmp));
+    };
+    compiled = fCompiledStrings.insert(std::make_pair(key,parts)).first;
   };
+  TComplex ret(1,0);
+  for(auto pItr = compiled->second.begin(); pItr!=compiled->second.end(); ++pItr)
+    ret*=(*pItr<0)?TComplex(0,0):EvaluatePart(*pItr,0);
   return ret;
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+Int_t AliGFW::CompileSingle(TString config) {
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
@@ -172,7 +212,7 @@ TComplex AliGFW::CalculateSingle(TString config) {
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return -1;
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -185,10 +225,12 @@ TComplex AliGFW::CalculateSingle(TString config) {
     };
     regs.push_back(ind);
   };
+  if(regs.size()==0) return -1;
   //Fetch harmonics
   while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  //Same as Calculate(poi,hars) and Calculate(poi,ref,hars,ptbin)
+  if(regs.size()==1) return CompilePart(regs.at(0),regs.at(0),kTRUE,kTRUE,0,hars);
+  return CompilePart(regs.at(0),regs.at(1),kTRUE,kTRUE,ptbin,hars);
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -255,6 +297,7 @@ TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin
   return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
 };
 TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+  if(corconf.Index>=0 && !DisableOverlap) return CalculateCompiled(corconf.Index,ptbin,SetHarmsToZero);
   if(corconf.Regs.size()==0) return TComplex(0,0);
   Int_t poi = corconf.Regs.at(0);
   Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
@@ -276,6 +319,157 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   return retval;
 };
 
+Int_t AliGFW::AddCorrelator(CorrConfig &corconf) {
+  corconf.Index = fCorrConfigs.size();
+  fCorrConfigs.push_back(corconf);
+  if(fInitialized) CompileCorrelator(corconf.Index);
+  return corconf.Index;
+};
+void AliGFW::CompileCorrelator(Int_t index) {
+  //Same structure as Calculate(CorrConfig,...): the first block is evaluated at the requested pT bin,
+  //the second one (if present) always at pT bin 0
+  CorrConfig &corconf = fCorrConfigs.at(index);
+  CompiledCorr lCorr;
+  lCorr.Poi = -1;
+  for(Int_t i=0;i<2;i++) for(Int_t j=0;j<2;j++) lCorr.Parts[i][j]=-1;
+  if(corconf.Regs.size()) {
+    lCorr.Poi = corconf.Regs.at(0);
+    for(Int_t lZero=0;lZero<2;lZero++) {
+      vector<Int_t> hars = corconf.Hars;
+      if(lZero) for(Int_t i=0;i<(Int_t)hars.size();i++) hars.at(i)=0;
+      Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
+      lCorr.Parts[lZero][0] = CompilePart(corconf.Regs.at(0),ref,kTRUE,kTRUE,-1,hars);
+      if(corconf.Regs2.size()==0) continue;
+      hars = corconf.Hars2;
+      if(lZero) for(Int_t i=0;i<(Int_t)hars.size();i++) hars.at(i)=0;
+      ref = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
+      lCorr.Parts[lZero][1] = CompilePart(corconf.Regs2.at(0),ref,kTRUE,kFALSE,0,hars);
+    };
+  };
+  fCompiledCorrs.push_back(lCorr);
+};
+Int_t AliGFW::CompilePart(Int_t poi, Int_t ref, Bool_t overlap, Bool_t ptdif, Int_t ptbin, vector<Int_t> hars) {
+  //Expands RecursiveCorr into a sum of products of Q-vectors. Identical products are merged,
+  //so that e.g. the many equivalent terms of v_n{8} are only evaluated once
+  std::map<vector<Int_t>, Double_t> terms;
+  if(hars.size()) ExpandCorr(poi,ref,overlap,ptdif,hars,vector<Int_t>{},1.,vector<Int_t>{},terms);
+  CompiledPart lPart;
+  lPart.FirstTerm = fTerms.size();
+  lPart.PtBin = ptbin;
+  for(auto tItr = terms.begin(); tItr!=terms.end(); ++tItr) {
+    if(tItr->second==0) continue;
+    CompiledTerm lTerm;
+    lTerm.Coef = tItr->second;
+    lTerm.FirstFactor = fTermFactors.size();
+    lTerm.NFactors = tItr->first.size();
+    fTermFactors.insert(fTermFactors.end(),tItr->first.begin(),tItr->first.end());
+    fTerms.push_back(lTerm);
+  };
+  lPart.NTerms = fTerms.size()-lPart.FirstTerm;
+  fParts.push_back(lPart);
+  fQFactorCache.resize(fQFactors.size()*fMaxPtBins);
+  fQFactorStamp.resize(fQFactors.size()*fMaxPtBins,0);
+  return fParts.size()-1;
+};
+void AliGFW::ExpandCorr(Int_t poi, Int_t ref, Bool_t overlap, Bool_t ptdif, vector<Int_t> hars, vector<Int_t> pows, Double_t coef, vector<Int_t> factors, std::map<vector<Int_t>, Double_t> &terms) {
+  //Follows RecursiveCorr term by term; factors are the Q-vectors the result is multiplied with
+  if(pows.size()==0)
+    for(Int_t i=0; i<(Int_t)hars.size(); i++)
+      pows.push_back(1);
+  if(hars.size()<3) {
+    vector<Int_t> lfactors = factors;
+    lfactors.push_back(GetQFactorIndex(poi,hars.at(0),pows.at(0),ptdif));
+    if(hars.size()==2) { //TwoRec
+      lfactors.push_back(GetQFactorIndex(ref,hars.at(1),pows.at(1),ptdif));
+      if(overlap) {
+        factors.push_back(GetQFactorIndex(poi,hars.at(0)+hars.at(1),pows.at(0)+pows.at(1),ptdif));
+        std::sort(factors.begin(),factors.end());
+        terms[factors]-=coef;
+      };
+    };
+    std::sort(lfactors.begin(),lfactors.end());
+    terms[lfactors]+=coef;
+    return;
+  };
+  Int_t harlast=hars.at(hars.size()-1);
+  Int_t powlast=pows.at(pows.size()-1);
+  hars.erase(hars.end()-1);
+  pows.erase(pows.end()-1);
+  vector<Int_t> lfactors = factors;
+  lfactors.push_back(GetQFactorIndex(ref,harlast,powlast,kFALSE));
+  ExpandCorr(poi,ref,overlap,ptdif,hars,pows,coef,lfactors,terms);
+  for(Int_t i=0;i<(Int_t)hars.size();i++) {
+    vector<Int_t> lhars = hars;
+    vector<Int_t> lpows = pows;
+    lhars.at(i)+=harlast;
+    lpows.at(i)+=powlast;
+    ExpandCorr(poi,ref,overlap,ptdif,lhars,lpows,-coef,factors,terms);
+  };
+};
+Int_t AliGFW::GetQFactorIndex(Int_t cum, Int_t har, Int_t pow, Bool_t ptdif) {
+  //Regions with a single pT bin always return pT bin 0, so no need to distinguish them
+  if(fRegions.at(cum).NpT<2) ptdif=kFALSE;
+  for(Int_t i=0;i<(Int_t)fQFactors.size();i++)
+    if(fQFactors.at(i).Cum==cum && fQFactors.at(i).Har==har && fQFactors.at(i).Pow==pow && fQFactors.at(i).PtDif==ptdif) return i;
+  QFactor lFactor;
+  lFactor.Cum = cum;
+  lFactor.Har = har;
+  lFactor.Pow = pow;
+  lFactor.PtDif = ptdif;
+  fQFactors.push_back(lFactor);
+  return fQFactors.size()-1;
+};
+const TComplex &AliGFW::GetQFactor(Int_t factor, Int_t ptbin) {
+  const QFactor &lFactor = fQFactors[factor];
+  if(!lFactor.PtDif || ptbin<0 || ptbin>=fMaxPtBins) ptbin=0;
+  Int_t ind = factor*fMaxPtBins+ptbin;
+  if(fQFactorStamp[ind]!=fStamp) {
+    fQFactorCache[ind] = fCumulants[lFactor.Cum].Vec(lFactor.Har,lFactor.Pow,ptbin);
+    fQFactorStamp[ind] = fStamp;
+  };
+  return fQFactorCache[ind];
+};
+TComplex AliGFW::EvaluatePart(Int_t part, Int_t ptbin) {
+  //Invalidate the cached Q-vectors if anything was filled since the last evaluation
+  if(fQsChanged) {
+    ++fStamp;
+    if(fStamp==0) { //wrapped around, reset stamps
+      std::fill(fQFactorStamp.begin(),fQFactorStamp.end(),0);
+      fStamp=1;
+    };
+    fQsChanged=kFALSE;
+  };
+  const CompiledPart &lPart = fParts[part];
+  if(lPart.PtBin>=0) ptbin=lPart.PtBin;
+  Double_t lRe=0, lIm=0;
+  const Int_t lastTerm = lPart.FirstTerm+lPart.NTerms;
+  for(Int_t t=lPart.FirstTerm;t<lastTerm;t++) {
+    const CompiledTerm &lTerm = fTerms[t];
+    Double_t tRe=lTerm.Coef, tIm=0;
+    const Int_t *lFactors = &fTermFactors[lTerm.FirstFactor];
+    for(Int_t f=0;f<lTerm.NFactors;f++) {
+      const TComplex &q = GetQFactor(lFactors[f],ptbin);
+      Double_t qRe=q.Re(), qIm=q.Im();
+      Double_t nRe=tRe*qRe-tIm*qIm;
+      tIm=tRe*qIm+tIm*qRe;
+      tRe=nRe;
+    };
+    lRe+=tRe;
+    lIm+=tIm;
+  };
+  return TComplex(lRe,lIm);
+};
+TComplex AliGFW::CalculateCompiled(Int_t index, Int_t ptbin, Bool_t SetHarmsToZero) {
+  if(!fInitialized) CreateRegions();
+  if(index<0 || index>=(Int_t)fCompiledCorrs.size()) return TComplex(0,0);
+  const CompiledCorr &lCorr = fCompiledCorrs[index];
+  if(lCorr.Poi<0) return TComplex(0,0);
+  if(!fCumulants.at(lCorr.Poi).IsPtBinFilled(ptbin)) return TComplex(0,0);
+  const Int_t *lParts = lCorr.Parts[SetHarmsToZero?1:0];
+  TComplex retval = EvaluatePart(lParts[0],ptbin);
+  if(lParts[1]>=0) retval*=EvaluatePart(lParts[1],0);
+  return retval;
+};
 TComplex AliGFW::Calculate(Int_t poi, vector<Int_t> hars) {
   AliGFWCumulant *qpoi = &fCumulants.at(poi);
   return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -40,6 +41,7 @@ class AliGFW {
     vector<Int_t> Hars2 {};
     Bool_t pTDif=kFALSE;
     TString Head="";
+    Int_t Index=-1; //Index of the compiled correlator (see AddCorrelator), -1 if not compiled
   };
   AliGFW();
   ~AliGFW();
@@ -50,11 +52,15 @@ class AliGFW {
   void AddRegion(TString refName, Int_t lNhar, Int_t *lNparVec, Double_t lEtaMin, Double_t lEtaMax, Int_t lNpT=1, Int_t BitMask=1);
   Int_t CreateRegions();
   void Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask);
+  void Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask); //All tracks of an event at once
   void Clear();// { for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs(); };
   AliGFWCumulant GetCumulant(Int_t index) { return fCumulants.at(index); };
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
   TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  //Compiled correlators: the recursion is expanded once into a flat list of terms, evaluated for each event from the cached Q-vectors
+  Int_t AddCorrelator(CorrConfig &corconf); //Sets and returns corconf.Index; compiled in CreateRegions() (or right away, if regions already created)
+  TComplex CalculateCompiled(Int_t index, Int_t ptbin=0, Bool_t SetHarmsToZero=kFALSE);
  private:
   Bool_t fInitialized;
   void SplitRegions();
@@ -72,7 +78,42 @@ class AliGFW {
   TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
   TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
   //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  Int_t CompileSingle(TString config);
+  //Compilation of correlators into products of Q-vectors:
+  struct QFactor {
+    Int_t Cum, Har, Pow;
+    Bool_t PtDif; //Taken at the requested pT bin, otherwise at pT bin 0
+  };
+  struct CompiledTerm {
+    Double_t Coef;
+    Int_t FirstFactor, NFactors; //Range in fTermFactors
+  };
+  struct CompiledPart {
+    Int_t FirstTerm, NTerms; //Range in fTerms
+    Int_t PtBin; //Fixed pT bin (string configs); -1 if given at evaluation
+  };
+  struct CompiledCorr {
+    Int_t Poi; //POI region, used to check if the pT bin is filled
+    Int_t Parts[2][2]; //[harmonics set to zero][first/second region block], -1 if not present
+  };
+  vector<CorrConfig> fCorrConfigs; //! Correlators added with AddCorrelator
+  vector<CompiledCorr> fCompiledCorrs; //!
+  vector<QFactor> fQFactors; //! Distinct Q-vectors used by all the compiled correlators
+  vector<CompiledTerm> fTerms; //!
+  vector<Int_t> fTermFactors; //! Q-vector indices of all the terms
+  vector<CompiledPart> fParts; //!
+  std::map<TString, vector<Int_t> > fCompiledStrings; //! String configs -> compiled parts
+  Int_t fMaxPtBins; //!
+  vector<TComplex> fQFactorCache; //! Q-vectors of the current event, [factor*fMaxPtBins + ptbin]
+  vector<UInt_t> fQFactorStamp; //! Event stamp of the cached Q-vectors
+  UInt_t fStamp; //!
+  Bool_t fQsChanged; //! Q-vectors filled since the last evaluation
+  void CompileCorrelator(Int_t index);
+  Int_t CompilePart(Int_t poi, Int_t ref, Bool_t overlap, Bool_t ptdif, Int_t ptbin, vector<Int_t> hars);
+  void ExpandCorr(Int_t poi, Int_t ref, Bool_t overlap, Bool_t ptdif, vector<Int_t> hars, vector<Int_t> pows, Double_t coef, vector<Int_t> factors, std::map<vector<Int_t>, Double_t> &terms);
+  Int_t GetQFactorIndex(Int_t cum, Int_t har, Int_t pow, Bool_t ptdif);
+  const TComplex &GetQFactor(Int_t factor, Int_t ptbin);
+  TComplex EvaluatePart(Int_t part, Int_t ptbin);
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
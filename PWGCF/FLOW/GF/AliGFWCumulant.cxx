@@ -35,6 +35,78 @@ void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t
   };
   Inc();
 };
+void AliGFWCumulant::FillArray(Int_t nTracks, const Int_t *ptin, const Double_t *cosPhi, const Double_t *sinPhi, const Double_t *weight) {
+  if(!fInitialized)
+    CreateComplexVectorArray(1,1,1);
+  //Tracks are processed in batches. For each batch, the harmonics are computed as cos/sin(n*phi) = (cos/sin((n-1)*phi)) * e^{i*phi}
+  //and the powers of the weights by multiplication, row by row, such that the inner loops run over the tracks
+  const Int_t lBatch = 64;
+  Int_t lMaxPow = 0;
+  for(Int_t lN=0; lN<fN; lN++) if(PW(lN)>lMaxPow) lMaxPow=PW(lN);
+  if(lMaxPow<1) return;
+  vector<Double_t> lCos(fN*lBatch), lSin(fN*lBatch), lWPow(lMaxPow*lBatch);
+  vector<Int_t> lPt(lBatch);
+  for(Int_t lFirst=0; lFirst<nTracks; lFirst+=lBatch) {
+    //Select the tracks (if one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill)
+    const Int_t lLast = TMath::Min(lFirst+lBatch, nTracks);
+    Int_t nb=0;
+    for(Int_t i=lFirst; i<lLast; i++) {
+      Int_t lPtBin = (fPt==1)?0:ptin[i];
+      if(lPtBin<0 || lPtBin>=fPt) continue;
+      lPt[nb] = lPtBin;
+      lCos[nb] = 1.;
+      lSin[nb] = 0.;
+      if(fN>1) {
+        lCos[lBatch+nb] = cosPhi[i];
+        lSin[lBatch+nb] = sinPhi[i];
+      };
+      lWPow[nb] = 1.;
+      if(lMaxPow>1) lWPow[lBatch+nb] = weight[i];
+      ++nb;
+    };
+    if(!nb) continue;
+    for(Int_t lN=2; lN<fN; lN++) {
+      Double_t *lC = &lCos[lN*lBatch], *lS = &lSin[lN*lBatch];
+      const Double_t *lCp = &lCos[(lN-1)*lBatch], *lSp = &lSin[(lN-1)*lBatch];
+      for(Int_t j=0; j<nb; j++) {
+        lC[j] = lCp[j]*lCos[lBatch+j] - lSp[j]*lSin[lBatch+j];
+        lS[j] = lSp[j]*lCos[lBatch+j] + lCp[j]*lSin[lBatch+j];
+      };
+    };
+    for(Int_t lPow=2; lPow<lMaxPow; lPow++)
+      for(Int_t j=0; j<nb; j++)
+        lWPow[lPow*lBatch+j] = lWPow[(lPow-1)*lBatch+j]*lWPow[lBatch+j];
+    if(fPt==1) {
+      //Single pT bin: the batch is summed up before adding to the Q-vectors
+      fFilledPts[0] = kTRUE;
+      for(Int_t lN=0; lN<fN; lN++) {
+        const Double_t *lC = &lCos[lN*lBatch], *lS = &lSin[lN*lBatch];
+        for(Int_t lPow=0; lPow<PW(lN); lPow++) {
+          const Double_t *lW = &lWPow[lPow*lBatch];
+          Double_t qcos=0, qsin=0;
+          for(Int_t j=0; j<nb; j++) {
+            qcos += lW[j]*lC[j];
+            qsin += lW[j]*lS[j];
+          };
+          fQvector[0][lN][lPow](fQvector[0][lN][lPow].Re()+qcos,fQvector[0][lN][lPow].Im()+qsin);
+        };
+      };
+    } else {
+      for(Int_t j=0; j<nb; j++) {
+        TComplex **lQ = fQvector[lPt[j]];
+        fFilledPts[lPt[j]] = kTRUE;
+        for(Int_t lN=0; lN<fN; lN++) {
+          const Double_t lC = lCos[lN*lBatch+j], lS = lSin[lN*lBatch+j];
+          for(Int_t lPow=0; lPow<PW(lN); lPow++) {
+            const Double_t lW = lWPow[lPow*lBatch+j];
+            lQ[lN][lPow](lQ[lN][lPow].Re()+lW*lC,lQ[lN][lPow].Im()+lW*lS);
+          };
+        };
+      };
+    };
+    fNEntries+=nb;
+  };
+};
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
   for(Int_t i=0; i<fPt; i++) {
@@ -11,6 +11,8 @@ class AliGFWCumulant {
   ~AliGFWCumulant();
   void ResetQs();
   void FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight=1);
+  //Fill nTracks at once, with cos(phi) and sin(phi) precomputed. Harmonics and powers are obtained by recurrence
+  void FillArray(Int_t nTracks, const Int_t *ptin, const Double_t *cosPhi, const Double_t *sinPhi, const Double_t *weight);
   enum UsedFlags_t {kBlank = 0, kFull=1, kPt=2};
   void SetType(UInt_t infl) { DestroyComplexVectorArray(); fUsed = infl; };
   void Inc() { fNEntries++; };
@@ -70,6 +70,9 @@ The names are available via the function PairClassName(Int_t i)
 #include "AliDielectronPairLegCuts.h"
 #include "AliDielectronV0Cuts.h"
 #include "AliDielectronPID.h"
+#include "AliDielectronVarCuts.h"
+#include "AliDielectronEventCuts.h"
+#include "AliDielectronCutGroup.h"
 #include "AliDielectronHistos.h"
 
 #include "AliDielectron.h"
@@ -364,6 +367,19 @@ void AliDielectron::Init()
     fQAmonitor->Init();
   }
 
+  // fill maps of the cuts and event variables used by the cuts and the mixing,
+  // completed with the variables needed to compute them
+  AddUsedVars(fEventFilter);
+  AddUsedVars(fTrackFilter);
+  AddUsedVars(fPairPreFilter1);
+  AddUsedVars(fPairPreFilter2);
+  AddUsedVars(fPairPreFilterLegs1);
+  AddUsedVars(fPairPreFilterLegs2);
+  AddUsedVars(fPairFilter);
+  AddUsedVars(fEventPlanePreFilter);
+  AddUsedVars(fEventPlanePOIPreFilter);
+  if (fMixing) fMixing->AddUsedVars(fUsedVars);
+
   if(fHistos) {
     (*fUsedVars)|= (*fHistos->GetUsedVars());
 
@@ -373,6 +389,45 @@ void AliDielectron::Init()
       fEvtVsTrkHist->SetHistogramList(fHistos);
     }
   }
+  AliDielectronVarManager::AddPrerequisites(fUsedVars,fLegEffMap,fPairEffMap);
+}
+
+//________________________________________________________________
+void AliDielectron::AddUsedVars(AliAnalysisFilter &filter)
+{
+  //
+  // Complete the fill maps of the cuts of the filter
+  //
+  TIter nextCut(filter.GetCuts());
+  while (TObject *cut = nextCut()) AddUsedVarsOfCut(cut);
+}
+
+//________________________________________________________________
+void AliDielectron::AddUsedVarsOfCut(TObject *cut)
+{
+  //
+  // Complete the fill map of the cut with the prerequisites of its variables.
+  // The event variables of the cut are filled with the event (SetEvent),
+  // they are added to the fill map of the event, tracks and pairs
+  //
+  TBits *usedVars=0x0;
+  if (cut->InheritsFrom(AliDielectronVarCuts::Class()))        usedVars=static_cast<AliDielectronVarCuts*>(cut)->GetUsedVars();
+  else if (cut->InheritsFrom(AliDielectronEventCuts::Class())) usedVars=static_cast<AliDielectronEventCuts*>(cut)->GetUsedVars();
+  else if (cut->InheritsFrom(AliDielectronPID::Class()))       usedVars=static_cast<AliDielectronPID*>(cut)->GetUsedVars();
+  else if (cut->InheritsFrom(AliDielectronCutGroup::Class())) {
+    TIter nextCut(static_cast<AliDielectronCutGroup*>(cut)->GetCuts());
+    while (TObject *groupCut = nextCut()) AddUsedVarsOfCut(groupCut);
+  }
+  else if (cut->InheritsFrom(AliDielectronPairLegCuts::Class())) {
+    AddUsedVars(static_cast<AliDielectronPairLegCuts*>(cut)->GetLeg1Filter());
+    AddUsedVars(static_cast<AliDielectronPairLegCuts*>(cut)->GetLeg2Filter());
+  }
+  if (!usedVars || !usedVars->CountBits()) return;
+
+  AliDielectronVarManager::AddPrerequisites(usedVars,fLegEffMap,fPairEffMap);
+  for (UInt_t var=AliDielectronVarManager::kPairMax; var<AliDielectronVarManager::kNMaxValues; ++var) {
+    if (usedVars->TestBitNumber(var)) fUsedVars->SetBitNumber(var,kTRUE);
+  }
 }
 
 //________________________________________________________________
@@ -296,6 +296,8 @@ private:
 
   TObjArray* PairArray(Int_t i);
   TObject* InitEffMap(TString filename, TString generatedname, TString foundname);
+  void AddUsedVars(AliAnalysisFilter &filter);
+  void AddUsedVarsOfCut(TObject *cut);
 
   static const char* fgkTrackClassNames[4];   //Names for track arrays
   static const char* fgkPairClassNames[11];   //Names for pair arrays
@@ -40,6 +40,7 @@ public:
   virtual ~AliDielectronCutGroup();
   
   Int_t GetNCuts() const { return fCutGroupList.GetEntries(); }
+  const TList* GetCuts() const { return &fCutGroupList; }
   
   //Analysis cuts interface
   //
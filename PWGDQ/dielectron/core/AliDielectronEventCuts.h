@@ -62,6 +62,7 @@ public:
   void SetMinCorrCutFunction(TF1 *fun, UInt_t varx, UInt_t vary=0);
   void SetMaxCorrCutFunction(TF1 *fun, UInt_t varx, UInt_t vary=0);
 	void SetTimeRangeCut(Bool_t reqTimingRangeCut=kFALSE) {fRequireTimeRangeCut = reqTimingRangeCut;}
+  TBits *GetUsedVars() const { return fUsedVars; }
 
   //
   //Analysis cuts interface
@@ -463,6 +463,15 @@ void AliDielectronMixingHandler::Init(const AliDielectron *diele)
   AliDebug(10,values.Data());
 }
 
+//______________________________________________
+void AliDielectronMixingHandler::AddUsedVars(TBits *map) const
+{
+  //
+  // add the variables of the mixing bins to the fill map
+  //
+  for (Int_t i=0; i<fAxes.GetEntriesFast(); ++i) map->SetBitNumber(fEventCuts[i],kTRUE);
+}
+
 //______________________________________________
 Int_t AliDielectronMixingHandler::GetNumberOfBins() const
 {
@@ -62,6 +62,7 @@ public:
   Bool_t MixRemaining(AliDielectron *diele, Int_t ipool);
 
   void Init(const AliDielectron *diele=0x0);
+  void AddUsedVars(TBits *map) const;
   static void MoveToSameVertex(AliVTrack * const vtrack, const Double_t vFirst[3], const Double_t vMix[3]);
 
 private:
@@ -68,6 +68,7 @@ public:
 	       UInt_t pidBitType=AliDielectronPID::kRequire, Int_t var=-1);
 
   void SetDefaults(Int_t def);
+  TBits *GetUsedVars() const { return fUsedVars; }
 
   Int_t GetNCuts() { return fNcuts;}
   //
@@ -714,6 +714,51 @@ const char* AliDielectronVarManager::fgkParticleNames[AliDielectronVarManager::k
   {"LegSource",              "Leg source",                                         ""}
 };
 
+// variables computed from other variables: {variable, prerequisite}
+// the prerequisites are added to the fill maps by AddPrerequisites
+static const UInt_t kPrerequisites[][2] = {
+  {AliDielectronVarManager::kNFclsTPCfCross,          AliDielectronVarManager::kNFclsTPC},
+  {AliDielectronVarManager::kNFclsTPCfCross,          AliDielectronVarManager::kNFclsTPCr},
+  {AliDielectronVarManager::kNclsSFracTPC,            AliDielectronVarManager::kNclsSTPC},
+  {AliDielectronVarManager::kNclsSFracITS,            AliDielectronVarManager::kNclsITS},
+  {AliDielectronVarManager::kNclsSFracITS,            AliDielectronVarManager::kNclsSITS},
+  {AliDielectronVarManager::kTPCsignalNfrac,          AliDielectronVarManager::kTPCsignalN},
+  {AliDielectronVarManager::kTPCclsDiff,              AliDielectronVarManager::kTPCsignalN},
+  {AliDielectronVarManager::kImpactParXYsigma,        AliDielectronVarManager::kImpactParXY},
+  {AliDielectronVarManager::kImpactParZsigma,         AliDielectronVarManager::kImpactParZ},
+  {AliDielectronVarManager::kLogDCAXY,                AliDielectronVarManager::kImpactParXY},
+  {AliDielectronVarManager::kLogDCAZ,                 AliDielectronVarManager::kImpactParZ},
+  {AliDielectronVarManager::kOneOverLegEff,           AliDielectronVarManager::kLegEff},
+  {AliDielectronVarManager::kPairEff,                 AliDielectronVarManager::kLegEff},
+  {AliDielectronVarManager::kOneOverPairEff,          AliDielectronVarManager::kPairEff},
+  {AliDielectronVarManager::kOneOverPairEffSq,        AliDielectronVarManager::kPairEff},
+  {AliDielectronVarManager::kQnDeltaPhiTrackTPCrpH2,  AliDielectronVarManager::kQnTPCrpH2},
+  {AliDielectronVarManager::kQnDeltaPhiTrackV0CrpH2,  AliDielectronVarManager::kQnV0CrpH2},
+  {AliDielectronVarManager::kQnDeltaPhiTPCrpH2,       AliDielectronVarManager::kQnTPCrpH2},
+  {AliDielectronVarManager::kQnDeltaPhiV0ArpH2,       AliDielectronVarManager::kQnV0ArpH2},
+  {AliDielectronVarManager::kQnDeltaPhiV0CrpH2,       AliDielectronVarManager::kQnV0CrpH2},
+  {AliDielectronVarManager::kQnDeltaPhiV0rpH2,        AliDielectronVarManager::kQnV0rpH2},
+  {AliDielectronVarManager::kQnDeltaPhiSPDrpH2,       AliDielectronVarManager::kQnSPDrpH2},
+  {AliDielectronVarManager::kQnTPCrpH2FlowV2,         AliDielectronVarManager::kQnDeltaPhiTPCrpH2},
+  {AliDielectronVarManager::kQnV0ArpH2FlowV2,         AliDielectronVarManager::kQnDeltaPhiV0ArpH2},
+  {AliDielectronVarManager::kQnV0CrpH2FlowV2,         AliDielectronVarManager::kQnDeltaPhiV0CrpH2},
+  {AliDielectronVarManager::kQnV0rpH2FlowV2,          AliDielectronVarManager::kQnDeltaPhiV0rpH2},
+  {AliDielectronVarManager::kQnSPDrpH2FlowV2,         AliDielectronVarManager::kQnDeltaPhiSPDrpH2},
+  {AliDielectronVarManager::kQnTPCrpH2FlowSPV2,       AliDielectronVarManager::kQnTPCrpH2},
+  {AliDielectronVarManager::kQnV0ArpH2FlowSPV2,       AliDielectronVarManager::kQnV0AxH2},
+  {AliDielectronVarManager::kQnV0ArpH2FlowSPV2,       AliDielectronVarManager::kQnV0AyH2},
+  {AliDielectronVarManager::kQnV0CrpH2FlowSPV2,       AliDielectronVarManager::kQnV0CxH2},
+  {AliDielectronVarManager::kQnV0CrpH2FlowSPV2,       AliDielectronVarManager::kQnV0CyH2},
+  {AliDielectronVarManager::kQnV0rpH2FlowSPV2,        AliDielectronVarManager::kQnV0xH2},
+  {AliDielectronVarManager::kQnV0rpH2FlowSPV2,        AliDielectronVarManager::kQnV0yH2},
+  {AliDielectronVarManager::kQnSPDrpH2FlowSPV2,       AliDielectronVarManager::kQnSPDxH2},
+  {AliDielectronVarManager::kQnSPDrpH2FlowSPV2,       AliDielectronVarManager::kQnSPDyH2},
+  {AliDielectronVarManager::kPairPlaneMagInProZDC,    AliDielectronVarManager::kQnZDCCrpH1},
+  {AliDielectronVarManager::kNaccTrckltsCorr,         AliDielectronVarManager::kNaccTrcklts},
+  {AliDielectronVarManager::kNaccTrcklts10Corr,       AliDielectronVarManager::kNaccTrcklts10}
+};
+static const Int_t kNPrerequisites = sizeof(kPrerequisites)/sizeof(kPrerequisites[0]);
+
 AliPIDResponse* AliDielectronVarManager::fgPIDResponse      = 0x0;
 AliVEvent*      AliDielectronVarManager::fgEvent            = 0x0;
 AliEventplane*  AliDielectronVarManager::fgTPCEventPlane    = 0x0;
@@ -817,3 +862,48 @@ UInt_t AliDielectronVarManager::GetValueType(const char* valname) {
   }
   return -1;
 }
+
+//________________________________________________________________
+void AliDielectronVarManager::AddPrerequisites(TBits *map, const TObject *legEffMap, const TObject *pairEffMap)
+{
+  //
+  // Add to the fill map the variables needed to compute the requested ones:
+  // the inputs of the derived variables and the axes of the efficiency maps.
+  // To be called once, when the map of a cut or histogram class is complete
+  //
+  if (!map) return;
+
+  const TObject *effMaps[2]={legEffMap,pairEffMap};
+  const UInt_t effVars[2]={kLegEff,kPairEff};
+  for (Int_t iPass=0; iPass<2; ++iPass) {
+    // prerequisites of the derived variables, until no variable is added
+    Bool_t added=kTRUE;
+    while (added) {
+      added=kFALSE;
+      for (Int_t i=0; i<kNPrerequisites; ++i) {
+        if (map->TestBitNumber(kPrerequisites[i][0]) && !map->TestBitNumber(kPrerequisites[i][1])) {
+          map->SetBitNumber(kPrerequisites[i][1],kTRUE);
+          added=kTRUE;
+        }
+      }
+    }
+    if (iPass==1) break;
+
+    // axes of the requested efficiency maps
+    for (Int_t iMap=0; iMap<2; ++iMap) {
+      if (!effMaps[iMap] || !map->TestBitNumber(effVars[iMap])) continue;
+      if (effMaps[iMap]->InheritsFrom(THnBase::Class())) {
+        const THnBase *eff = static_cast<const THnBase*>(effMaps[iMap]);
+        for (Int_t idim=0; idim<eff->GetNdimensions(); ++idim) {
+          UInt_t var = GetValueType(eff->GetAxis(idim)->GetName());
+          if (var<kNMaxValues) map->SetBitNumber(var,kTRUE);
+        }
+      }
+      else if (effMaps[iMap]->IsA()==TSpline3::Class()) {
+        TH1 *hist = static_cast<const TSpline3*>(effMaps[iMap])->GetHistogram();
+        UInt_t var = hist ? GetValueType(hist->GetXaxis()->GetName()) : (UInt_t)kNMaxValues;
+        if (var<kNMaxValues) map->SetBitNumber(var,kTRUE);
+      }
+    }
+  }
+}
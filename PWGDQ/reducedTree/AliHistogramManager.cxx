@@ -49,7 +49,12 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlanReady(kFALSE),
+  fFillPlanHistos(),
+  fFillPlanRecords(),
+  fFillPlanAxisVars(),
+  fFillPlanClassStart()
 {
   //
   // Constructor
@@ -71,7 +76,12 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlanReady(kFALSE),
+  fFillPlanHistos(),
+  fFillPlanRecords(),
+  fFillPlanAxisVars(),
+  fFillPlanClassStart()
 {
   //
   // Constructor
@@ -131,6 +141,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  fFillPlanReady = kFALSE;
 }
 
 //_________________________________________________________________
@@ -155,6 +166,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     return;
   }
   TString hname = name;
+  fFillPlanReady = kFALSE;   // the fill plan is rebuilt at the next fill
   
   Int_t dimension = 1;
   if(varY>AliReducedVarManager::kNothing) dimension = 2;
@@ -297,6 +309,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     return;
   }
   TString hname = name;
+  fFillPlanReady = kFALSE;   // the fill plan is rebuilt at the next fill
   
   Int_t dimension = 1;
   if(varY>AliReducedVarManager::kNothing) dimension = 2;
@@ -442,6 +455,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     return;
   }
   TString hname = name;
+  fFillPlanReady = kFALSE;   // the fill plan is rebuilt at the next fill
   
   TString titleStr(title);
   TObjArray* arr=titleStr.Tokenize(";");
@@ -495,6 +509,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     return;
   }
   TString hname = name;
+  fFillPlanReady = kFALSE;   // the fill plan is rebuilt at the next fill
   
   TString titleStr(title);
   TObjArray* arr=titleStr.Tokenize(";");
@@ -623,149 +638,178 @@ THnF* AliHistogramManager::CreateHistogram( const Char_t* name, const Char_t* ti
 void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values) {
   //
   //  fill a class of histograms
+  //  NOTE: this requires a lookup of the class name for each call; in event loops the
+  //        handle returned by GetHistClassIndex() should be used instead
   //
+  if(!fFillPlanReady) BuildFillPlan();
   THashList* hList = (THashList*)fMainList.FindObject(className);
   if(!hList) {
     /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
     cout << "         Histogram list not filled" << endl; */
     return;
   }
-  if(!hList) {
-    return;
-  }
-    
-  TIter next(hList);
-  TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
+  FillHistClass((Int_t)hList->GetUniqueID(), values);
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassIndex(const Char_t* className) {
+  //
+  //  get the integer handle of a histogram class, to be used with FillHistClass(Int_t, Float_t*)
+  //  The handle is the position of the class in the main list, so it stays valid when classes or histograms
+  //  are added later. Returns -1 if the class does not exist.
+  //
+  if(!fFillPlanReady) BuildFillPlan();
+  TObject* hList = fMainList.FindObject(className);
+  if(!hList) return -1;
+  return (Int_t)hList->GetUniqueID();
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t classIndex, Float_t* values) {
+  //
+  //  fill a class of histograms using its handle from GetHistClassIndex()
+  //  The fill records of the class are swept linearly, with the variables already decoded
+  //
+  if(!fFillPlanReady) BuildFillPlan();
+  if(classIndex<0 || classIndex>=(Int_t)fFillPlanClassStart.size()-1) return;
+  
   Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
-  while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
-    uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
-    if(uid>0) {
-      varW = uid%(fNVars+1)-1;
-      if(varW==0) varW=AliReducedVarManager::kNothing;
-      uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
-      if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
+  const Int_t last = fFillPlanClassStart[classIndex+1];
+  for(Int_t ih=fFillPlanClassStart[classIndex]; ih<last; ++ih) {
+    TObject* h = fFillPlanHistos[ih];
+    const Int_t* rec = &fFillPlanRecords[ih*kNPlanFields];
+    const Int_t varX = rec[kPlanVarX];
+    const Int_t varY = rec[kPlanVarY];
+    const Int_t varZ = rec[kPlanVarZ];
+    const Int_t varW = rec[kPlanVarW];
+    switch(rec[kPlanType]) {
+      case kPlanTH1:
+        if(varW>AliReducedVarManager::kNothing) ((TH1F*)h)->Fill(values[varX],values[varW]);
+        else ((TH1F*)h)->Fill(values[varX]);
+      break;
+      case kPlanProfile:
+        if(varW>AliReducedVarManager::kNothing) ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
+        else ((TProfile*)h)->Fill(values[varX],values[varY]);
+      break;
+      case kPlanTH2:
+        if(varW>AliReducedVarManager::kNothing) ((TH2F*)h)->Fill(values[varX],values[varY],values[varW]);
+        else ((TH2F*)h)->Fill(values[varX],values[varY]);
+      break;
+      case kPlanProfile2D:
+        if(varW>AliReducedVarManager::kNothing) ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
+        else ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);
+      break;
+      case kPlanTH3:
+        if(varW>AliReducedVarManager::kNothing) ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
+        else ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
+      break;
+      case kPlanProfile3D:
+        if(varW>AliReducedVarManager::kNothing) ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[rec[kPlanVarT]],values[varW]);
+        else ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[rec[kPlanVarT]]);
+      break;
+      case kPlanTHn:
+        for(Int_t idim=0;idim<rec[kPlanNDim];++idim)
+          fillValues[idim] = values[fFillPlanAxisVars[rec[kPlanAxisOffset]+idim]];
+        if(varW>AliReducedVarManager::kNothing) ((THnBase*)h)->Fill(fillValues,values[varW]);
+        else ((THnBase*)h)->Fill(fillValues);
+      break;
+      default:
+      break;
     }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
+  }
+}
+
+//__________________________________________________________________
+void AliHistogramManager::BuildFillPlan() {
+  //
+  //  flatten the histogram classes into fill records (histogram type, variables, weight and target histogram),
+  //  decoding once the variables stored in the unique IDs of the histograms and of their axes.
+  //  Histograms using variables not flagged in fUsedVars are left out, as they are never filled.
+  //  The position of each class in the main list is stored in its unique ID and used as class handle.
+  //
+  fFillPlanHistos.clear();
+  fFillPlanRecords.clear();
+  fFillPlanAxisVars.clear();
+  fFillPlanClassStart.clear();
+  
+  for(Int_t iclass=0; iclass<fMainList.GetEntries(); ++iclass) {
+    THashList* hList = (THashList*)fMainList.At(iclass);
+    hList->SetUniqueID(iclass);
+    fFillPlanClassStart.push_back(fFillPlanHistos.size());
+    
+    TIter next(hList);
+    TObject* h=0x0;
+    while((h=next())) {
+      Int_t uid = h->GetUniqueID();
+      Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+      Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+      Int_t thnDim = (isTHn ? (uid%100)-10 : 0);          // the excess over 10 from the last 2 digits give the dimension of the THn
+      
+      uid = (uid-(uid%100))/100;
+      Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
+      if(uid>0) {
+        varW = uid%(fNVars+1)-1;
+        if(varW==0) varW=AliReducedVarManager::kNothing;
+        uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
+        if(uid>0) varT = uid - 1;
+      }
+      if(varW>AliReducedVarManager::kNothing && !fUsedVars[varW]) continue;
+      
+      Int_t type = kPlanTHn;
+      const Int_t axisOffset = fFillPlanAxisVars.size();
+      if(isTHn) {
+        Bool_t allVarsGood = kTRUE;
+        for(Int_t idim=0;idim<thnDim;++idim) {
+          Int_t var = ((THnBase*)h)->GetAxis(idim)->GetUniqueID();
+          allVarsGood &= fUsedVars[var];
+          fFillPlanAxisVars.push_back(var);
+        }
+        if(!allVarsGood) {
+          fFillPlanAxisVars.resize(axisOffset);
+          continue;
+        }
+      }
+      else {
+        varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
+        if(!fUsedVars[varX]) continue;
+        Int_t dimension = ((TH1*)h)->GetDimension();
+        if(dimension>1 || isProfile) {
+          varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
+          if(!fUsedVars[varY]) continue;
+        }
+        if(dimension>2 || (dimension==2 && isProfile)) {
+          varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
+          if(!fUsedVars[varZ]) continue;
+        }
+        if(dimension==3 && isProfile && (varT<0 || !fUsedVars[varT])) continue;
         switch(dimension) {
           case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
+            type = (isProfile ? kPlanProfile : kPlanTH1);
           break;
           case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
+            type = (isProfile ? kPlanProfile2D : kPlanTH2);
           break;
           case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
+            type = (isProfile ? kPlanProfile3D : kPlanTH3);
           break;
           default:
-          break;
-        }  // end switch
-      }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-        }
-      }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
-        }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
+            continue;
         }
       }
+      
+      fFillPlanHistos.push_back(h);
+      fFillPlanRecords.push_back(type);
+      fFillPlanRecords.push_back(varX);
+      fFillPlanRecords.push_back(varY);
+      fFillPlanRecords.push_back(varZ);
+      fFillPlanRecords.push_back(varT);
+      fFillPlanRecords.push_back(varW);
+      fFillPlanRecords.push_back(thnDim);
+      fFillPlanRecords.push_back(axisOffset);
     }
   }
+  fFillPlanClassStart.push_back(fFillPlanHistos.size());
+  fFillPlanReady = kTRUE;
 }
 
 //__________________________________________________________________
@@ -14,6 +14,8 @@
 #include <TList.h>
 #include <THashList.h>
 
+#include <vector>
+
 #include "AliReducedVarManager.h"
 
 class TAxis;
@@ -69,6 +71,8 @@ class AliHistogramManager : public TObject {
                         TAxis* axis);
   
   void FillHistClass(const Char_t* className, Float_t* values);
+  void FillHistClass(Int_t classIndex, Float_t* values);     // fill using the handle from GetHistClassIndex()
+  Int_t GetHistClassIndex(const Char_t* className);          // handle of a histogram class, -1 if not found
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -106,7 +110,21 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Flattened fill plan, rebuilt at the first fill after a histogram or class was added
+  enum EFillPlanType {
+    kPlanTH1=0, kPlanProfile, kPlanTH2, kPlanProfile2D, kPlanTH3, kPlanProfile3D, kPlanTHn
+  };
+  enum EFillPlanField {
+    kPlanType=0, kPlanVarX, kPlanVarY, kPlanVarZ, kPlanVarT, kPlanVarW, kPlanNDim, kPlanAxisOffset, kNPlanFields
+  };
+  Bool_t fFillPlanReady;                       //! the fill plan is up to date
+  std::vector<TObject*> fFillPlanHistos;       //! target histogram of each fill record
+  std::vector<Int_t> fFillPlanRecords;         //! kNPlanFields integers per fill record
+  std::vector<Int_t> fFillPlanAxisVars;        //! variables of the THn axes
+  std::vector<Int_t> fFillPlanClassStart;      //! first fill record of each class, plus the total number of records
+  
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
+  void BuildFillPlan();
   
   ClassDef(AliHistogramManager, 4)
 };
@@ -308,6 +308,7 @@ void AliReducedAnalysisJpsi2ee::Init() {
    fHistosManager->SetDefaultVarNames(AliReducedVarManager::fgVariableNames,AliReducedVarManager::fgVariableUnits);
    
    fMixingHandler->SetHistogramManager(fHistosManager);
+   fHistClassIndices.clear();
 
   if (fClusterTrackMatcher) {
     fClusterTrackMatcherMultipleMatchesBefore = new TH1I("multipleCounts_beforeMatching", "mulitple counts of matched cluster IDs beofore matching", 50, 0.5, 50.5);
@@ -339,6 +340,7 @@ void AliReducedAnalysisJpsi2ee::Process() {
   fEventCounter++;
   
   AliReducedVarManager::SetEvent(fEvent);
+  const std::vector<Int_t>& histClasses = GetHistClassIndices();
   
   // reset the values array, keep only the run wise data (LHC and ALICE GRP information)
   // NOTE: the run wise data will be updated automatically in the VarManager in case a run change is detected
@@ -346,14 +348,14 @@ void AliReducedAnalysisJpsi2ee::Process() {
   
   // fill event information before event cuts
   AliReducedVarManager::FillEventInfo(fEvent, fValues);
-  fHistosManager->FillHistClass("Event_BeforeCuts", fValues);
+  fHistosManager->FillHistClass(histClasses[kHistEventBeforeCuts], fValues);
   for(UShort_t ibit=0; ibit<64; ++ibit) {
      AliReducedVarManager::FillEventTagInput(fEvent, ibit, fValues);
-     fHistosManager->FillHistClass("EventTag_BeforeCuts", fValues);
+     fHistosManager->FillHistClass(histClasses[kHistEventTagBeforeCuts], fValues);
   }
   for(UShort_t ibit=0; ibit<64; ++ibit) {
       AliReducedVarManager::FillEventOnlineTrigger(ibit, fValues);
-      fHistosManager->FillHistClass("EventTriggers_BeforeCuts", fValues);
+      fHistosManager->FillHistClass(histClasses[kHistEventTriggersBeforeCuts], fValues);
   }
 
   // apply event selection
@@ -405,18 +407,18 @@ void AliReducedAnalysisJpsi2ee::Process() {
     RunSameEventPairing();
  
   // fill event info histograms after cuts
-  fHistosManager->FillHistClass("Event_AfterCuts", fValues);
+  fHistosManager->FillHistClass(histClasses[kHistEventAfterCuts], fValues);
   for(UShort_t ibit=0; ibit<64; ++ibit) {
      AliReducedVarManager::FillEventTagInput(fEvent, ibit, fValues);
-     fHistosManager->FillHistClass("EventTag_AfterCuts", fValues);
+     fHistosManager->FillHistClass(histClasses[kHistEventTagAfterCuts], fValues);
   }
   for(UShort_t ibit=0; ibit<64; ++ibit) {
      AliReducedVarManager::FillEventOnlineTrigger(ibit, fValues);
-     fHistosManager->FillHistClass("EventTriggers_AfterCuts", fValues);
+     fHistosManager->FillHistClass(histClasses[kHistEventTriggersAfterCuts], fValues);
   }
   for(UShort_t ich=0; ich<64; ++ich) {
      AliReducedVarManager::FillV0Channel(ich, fValues);
-     fHistosManager->FillHistClass("V0Channels", fValues);
+     fHistosManager->FillHistClass(histClasses[kHistV0Channels], fValues);
   }
   
 }
@@ -480,16 +482,14 @@ void AliReducedAnalysisJpsi2ee::FillTrackHistograms(AliReducedBaseTrack* track,
    UInt_t mcDecisionMap = 0;
    if(fOptionRunOverMC) mcDecisionMap = CheckReconstructedLegMCTruth(track);      
    
-   for(Int_t icut=0; icut<fTrackCuts.GetEntries(); ++icut) {
+   // handles of the track classes, laid out as documented in GetTrackHistClassIndices()
+   const std::vector<Int_t>& trackClasses = GetTrackHistClassIndices(trackClass);
+   const Int_t nTrackCuts = fTrackCuts.GetEntries();
+   const Int_t nMCslots = fLegCandidatesMCcuts.GetEntries()+1;
+   
+   for(Int_t icut=0; icut<nTrackCuts; ++icut) {
       if(track->TestFlag(icut)) {
-         fHistosManager->FillHistClass(Form("%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-         if(mcDecisionMap) {       // Fill histograms for tracks identified as MC truth
-            for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-               if(mcDecisionMap & (UInt_t(1)<<iMC))
-                  fHistosManager->FillHistClass(Form("%s_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(), 
-                                                                  fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-            }
-         }
+         FillHistClassWithMC(&trackClasses[(kHistTrack*nTrackCuts+icut)*nMCslots], mcDecisionMap);
          
          if(track->IsA() != AliReducedTrackInfo::Class()) continue;
          
@@ -498,56 +498,21 @@ void AliReducedAnalysisJpsi2ee::FillTrackHistograms(AliReducedBaseTrack* track,
          
          for(UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingFlags; ++iflag) {
             AliReducedVarManager::FillTrackingFlag(trackInfo, iflag, fValues);
-            fHistosManager->FillHistClass(Form("%sStatusFlags_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-            if(mcDecisionMap) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisionMap & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%sStatusFlags_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                                     fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+            FillHistClassWithMC(&trackClasses[(kHistTrackStatusFlags*nTrackCuts+icut)*nMCslots], mcDecisionMap);
          }
          for(UInt_t iflag=0; iflag<64; ++iflag) {
             AliReducedVarManager::FillTrackQualityFlag(trackInfo, iflag, fValues);
-            fHistosManager->FillHistClass(Form("%sQualityFlags_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-            if(mcDecisionMap) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisionMap & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%sQualityFlags_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                        fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+            FillHistClassWithMC(&trackClasses[(kHistTrackQualityFlags*nTrackCuts+icut)*nMCslots], mcDecisionMap);
          }
          for(Int_t iLayer=0; iLayer<6; ++iLayer) {
             AliReducedVarManager::FillITSlayerFlag(trackInfo, iLayer, fValues);
-            fHistosManager->FillHistClass(Form("%sITSclusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-            if(mcDecisionMap) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisionMap & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%sITSclusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                                     fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+            FillHistClassWithMC(&trackClasses[(kHistTrackITSclusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
             AliReducedVarManager::FillITSsharedLayerFlag(trackInfo, iLayer, fValues);
-            fHistosManager->FillHistClass(Form("%sITSsharedClusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-            if(mcDecisionMap) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisionMap & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%sITSsharedClusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                        fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+            FillHistClassWithMC(&trackClasses[(kHistTrackITSsharedClusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
          }
          for(Int_t iLayer=0; iLayer<8; ++iLayer) {
             AliReducedVarManager::FillTPCclusterBitFlag(trackInfo, iLayer, fValues);
-            fHistosManager->FillHistClass(Form("%sTPCclusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-            if(mcDecisionMap) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisionMap & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%sTPCclusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                                     fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+            FillHistClassWithMC(&trackClasses[(kHistTrackTPCclusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
          }
       } // end if(track->TestFlag(icut))
    }  // end loop over cuts
@@ -559,37 +524,19 @@ void AliReducedAnalysisJpsi2ee::FillPairHistograms(ULong_t trackMask, ULong_t pa
    //
    // fill pair level histograms
    // NOTE: pairType can be 0,1 or 2 corresponding to ++, +- or -- pairs
-   TString typeStr[3] = {"PP", "PM", "MM"};
-   if (fPairCuts.GetEntries()>1) {
-      for(Int_t iTrackCut=0; iTrackCut<fTrackCuts.GetEntries(); ++iTrackCut) {
-         for(Int_t iPairCut=0; iPairCut<fPairCuts.GetEntries(); ++iPairCut) {
-            if((trackMask & (ULong_t(1)<<iTrackCut)) && (pairMask & (ULong_t(1)<<iPairCut))) {
-               fHistosManager->FillHistClass(Form("%s%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(),
-                                                  fTrackCuts.At(iTrackCut)->GetName(), fPairCuts.At(iPairCut)->GetName()), fValues);
-               if(mcDecisions && pairType==1) {
-                  for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                     if(mcDecisions & (UInt_t(1)<<iMC))
-                        fHistosManager->FillHistClass(Form("%s%s_%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(),
-                                                           fTrackCuts.At(iTrackCut)->GetName(), fPairCuts.At(iPairCut)->GetName(),
-                                                           fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-                  }
-               }
-            }
-         }
+   //       the MC selections are filled only for the +- pairs
+   const std::vector<Int_t>& pairClasses = GetPairHistClassIndices(pairClass);
+   const Int_t nTrackCuts = fTrackCuts.GetEntries();
+   const Int_t nPairCuts = (fPairCuts.GetEntries()>1 ? fPairCuts.GetEntries() : 1);
+   const Int_t nMCslots = fLegCandidatesMCcuts.GetEntries()+1;
+   if(pairType!=1) mcDecisions = 0;
+   for(Int_t iTrackCut=0; iTrackCut<nTrackCuts; ++iTrackCut) {
+      if(!(trackMask & (ULong_t(1)<<iTrackCut))) continue;
+      for(Int_t iPairCut=0; iPairCut<nPairCuts; ++iPairCut) {
+         if(nPairCuts>1 && !(pairMask & (ULong_t(1)<<iPairCut))) continue;
+         FillHistClassWithMC(&pairClasses[((pairType*nTrackCuts+iTrackCut)*nPairCuts+iPairCut)*nMCslots], mcDecisions);
       }
-   } else {
-      for(Int_t iTrackCut=0; iTrackCut<fTrackCuts.GetEntries(); ++iTrackCut) {
-         if(trackMask & (ULong_t(1)<<iTrackCut)) {
-            fHistosManager->FillHistClass(Form("%s%s_%s", pairClass.Data(), typeStr[pairType].Data(), fTrackCuts.At(iTrackCut)->GetName()), fValues);
-            if(mcDecisions && pairType==1) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisions & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%s%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(), fTrackCuts.At(iTrackCut)->GetName(), fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
-         }
-      }  // end loop over cuts
-   }
+   }  // end loop over cuts
 }
 
 //___________________________________________________________________________
@@ -612,11 +559,102 @@ void AliReducedAnalysisJpsi2ee::FillClusterHistograms(AliReducedCaloClusterInfo*
   //
   // fill cluster histograms
   //
+  const std::vector<Int_t>& clusterClasses = GetClusterHistClassIndices(clusterClass);
   for (Int_t icut=0; icut<fClusterCuts.GetEntries(); ++icut) {
-    if (cluster->TestFlag(icut)) fHistosManager->FillHistClass(Form("%s_%s", clusterClass.Data(), fClusterCuts.At(icut)->GetName()), fValues);
+    if (cluster->TestFlag(icut)) fHistosManager->FillHistClass(clusterClasses[icut], fValues);
+  }
+}
+
+//___________________________________________________________________________
+void AliReducedAnalysisJpsi2ee::FillHistClassWithMC(const Int_t* classIndices, UInt_t mcDecisions) {
+  //
+  // fill the class classIndices[0] and, for each leg MC selection iMC fulfilled in mcDecisions, the class classIndices[iMC+1]
+  //
+  fHistosManager->FillHistClass(classIndices[0], fValues);
+  if (!mcDecisions) return;
+  for (Int_t iMC=0; iMC<fLegCandidatesMCcuts.GetEntries(); ++iMC) {
+    if (mcDecisions & (UInt_t(1)<<iMC)) fHistosManager->FillHistClass(classIndices[iMC+1], fValues);
   }
 }
 
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisJpsi2ee::GetHistClassIndices() {
+  //
+  // handles of the event classes and of the cluster and track classes before cuts, indexed by HistClasses
+  //
+  std::vector<Int_t>& indices = fHistClassIndices["Event"];
+  if (!indices.empty()) return indices;
+  
+  const Char_t* classNames[kNHistClasses] = {
+    "Event_BeforeCuts", "EventTag_BeforeCuts", "EventTriggers_BeforeCuts",
+    "Event_AfterCuts", "EventTag_AfterCuts", "EventTriggers_AfterCuts", "V0Channels",
+    "CaloCluster_BeforeCuts", "Track_BeforeCuts", "TrackStatusFlags_BeforeCuts", "TrackQualityFlags_BeforeCuts",
+    "TrackITSclusterMap_BeforeCuts", "TrackITSsharedClusterMap_BeforeCuts", "TrackTPCclusterMap_BeforeCuts"
+  };
+  for (Int_t i=0; i<kNHistClasses; ++i) indices.push_back(fHistosManager->GetHistClassIndex(classNames[i]));
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisJpsi2ee::GetTrackHistClassIndices(const TString& trackClass) {
+  //
+  // handles of the track classes with the prefix trackClass, at index (type*nTrackCuts+icut)*(nMCcuts+1)+iMC+1
+  //  where type is a TrackHistClasses value and iMC=-1 stands for the class without leg MC selection
+  //
+  std::vector<Int_t>& indices = fHistClassIndices[TString("Track:")+trackClass];
+  if (!indices.empty()) return indices;
+  
+  const Char_t* typeStr[kNTrackHistClasses] = {"", "StatusFlags", "QualityFlags", "ITSclusterMap", "ITSsharedClusterMap", "TPCclusterMap"};
+  for (Int_t itype=0; itype<kNTrackHistClasses; ++itype) {
+    for (Int_t icut=0; icut<fTrackCuts.GetEntries(); ++icut) {
+      TString className = Form("%s%s_%s", trackClass.Data(), typeStr[itype], fTrackCuts.At(icut)->GetName());
+      indices.push_back(fHistosManager->GetHistClassIndex(className.Data()));
+      for (Int_t iMC=0; iMC<fLegCandidatesMCcuts.GetEntries(); ++iMC)
+        indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_%s", className.Data(), fLegCandidatesMCcuts.At(iMC)->GetName())));
+    }
+  }
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisJpsi2ee::GetPairHistClassIndices(const TString& pairClass) {
+  //
+  // handles of the pair classes with the prefix pairClass, at index ((pairType*nTrackCuts+iTrackCut)*nPairCuts+iPairCut)*(nMCcuts+1)+iMC+1
+  //  where iMC=-1 stands for the class without leg MC selection
+  // NOTE: with at most one pair cut, the pair cut is not part of the class names and nPairCuts=1
+  //
+  std::vector<Int_t>& indices = fHistClassIndices[TString("Pair:")+pairClass];
+  if (!indices.empty()) return indices;
+  
+  const Char_t* typeStr[3] = {"PP", "PM", "MM"};
+  const Int_t nPairCuts = (fPairCuts.GetEntries()>1 ? fPairCuts.GetEntries() : 1);
+  for (Int_t itype=0; itype<3; ++itype) {
+    for (Int_t iTrackCut=0; iTrackCut<fTrackCuts.GetEntries(); ++iTrackCut) {
+      for (Int_t iPairCut=0; iPairCut<nPairCuts; ++iPairCut) {
+        TString className = Form("%s%s_%s", pairClass.Data(), typeStr[itype], fTrackCuts.At(iTrackCut)->GetName());
+        if (fPairCuts.GetEntries()>1) className += Form("_%s", fPairCuts.At(iPairCut)->GetName());
+        indices.push_back(fHistosManager->GetHistClassIndex(className.Data()));
+        for (Int_t iMC=0; iMC<fLegCandidatesMCcuts.GetEntries(); ++iMC)
+          indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_%s", className.Data(), fLegCandidatesMCcuts.At(iMC)->GetName())));
+      }
+    }
+  }
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisJpsi2ee::GetClusterHistClassIndices(const TString& clusterClass) {
+  //
+  // handles of the cluster classes with the prefix clusterClass, one per cluster cut
+  //
+  std::vector<Int_t>& indices = fHistClassIndices[TString("Cluster:")+clusterClass];
+  if (!indices.empty()) return indices;
+  
+  for (Int_t icut=0; icut<fClusterCuts.GetEntries(); ++icut)
+    indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_%s", clusterClass.Data(), fClusterCuts.At(icut)->GetName())));
+  return indices;
+}
+
 //___________________________________________________________________________
 void AliReducedAnalysisJpsi2ee::RunClusterSelection() {
   //
@@ -628,6 +666,7 @@ void AliReducedAnalysisJpsi2ee::RunClusterSelection() {
   Int_t nCaloCluster = ((AliReducedEventInfo*)fEvent)->GetNCaloClusters();
   if (!nCaloCluster) return;
 
+  const Int_t clusterClassBeforeCuts = GetHistClassIndices()[kHistCaloClusterBeforeCuts];
   AliReducedCaloClusterInfo* cluster = NULL;
   for (Int_t icl=0; icl<nCaloCluster; ++icl) {
     cluster = ((AliReducedEventInfo*)fEvent)->GetCaloCluster(icl);
@@ -635,7 +674,7 @@ void AliReducedAnalysisJpsi2ee::RunClusterSelection() {
     for (Int_t i=AliReducedVarManager::kEMCALclusterEnergy; i<=AliReducedVarManager::kNEMCALvars; ++i) fValues[i] = -9999.;
 
     AliReducedVarManager::FillCaloClusterInfo(cluster, fValues);
-    fHistosManager->FillHistClass("CaloCluster_BeforeCuts", fValues);
+    fHistosManager->FillHistClass(clusterClassBeforeCuts, fValues);
 
     if (IsClusterSelected(cluster, fValues)) fClusters.Add(cluster);
   }
@@ -663,6 +702,7 @@ void AliReducedAnalysisJpsi2ee::LoopOverTracks(Int_t arrayOption /*=1*/) {
    AliReducedBaseTrack* track = 0x0;
    TClonesArray* trackList = (arrayOption==1 ? fEvent->GetTracks() : fEvent->GetTracks2());
    if (!trackList) return;
+   const std::vector<Int_t>& histClasses = GetHistClassIndices();
 
    TIter nextTrack(trackList);
    for(Int_t it=0; it<trackList->GetEntries(); ++it) {
@@ -676,28 +716,28 @@ void AliReducedAnalysisJpsi2ee::LoopOverTracks(Int_t arrayOption /*=1*/) {
       AliReducedVarManager::FillTrackInfo(track, fValues);
       if (fClusterCuts.GetEntries())  AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, &fClusters, fClusterTrackMatcher);
       else                            AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, NULL, fClusterTrackMatcher);
-      fHistosManager->FillHistClass("Track_BeforeCuts", fValues);
+      fHistosManager->FillHistClass(histClasses[kHistTrackBeforeCuts], fValues);
       
       if(track->IsA() == AliReducedTrackInfo::Class()) {
          AliReducedTrackInfo* trackInfo = dynamic_cast<AliReducedTrackInfo*>(track);
          if(trackInfo) {
             for(UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingStatus; ++iflag) {
                AliReducedVarManager::FillTrackingFlag(trackInfo, iflag, fValues);
-               fHistosManager->FillHistClass("TrackStatusFlags_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(histClasses[kHistTrackStatusFlagsBeforeCuts], fValues);
             }
             for(UInt_t iflag=0; iflag<64; ++iflag) {
                AliReducedVarManager::FillTrackQualityFlag(trackInfo, iflag, fValues);
-               fHistosManager->FillHistClass("TrackQualityFlags_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(histClasses[kHistTrackQualityFlagsBeforeCuts], fValues);
             }
             for(Int_t iLayer=0; iLayer<6; ++iLayer) {
                AliReducedVarManager::FillITSlayerFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackITSclusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(histClasses[kHistTrackITSclusterMapBeforeCuts], fValues);
                AliReducedVarManager::FillITSsharedLayerFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackITSsharedClusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(histClasses[kHistTrackITSsharedClusterMapBeforeCuts], fValues);
             }
             for(Int_t iLayer=0; iLayer<8; ++iLayer) {
                AliReducedVarManager::FillTPCclusterBitFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackTPCclusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(histClasses[kHistTrackTPCclusterMapBeforeCuts], fValues);
             }
          }
       }
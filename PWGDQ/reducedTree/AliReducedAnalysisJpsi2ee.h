@@ -5,6 +5,9 @@
 #ifndef ALIREDUCEDANALYSISJPSI2EE_H
 #define ALIREDUCEDANALYSISJPSI2EE_H
 
+#include <map>
+#include <vector>
+
 #include <TList.h>
 
 #include "AliReducedAnalysisTaskSE.h"
@@ -161,6 +164,26 @@ protected:
   void FillClusterHistograms(TString clusterClass="CaloCluster");
   void FillClusterHistograms(AliReducedCaloClusterInfo* cluster, TString clusterClass="CaloCluster");
   void FillMCTruthHistograms();
+  void FillHistClassWithMC(const Int_t* classIndices, UInt_t mcDecisions);
+
+  // handles of the histogram classes (see AliHistogramManager::GetHistClassIndex()), resolved on the first event
+  // NOTE: the cuts and the histogram classes are usually defined after Init(), so the handles cannot be resolved there
+  enum HistClasses {
+    kHistEventBeforeCuts=0, kHistEventTagBeforeCuts, kHistEventTriggersBeforeCuts,
+    kHistEventAfterCuts, kHistEventTagAfterCuts, kHistEventTriggersAfterCuts, kHistV0Channels,
+    kHistCaloClusterBeforeCuts, kHistTrackBeforeCuts, kHistTrackStatusFlagsBeforeCuts, kHistTrackQualityFlagsBeforeCuts,
+    kHistTrackITSclusterMapBeforeCuts, kHistTrackITSsharedClusterMapBeforeCuts, kHistTrackTPCclusterMapBeforeCuts,
+    kNHistClasses
+  };
+  enum TrackHistClasses {
+    kHistTrack=0, kHistTrackStatusFlags, kHistTrackQualityFlags, kHistTrackITSclusterMap, kHistTrackITSsharedClusterMap,
+    kHistTrackTPCclusterMap, kNTrackHistClasses
+  };
+  const std::vector<Int_t>& GetHistClassIndices();
+  const std::vector<Int_t>& GetTrackHistClassIndices(const TString& trackClass);
+  const std::vector<Int_t>& GetPairHistClassIndices(const TString& pairClass);
+  const std::vector<Int_t>& GetClusterHistClassIndices(const TString& clusterClass);
+  std::map<TString, std::vector<Int_t> > fHistClassIndices;   //! histogram class handles, keyed by the class name prefix
 
   TList*  fClusterTrackMatcherHistograms;             // list of cluster-track matcher histograms
   TH1I*   fClusterTrackMatcherMultipleMatchesBefore;  // multiple matches of tracks to same cluster before matching
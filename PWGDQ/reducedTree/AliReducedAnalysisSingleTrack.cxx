@@ -181,6 +181,8 @@ void AliReducedAnalysisSingleTrack::FillMCTruthHistograms() {
   TClonesArray* trackList = fEvent->GetTracks();
   if (!trackList) return;
   
+  const std::vector<Int_t>& mcTruthClasses = GetMCTruthHistClassIndices();
+  
   TIter nextTrack(trackList);
   AliReducedTrackInfo* track = 0x0;
   for (Int_t it=0; it<trackList->GetEntries(); ++it) {
@@ -198,7 +200,7 @@ void AliReducedAnalysisSingleTrack::FillMCTruthHistograms() {
     // loop over track selections and fill histograms
     for (Int_t iCut = 0; iCut<fMCSignalCuts.GetEntries(); ++iCut) {
       if (!(mcDecisionMap & (UInt_t(1)<<iCut)))  continue;
-      fHistosManager->FillHistClass(Form("%s_PureMCTruth", fMCSignalCuts.At(iCut)->GetName()), fValues);
+      fHistosManager->FillHistClass(mcTruthClasses[iCut], fValues);
     }
   }
 }
@@ -214,6 +216,7 @@ void AliReducedAnalysisSingleTrack::RunTrackSelection() {
   TClonesArray* trackList = fEvent->GetTracks();
   if (!trackList) return;
   if (!trackList->GetEntries()) return;
+  const std::vector<Int_t>& histClasses = GetHistClassIndices();
   
   TIter nextTrack(trackList);
   AliReducedBaseTrack* track = 0x0;
@@ -230,24 +233,24 @@ void AliReducedAnalysisSingleTrack::RunTrackSelection() {
     AliReducedVarManager::FillTrackInfo(track, fValues);
     if (fClusterCuts.GetEntries())  AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, &fClusters, fClusterTrackMatcher);
     else                            AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, NULL, fClusterTrackMatcher);
-    fHistosManager->FillHistClass("Track_BeforeCuts", fValues);
+    fHistosManager->FillHistClass(histClasses[kHistTrackBeforeCuts], fValues);
     
     if (track->IsA() == AliReducedTrackInfo::Class()) {
       AliReducedTrackInfo* trackInfo = dynamic_cast<AliReducedTrackInfo*>(track);
       if (trackInfo) {
         for (UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingStatus; ++iflag) {
           AliReducedVarManager::FillTrackingFlag(trackInfo, iflag, fValues);
-          fHistosManager->FillHistClass("TrackStatusFlags_BeforeCuts", fValues);
+          fHistosManager->FillHistClass(histClasses[kHistTrackStatusFlagsBeforeCuts], fValues);
         }
         for (Int_t iLayer=0; iLayer<6; ++iLayer) {
           AliReducedVarManager::FillITSlayerFlag(trackInfo, iLayer, fValues);
-          fHistosManager->FillHistClass("TrackITSclusterMap_BeforeCuts", fValues);
+          fHistosManager->FillHistClass(histClasses[kHistTrackITSclusterMapBeforeCuts], fValues);
           AliReducedVarManager::FillITSsharedLayerFlag(trackInfo, iLayer, fValues);
-          fHistosManager->FillHistClass("TrackITSsharedClusterMap_BeforeCuts", fValues);
+          fHistosManager->FillHistClass(histClasses[kHistTrackITSsharedClusterMapBeforeCuts], fValues);
         }
         for (Int_t iLayer=0; iLayer<8; ++iLayer) {
           AliReducedVarManager::FillTPCclusterBitFlag(trackInfo, iLayer, fValues);
-          fHistosManager->FillHistClass("TrackTPCclusterMap_BeforeCuts", fValues);
+          fHistosManager->FillHistClass(histClasses[kHistTrackTPCclusterMapBeforeCuts], fValues);
         }
       }
     }
@@ -299,16 +302,14 @@ void AliReducedAnalysisSingleTrack::FillTrackHistograms(AliReducedBaseTrack* tra
   UInt_t mcDecisionMap = 0;
   if (fOptionRunOverMC) mcDecisionMap = CheckTrackMCTruth(track);
   
-  for (Int_t icut=0; icut<fTrackCuts.GetEntries(); ++icut) {
+  // handles of the track classes, laid out as documented in GetTrackHistClassIndices()
+  const std::vector<Int_t>& trackClasses = GetTrackHistClassIndices(trackClass);
+  const Int_t nTrackCuts = fTrackCuts.GetEntries();
+  const Int_t nMCslots = fMCSignalCuts.GetEntries()+1;
+  
+  for (Int_t icut=0; icut<nTrackCuts; ++icut) {
     if (track->TestFlag(icut)) {
-      fHistosManager->FillHistClass(Form("%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-      if (mcDecisionMap) {
-        for (Int_t iMC=0; iMC<=fMCSignalCuts.GetEntries(); ++iMC) {
-          if (mcDecisionMap & (UInt_t(1)<<iMC))
-            fHistosManager->FillHistClass(Form("%s_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                               fMCSignalCuts.At(iMC)->GetName()), fValues);
-        }
-      }
+      FillHistClassWithMC(&trackClasses[(kHistTrack*nTrackCuts+icut)*nMCslots], mcDecisionMap);
       
       if (track->IsA() != AliReducedTrackInfo::Class()) continue;
       
@@ -317,45 +318,17 @@ void AliReducedAnalysisSingleTrack::FillTrackHistograms(AliReducedBaseTrack* tra
       
       for (UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingFlags; ++iflag) {
         AliReducedVarManager::FillTrackingFlag(trackInfo, iflag, fValues);
-        fHistosManager->FillHistClass(Form("%sStatusFlags_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-        if (mcDecisionMap) {
-          for (Int_t iMC=0; iMC<=fMCSignalCuts.GetEntries(); ++iMC) {
-            if (mcDecisionMap & (UInt_t(1)<<iMC))
-              fHistosManager->FillHistClass(Form("%sStatusFlags_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                 fMCSignalCuts.At(iMC)->GetName()), fValues);
-          }
-        }
+        FillHistClassWithMC(&trackClasses[(kHistTrackStatusFlags*nTrackCuts+icut)*nMCslots], mcDecisionMap);
       }
       for (Int_t iLayer=0; iLayer<6; ++iLayer) {
         AliReducedVarManager::FillITSlayerFlag(trackInfo, iLayer, fValues);
-        fHistosManager->FillHistClass(Form("%sITSclusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-        if (mcDecisionMap) {
-          for (Int_t iMC=0; iMC<=fMCSignalCuts.GetEntries(); ++iMC) {
-            if (mcDecisionMap & (UInt_t(1)<<iMC))
-              fHistosManager->FillHistClass(Form("%sITSclusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                 fMCSignalCuts.At(iMC)->GetName()), fValues);
-          }
-        }
+        FillHistClassWithMC(&trackClasses[(kHistTrackITSclusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
         AliReducedVarManager::FillITSsharedLayerFlag(trackInfo, iLayer, fValues);
-        fHistosManager->FillHistClass(Form("%sITSsharedClusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-        if (mcDecisionMap) {
-          for (Int_t iMC=0; iMC<=fMCSignalCuts.GetEntries(); ++iMC) {
-            if (mcDecisionMap & (UInt_t(1)<<iMC))
-              fHistosManager->FillHistClass(Form("%sITSsharedClusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                 fMCSignalCuts.At(iMC)->GetName()), fValues);
-          }
-        }
+        FillHistClassWithMC(&trackClasses[(kHistTrackITSsharedClusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
       }
       for (Int_t iLayer=0; iLayer<8; ++iLayer) {
         AliReducedVarManager::FillTPCclusterBitFlag(trackInfo, iLayer, fValues);
-        fHistosManager->FillHistClass(Form("%sTPCclusterMap_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName()), fValues);
-        if (mcDecisionMap) {
-          for (Int_t iMC=0; iMC<=fMCSignalCuts.GetEntries(); ++iMC) {
-            if (mcDecisionMap & (UInt_t(1)<<iMC))
-              fHistosManager->FillHistClass(Form("%sTPCclusterMap_%s_%s", trackClass.Data(), fTrackCuts.At(icut)->GetName(),
-                                                 fMCSignalCuts.At(iMC)->GetName()), fValues);
-          }
-        }
+        FillHistClassWithMC(&trackClasses[(kHistTrackTPCclusterMap*nTrackCuts+icut)*nMCslots], mcDecisionMap);
       }
     } // end if (track->TestFlag(icut))
   } // end loop over cuts
@@ -372,6 +345,7 @@ void AliReducedAnalysisSingleTrack::RunClusterSelection() {
   Int_t nCaloCluster = ((AliReducedEventInfo*)fEvent)->GetNCaloClusters();
   if (!nCaloCluster) return;
 
+  const Int_t clusterClassBeforeCuts = GetHistClassIndices()[kHistCaloClusterBeforeCuts];
   AliReducedCaloClusterInfo* cluster = NULL;
   for (Int_t icl=0; icl<nCaloCluster; ++icl) {
     cluster = ((AliReducedEventInfo*)fEvent)->GetCaloCluster(icl);
@@ -379,7 +353,7 @@ void AliReducedAnalysisSingleTrack::RunClusterSelection() {
     for (Int_t i=AliReducedVarManager::kEMCALclusterEnergy; i<=AliReducedVarManager::kNEMCALvars; ++i) fValues[i] = -9999.;
 
     AliReducedVarManager::FillCaloClusterInfo(cluster, fValues);
-    fHistosManager->FillHistClass("CaloCluster_BeforeCuts", fValues);
+    fHistosManager->FillHistClass(clusterClassBeforeCuts, fValues);
 
     if (IsClusterSelected(cluster, fValues)) fClusters.Add(cluster);
   }
@@ -405,9 +379,87 @@ void AliReducedAnalysisSingleTrack::FillClusterHistograms(AliReducedCaloClusterI
   //
   // fill cluster histograms
   //
+  const std::vector<Int_t>& clusterClasses = GetClusterHistClassIndices(clusterClass);
   for (Int_t icut=0; icut<fClusterCuts.GetEntries(); ++icut) {
-    if (cluster->TestFlag(icut)) fHistosManager->FillHistClass(Form("%s_%s", clusterClass.Data(), fClusterCuts.At(icut)->GetName()), fValues);
+    if (cluster->TestFlag(icut)) fHistosManager->FillHistClass(clusterClasses[icut], fValues);
+  }
+}
+
+//___________________________________________________________________________
+void AliReducedAnalysisSingleTrack::FillHistClassWithMC(const Int_t* classIndices, UInt_t mcDecisions) {
+  //
+  // fill the class classIndices[0] and, for each MC selection iMC fulfilled in mcDecisions, the class classIndices[iMC+1]
+  //
+  fHistosManager->FillHistClass(classIndices[0], fValues);
+  if (!mcDecisions) return;
+  for (Int_t iMC=0; iMC<fMCSignalCuts.GetEntries(); ++iMC) {
+    if (mcDecisions & (UInt_t(1)<<iMC)) fHistosManager->FillHistClass(classIndices[iMC+1], fValues);
+  }
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisSingleTrack::GetHistClassIndices() {
+  //
+  // handles of the event classes and of the cluster and track classes before cuts, indexed by HistClasses
+  //
+  std::vector<Int_t>& indices = fHistClassIndices["Event"];
+  if (!indices.empty()) return indices;
+  
+  const Char_t* classNames[kNHistClasses] = {
+    "Event_BeforeCuts", "EventTag_BeforeCuts", "EventTriggers_BeforeCuts",
+    "Event_AfterCuts", "EventTag_AfterCuts", "EventTriggers_AfterCuts",
+    "CaloCluster_BeforeCuts", "Track_BeforeCuts", "TrackStatusFlags_BeforeCuts",
+    "TrackITSclusterMap_BeforeCuts", "TrackITSsharedClusterMap_BeforeCuts", "TrackTPCclusterMap_BeforeCuts"
+  };
+  for (Int_t i=0; i<kNHistClasses; ++i) indices.push_back(fHistosManager->GetHistClassIndex(classNames[i]));
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisSingleTrack::GetMCTruthHistClassIndices() {
+  //
+  // handles of the pure MC truth classes, one per MC selection
+  //
+  std::vector<Int_t>& indices = fHistClassIndices["PureMCTruth"];
+  if (!indices.empty()) return indices;
+  
+  for (Int_t iMC=0; iMC<fMCSignalCuts.GetEntries(); ++iMC)
+    indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_PureMCTruth", fMCSignalCuts.At(iMC)->GetName())));
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisSingleTrack::GetTrackHistClassIndices(const TString& trackClass) {
+  //
+  // handles of the track classes with the prefix trackClass, at index (type*nTrackCuts+icut)*(nMCcuts+1)+iMC+1
+  //  where type is a TrackHistClasses value and iMC=-1 stands for the class without MC selection
+  //
+  std::vector<Int_t>& indices = fHistClassIndices[TString("Track:")+trackClass];
+  if (!indices.empty()) return indices;
+  
+  const Char_t* typeStr[kNTrackHistClasses] = {"", "StatusFlags", "ITSclusterMap", "ITSsharedClusterMap", "TPCclusterMap"};
+  for (Int_t itype=0; itype<kNTrackHistClasses; ++itype) {
+    for (Int_t icut=0; icut<fTrackCuts.GetEntries(); ++icut) {
+      TString className = Form("%s%s_%s", trackClass.Data(), typeStr[itype], fTrackCuts.At(icut)->GetName());
+      indices.push_back(fHistosManager->GetHistClassIndex(className.Data()));
+      for (Int_t iMC=0; iMC<fMCSignalCuts.GetEntries(); ++iMC)
+        indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_%s", className.Data(), fMCSignalCuts.At(iMC)->GetName())));
+    }
   }
+  return indices;
+}
+
+//___________________________________________________________________________
+const std::vector<Int_t>& AliReducedAnalysisSingleTrack::GetClusterHistClassIndices(const TString& clusterClass) {
+  //
+  // handles of the cluster classes with the prefix clusterClass, one per cluster cut
+  //
+  std::vector<Int_t>& indices = fHistClassIndices[TString("Cluster:")+clusterClass];
+  if (!indices.empty()) return indices;
+  
+  for (Int_t icut=0; icut<fClusterCuts.GetEntries(); ++icut)
+    indices.push_back(fHistosManager->GetHistClassIndex(Form("%s_%s", clusterClass.Data(), fClusterCuts.At(icut)->GetName())));
+  return indices;
 }
 
 //___________________________________________________________________________
@@ -418,6 +470,7 @@ void AliReducedAnalysisSingleTrack::Init() {
   AliReducedVarManager::SetDefaultVarNames();
   fHistosManager->SetUseDefaultVariableNames(kTRUE);
   fHistosManager->SetDefaultVarNames(AliReducedVarManager::fgVariableNames, AliReducedVarManager::fgVariableUnits);
+  fHistClassIndices.clear();
 
   if (fClusterTrackMatcher) {
     fClusterTrackMatcherMultipleMatchesBefore = new TH1I("multipleCounts_beforeMatching", "mulitple counts of matched cluster IDs beofore matching", 50, 0.5, 50.5);
@@ -448,6 +501,7 @@ void AliReducedAnalysisSingleTrack::Process() {
   fEventCounter++;
   
   AliReducedVarManager::SetEvent(fEvent);
+  const std::vector<Int_t>& histClasses = GetHistClassIndices();
   
   // reset the values array, keep only the run wise data (LHC and ALICE GRP information)
   // NOTE: the run wise data will be updated automatically in the VarManager in case a run change is detected
@@ -455,14 +509,14 @@ void AliReducedAnalysisSingleTrack::Process() {
 
   // fill event information before event cuts
   AliReducedVarManager::FillEventInfo(fEvent, fValues);
-  fHistosManager->FillHistClass("Event_BeforeCuts", fValues);
+  fHistosManager->FillHistClass(histClasses[kHistEventBeforeCuts], fValues);
   for (UShort_t ibit=0; ibit<64; ++ibit) {
     AliReducedVarManager::FillEventTagInput(fEvent, ibit, fValues);
-    fHistosManager->FillHistClass("EventTag_BeforeCuts", fValues);
+    fHistosManager->FillHistClass(histClasses[kHistEventTagBeforeCuts], fValues);
   }
   for (UShort_t ibit=0; ibit<64; ++ibit) {
     AliReducedVarManager::FillEventOnlineTrigger(ibit, fValues);
-    fHistosManager->FillHistClass("EventTriggers_BeforeCuts", fValues);
+    fHistosManager->FillHistClass(histClasses[kHistEventTriggersBeforeCuts], fValues);
   }
 
   // apply event selection
@@ -486,14 +540,14 @@ void AliReducedAnalysisSingleTrack::Process() {
   FillTrackHistograms();
   
   // fill event info histograms after cuts
-  fHistosManager->FillHistClass("Event_AfterCuts", fValues);
+  fHistosManager->FillHistClass(histClasses[kHistEventAfterCuts], fValues);
   for (UShort_t ibit=0; ibit<64; ++ibit) {
     AliReducedVarManager::FillEventTagInput(fEvent, ibit, fValues);
-    fHistosManager->FillHistClass("EventTag_AfterCuts", fValues);
+    fHistosManager->FillHistClass(histClasses[kHistEventTagAfterCuts], fValues);
   }
   for (UShort_t ibit=0; ibit<64; ++ibit) {
     AliReducedVarManager::FillEventOnlineTrigger(ibit, fValues);
-    fHistosManager->FillHistClass("EventTriggers_AfterCuts", fValues);
+    fHistosManager->FillHistClass(histClasses[kHistEventTriggersAfterCuts], fValues);
   }
 }
 
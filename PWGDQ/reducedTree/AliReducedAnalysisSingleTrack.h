@@ -10,6 +10,9 @@
 #ifndef ALIREDUCEDANALYSISSINGLETRACK_H
 #define ALIREDUCEDANALYSISSINGLETRACK_H
 
+#include <map>
+#include <vector>
+
 #include <TList.h>
 
 #include "AliReducedAnalysisTaskSE.h"
@@ -88,6 +91,26 @@ protected:
   void    FillTrackHistograms(AliReducedBaseTrack* track, TString trackClass="Track");
   void    FillClusterHistograms(TString clusterClass="CaloCluster");
   void    FillClusterHistograms(AliReducedCaloClusterInfo* cluster, TString clusterClass="CaloCluster");
+  void    FillHistClassWithMC(const Int_t* classIndices, UInt_t mcDecisions);
+
+  // handles of the histogram classes (see AliHistogramManager::GetHistClassIndex()), resolved on the first event
+  // NOTE: the cuts and the histogram classes are usually defined after Init(), so the handles cannot be resolved there
+  enum HistClasses {
+    kHistEventBeforeCuts=0, kHistEventTagBeforeCuts, kHistEventTriggersBeforeCuts,
+    kHistEventAfterCuts, kHistEventTagAfterCuts, kHistEventTriggersAfterCuts,
+    kHistCaloClusterBeforeCuts, kHistTrackBeforeCuts, kHistTrackStatusFlagsBeforeCuts,
+    kHistTrackITSclusterMapBeforeCuts, kHistTrackITSsharedClusterMapBeforeCuts, kHistTrackTPCclusterMapBeforeCuts,
+    kNHistClasses
+  };
+  enum TrackHistClasses {
+    kHistTrack=0, kHistTrackStatusFlags, kHistTrackITSclusterMap, kHistTrackITSsharedClusterMap, kHistTrackTPCclusterMap,
+    kNTrackHistClasses
+  };
+  const std::vector<Int_t>& GetHistClassIndices();
+  const std::vector<Int_t>& GetMCTruthHistClassIndices();
+  const std::vector<Int_t>& GetTrackHistClassIndices(const TString& trackClass);
+  const std::vector<Int_t>& GetClusterHistClassIndices(const TString& clusterClass);
+  std::map<TString, std::vector<Int_t> > fHistClassIndices;   //! histogram class handles, keyed by the class name prefix
 
   ClassDef(AliReducedAnalysisSingleTrack,3);
 };
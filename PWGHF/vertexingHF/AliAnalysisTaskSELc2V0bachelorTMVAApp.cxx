@@ -76,6 +76,7 @@
 #include <TMVA/MethodCuts.h>
 
 #include "IClassifierReader.h"
+#include "AliHFTreeEnsembleReader.h"
 
 using std::cout;
 using std::endl;
@@ -201,6 +202,7 @@ AliAnalysisTaskSELc2V0bachelorTMVAApp::AliAnalysisTaskSELc2V0bachelorTMVAApp():
   fFillTree(0),
   fUseWeightsLibrary(kFALSE),
   fBDTReader(0),
+  fUseTreeEnsembleReader(kFALSE),
   fTMVAlibName(""),
   fTMVAlibPtBin(""),
   fNamesTMVAVar(""),
@@ -369,6 +371,7 @@ AliAnalysisTaskSELc2V0bachelorTMVAApp::AliAnalysisTaskSELc2V0bachelorTMVAApp(con
   fFillTree(0),
   fUseWeightsLibrary(kFALSE),
   fBDTReader(0),
+  fUseTreeEnsembleReader(kFALSE),
   fTMVAlibName(""),
   fTMVAlibPtBin(""),
   fNamesTMVAVar(""),
@@ -1114,6 +1117,13 @@ void AliAnalysisTaskSELc2V0bachelorTMVAApp::UserCreateOutputObjects() {
       IClassifierReader* (*maker1)(std::vector<std::string>&) = (IClassifierReader* (*)(std::vector<std::string>&)) p;
       fBDTReader = maker1(inputNamesVec);
     }
+    else if (fUseTreeEnsembleReader) {
+      TString xmlFile = fXmlWeightsFile;
+      if (fUseXmlFileFromCVMFS) xmlFile = AliDataFile::GetFileName(fXmlFileFromCVMFS.Data());
+      gSystem->ExpandPathName(xmlFile);
+      fBDTReader = new AliHFTreeEnsembleReader(inputNamesVec, xmlFile.Data());
+      if (!fBDTReader->IsStatusClean()) AliFatal(Form("Cannot use BDT from %s", xmlFile.Data()));
+    }
     
     if (fUseXmlWeightsFile) fReader->BookMVA("BDT method", fXmlWeightsFile);
 
@@ -2246,7 +2256,7 @@ void AliAnalysisTaskSELc2V0bachelorTMVAApp::FillLc2pK0Sspectrum(AliAODRecoCascad
       Double_t BDTResponse = -1;
       Double_t tmva = -1;
       if (fUseXmlWeightsFile || fUseXmlFileFromCVMFS) tmva = fReader->EvaluateMVA("BDT method");
-      if (fUseWeightsLibrary) BDTResponse = fBDTReader->GetMvaValue(inputVars);
+      if (fUseWeightsLibrary || fUseTreeEnsembleReader) BDTResponse = fBDTReader->GetMvaValue(inputVars);
       //Printf("BDTResponse = %f, invmassLc = %f", BDTResponse, invmassLc);
       //Printf("tmva = %f", tmva); 
       fBDTHisto->Fill(BDTResponse, invmassLc); 
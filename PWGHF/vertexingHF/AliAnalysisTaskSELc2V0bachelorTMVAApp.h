@@ -179,6 +179,10 @@ class AliAnalysisTaskSELc2V0bachelorTMVAApp : public AliAnalysisTaskSE
   void SetUseWeightsLibrary(Bool_t flag) {fUseWeightsLibrary = flag;}
   Bool_t GetUseWeightsLibrary() const {return fUseWeightsLibrary;}
 
+  /// evaluate the BDT of the xml weights file with AliHFTreeEnsembleReader instead of the compiled class
+  void SetUseTreeEnsembleReader(Bool_t flag) {fUseTreeEnsembleReader = flag;}
+  Bool_t GetUseTreeEnsembleReader() const {return fUseTreeEnsembleReader;}
+
   void SetXmlWeightsFile(TString fileName) {fXmlWeightsFile = fileName;}
   TString GetXmlWeightsFile() const {return fXmlWeightsFile;}
 
@@ -562,6 +566,7 @@ class AliAnalysisTaskSELc2V0bachelorTMVAApp : public AliAnalysisTaskSE
 
   Bool_t fUseWeightsLibrary;           // flag to decide whether to use or not the BDT class
   IClassifierReader *fBDTReader;       //!<! BDT reader using BDT class
+  Bool_t fUseTreeEnsembleReader;       /// flag to evaluate the xml weights file with AliHFTreeEnsembleReader
   TString fTMVAlibName;                /// Name of the library to load to have the TMVA weights
   TString fTMVAlibPtBin;               /// Pt bin that will be in the library to be loaded for the TMVA
   TString fNamesTMVAVar;               /// vector of the names of the input variables
@@ -624,7 +629,7 @@ class AliAnalysisTaskSELc2V0bachelorTMVAApp : public AliAnalysisTaskSE
   TH2F* fHistoVzVsNtrCorr;           //!<! hist. Vz vs corrected tracklets
   
   /// \cond CLASSIMP    
-  ClassDef(AliAnalysisTaskSELc2V0bachelorTMVAApp, 12); /// class for Lc->p K0
+  ClassDef(AliAnalysisTaskSELc2V0bachelorTMVAApp, 13); /// class for Lc->p K0
   /// \endcond    
 };
 
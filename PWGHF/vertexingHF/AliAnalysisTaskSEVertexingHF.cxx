@@ -261,6 +261,13 @@ void AliAnalysisTaskSEVertexingHF::UserExec(Option_t */*option*/)
   return;
 }
 
+//________________________________________________________________________
+void AliAnalysisTaskSEVertexingHF::FinishTaskOutput()
+{
+  // Print the counters of the 3-prong combinations of the vertexer
+  //
+  if(fVHF && fVHF->GetKinematicPrefilter3Prong()) fVHF->PrintCombinationCounters();
+}
 //________________________________________________________________________
 void AliAnalysisTaskSEVertexingHF::Terminate(Option_t */*option*/)
 {
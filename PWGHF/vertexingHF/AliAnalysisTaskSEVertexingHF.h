@@ -34,6 +34,7 @@ class AliAnalysisTaskSEVertexingHF : public AliAnalysisTaskSE
   virtual void Init();
   virtual void LocalInit() {Init();}
   virtual void UserExec(Option_t *option);
+  virtual void FinishTaskOutput();
   virtual void Terminate(Option_t *option);
   void SetDeltaAODFileName(const char* name) {fDeltaAODFileName=name;}
   const char* GetDeltaAODFileName() const {return fDeltaAODFileName.Data();}
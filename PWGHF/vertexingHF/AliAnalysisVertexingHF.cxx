@@ -32,6 +32,7 @@
 #include <TString.h>
 #include <TList.h>
 #include <TProcessID.h>
+#include <TROOT.h>
 #include "AliLog.h"
 #include "AliVEvent.h"
 #include "AliVVertex.h"
@@ -70,6 +71,23 @@
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
 #include <cstring>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace {
+  /// The cut objects of the candidate workers share the AliPIDResponse of the
+  /// input handler, which is not thread-safe: the candidate selections, which
+  /// include the PID, are done by one worker at a time
+  std::mutex gPIDResponseMutex;
+
+  std::unique_lock<std::mutex> LockPIDResponse(Bool_t lock)
+  {
+    std::unique_lock<std::mutex> pidLock(gPIDResponseMutex,std::defer_lock);
+    if(lock) pidLock.lock();
+    return pidLock;
+  }
+}
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
@@ -161,10 +179,15 @@ fMassLambdaC(0.),
 fMassDstar(0.),
 fMassJpsi(0.),
 fMassPhi(0.),
-fMassK(0.)
+fMassK(0.),
+fNThreadsForCandidates(0),
+fKinematicPrefilter3Prong(kFALSE),
+fIsCandidateWorker(kFALSE)
 {
   /// Default constructor
 
+  for(Int_t iStage=0; iStage<kNCombinationStages; iStage++) fNCombinations[iStage]=0;
+
   Double_t d02[2]={0.,0.};
   Double_t d03[3]={0.,0.,0.};
   Double_t d04[4]={0.,0.,0.,0.};
@@ -260,11 +283,15 @@ fMassLambdaC(source.fMassLambdaC),
 fMassDstar(source.fMassDstar),
 fMassJpsi(source.fMassJpsi),
 fMassPhi(source.fMassPhi),
-fMassK(source.fMassK)
+fMassK(source.fMassK),
+fNThreadsForCandidates(source.fNThreadsForCandidates),
+fKinematicPrefilter3Prong(source.fKinematicPrefilter3Prong),
+fIsCandidateWorker(kFALSE)
 {
   ///
   /// Copy constructor
   ///
+  for(Int_t iStage=0; iStage<kNCombinationStages; iStage++) fNCombinations[iStage]=0;
 }
 //--------------------------------------------------------------------------
 AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVertexingHF &source)
@@ -356,6 +383,8 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fMassJpsi = source.fMassJpsi;
   fMassPhi = source.fMassPhi;
   fMassK = source.fMassK;
+  fNThreadsForCandidates = source.fNThreadsForCandidates;
+  fKinematicPrefilter3Prong = source.fKinematicPrefilter3Prong;
 
   return *this;
 }
@@ -444,6 +473,156 @@ TList *AliAnalysisVertexingHF::FillListOfCuts() {
   return list;
 }
 //----------------------------------------------------------------------------
+/// margin of the bounds of the kinematic prefilter of the 3 prongs (rounding)
+static const Double_t kPrefilterTolerance=1.e-6;
+//----------------------------------------------------------------------------
+/// Inputs of the loops on tracks of FindCandidates, with the scratch arrays
+/// of track combinations. With threads, each thread has its own copy, with
+/// private copies of the selected tracks (they are propagated in the loops)
+struct AliAnalysisVertexingHF::CandidateLoopInput {
+  CandidateLoopInput(AliVEvent *event,TObjArray *seleTrks,TObjArray *tracksAtVertex,
+		     UChar_t *seleFlags,Int_t *evtNumber,Int_t nSeleTrks,
+		     Int_t trkEntries,Int_t nv0,Float_t dcaMax,Double_t minPtV0) :
+    fEvent(event),fSeleTrks(seleTrks),fSeleTrksEvent(seleTrks),
+    fTracksAtVertex(tracksAtVertex),fSeleFlags(seleFlags),fEvtNumber(evtNumber),
+    fNSeleTrks(nSeleTrks),fTrkEntries(trkEntries),fNV0s(nv0),fDcaMax(dcaMax),
+    fMinPtV0(minPtV0),fThreaded(kFALSE),
+    fTwoTrackArray1(2),fTwoTrackArray2(2),fTwoTrackArrayV0(2),fTwoTrackArrayCasc(2),
+    fThreeTrackArray(3),fFourTrackArray(4),
+    fTrkPt(),fTrkPz(),fTrkP(),fTrkE(),fMaxPtAfter(),fMinPt3Prong(0.),fMinPtLc(0.) {
+    for(Int_t i=0; i<6; i++) fMassWindow2[i]=0.;
+  }
+  CandidateLoopInput(const CandidateLoopInput &source) :
+    fEvent(source.fEvent),fSeleTrks(new TObjArray(source.fNSeleTrks)),
+    fSeleTrksEvent(source.fSeleTrksEvent),fTracksAtVertex(source.fTracksAtVertex),
+    fSeleFlags(source.fSeleFlags),fEvtNumber(source.fEvtNumber),
+    fNSeleTrks(source.fNSeleTrks),fTrkEntries(source.fTrkEntries),fNV0s(source.fNV0s),
+    fDcaMax(source.fDcaMax),fMinPtV0(source.fMinPtV0),fThreaded(kTRUE),
+    fTwoTrackArray1(2),fTwoTrackArray2(2),fTwoTrackArrayV0(2),fTwoTrackArrayCasc(2),
+    fThreeTrackArray(3),fFourTrackArray(4),
+    fTrkPt(source.fTrkPt),fTrkPz(source.fTrkPz),fTrkP(source.fTrkP),fTrkE(source.fTrkE),
+    fMaxPtAfter(source.fMaxPtAfter),fMinPt3Prong(source.fMinPt3Prong),fMinPtLc(source.fMinPtLc) {
+    for(Int_t i=0; i<6; i++) fMassWindow2[i]=source.fMassWindow2[i];
+    for(Int_t iTrk=0; iTrk<fNSeleTrks; iTrk++) {
+      fSeleTrks->AddLast(new AliESDtrack(*(AliESDtrack*)fSeleTrksEvent->UncheckedAt(iTrk)));
+    }
+  }
+  ~CandidateLoopInput() {
+    fTwoTrackArray1.Delete();
+    fTwoTrackArray2.Delete();
+    fTwoTrackArrayCasc.Delete();
+    fTwoTrackArrayV0.Delete();
+    fThreeTrackArray.Clear();
+    fThreeTrackArray.Delete();
+    fFourTrackArray.Delete();
+    if(fThreaded) { fSeleTrks->Delete(); delete fSeleTrks; }
+  }
+
+  AliVEvent *fEvent;            ///< input event
+  TObjArray *fSeleTrks;         ///< selected tracks used in the loops
+  TObjArray *fSeleTrksEvent;    ///< selected tracks of the event (same as fSeleTrks without threads)
+  TObjArray *fTracksAtVertex;   ///< parameters of the selected tracks at the primary vertex
+  UChar_t   *fSeleFlags;        ///< selection bits of the selected tracks
+  Int_t     *fEvtNumber;        ///< event number of the selected tracks (mixing)
+  Int_t      fNSeleTrks;        ///< number of selected tracks
+  Int_t      fTrkEntries;       ///< number of tracks in the event
+  Int_t      fNV0s;             ///< number of V0s in the event
+  Float_t    fDcaMax;           ///< max. DCA between the tracks of a pair
+  Double_t   fMinPtV0;          ///< min. pt of the V0s for cascades
+  Bool_t     fThreaded;         ///< private copy of the tracks for a thread
+  TObjArray  fTwoTrackArray1;   ///< positive track 1 + negative track 1
+  TObjArray  fTwoTrackArray2;   ///< positive track 2 + negative track 1 (or 2)
+  TObjArray  fTwoTrackArrayV0;  ///< daughters of the ESD V0s
+  TObjArray  fTwoTrackArrayCasc;///< bachelor + V0 or soft pion + D0
+  TObjArray  fThreeTrackArray;  ///< 3-prong combination
+  TObjArray  fFourTrackArray;   ///< 4-prong combination
+  // table of the selected tracks for the kinematic prefilter of the 3 prongs
+  // (momenta at the primary vertex: pt, pz and p do not change in the propagation)
+  std::vector<Double_t> fTrkPt;      ///< pt of the selected tracks
+  std::vector<Double_t> fTrkPz;      ///< pz of the selected tracks
+  std::vector<Double_t> fTrkP;       ///< p of the selected tracks
+  std::vector<Double_t> fTrkE;       ///< energy with the pion, kaon and proton masses, at [3*iTrk+iHyp]
+  std::vector<Double_t> fMaxPtAfter; ///< max. pt of the 3-prong tracks with index >= iTrk
+  Double_t   fMinPt3Prong;      ///< min. pt of the 3-prong candidates
+  Double_t   fMinPtLc;          ///< min. pt of the Lc candidates
+  Double_t   fMassWindow2[6];   ///< squared mass windows (min,max) for D+, Ds and Lc, over all pt bins
+
+private:
+  CandidateLoopInput& operator=(const CandidateLoopInput &source);
+};
+//----------------------------------------------------------------------------
+/// Candidate found in the loops on tracks of FindCandidates, with the objects
+/// needed to store it in the output arrays. Without threads the objects are
+/// those of the loops; with threads they are copies owned by the record
+struct AliAnalysisVertexingHF::CandidateRecord {
+  enum ECandidateType {kCascade,k2Prong,kDstar,k3Prong,k4Prong};
+
+  CandidateRecord(ECandidateType type) :
+    fType(type),fCand(0x0),fVertex(0x0),fD0(0x0),fD0Vertex(0x0),fV0(0x0),
+    fNTracks(0),fOkD0(kFALSE),fOkJPSI(kFALSE),fLikeSign(kFALSE),fFlag(kFALSE),
+    fIndex(0),fOwner(kFALSE),fOwnV0(kFALSE) {
+    for(Int_t iTrk=0; iTrk<4; iTrk++) fTracks[iTrk]=0x0;
+    fD0Tracks[0]=0x0; fD0Tracks[1]=0x0;
+  }
+  void DeleteOwned() {
+    if(!fOwner) return;
+    delete fCand; fCand=0x0;
+    delete fVertex; fVertex=0x0;
+    delete fD0; fD0=0x0;
+    delete fD0Vertex; fD0Vertex=0x0;
+    if(fOwnV0) { delete fV0; fV0=0x0; }
+    if(fType==kCascade || fType==kDstar) { delete fTracks[1]; fTracks[1]=0x0; }
+    fOwner=kFALSE;
+  }
+
+  ECandidateType          fType;        ///< type of candidate
+  AliAODRecoDecayHF      *fCand;        ///< candidate
+  AliAODVertex           *fVertex;      ///< secondary vertex
+  AliAODRecoDecayHF2Prong *fD0;         ///< D0 of the D*
+  AliAODVertex           *fD0Vertex;    ///< vertex of the D0 of the D*
+  AliAODv0               *fV0;          ///< V0 of the cascade
+  AliExternalTrackParam  *fTracks[4];   ///< daughter tracks (references)
+  AliExternalTrackParam  *fD0Tracks[2]; ///< daughter tracks of the D0 of the D*
+  Int_t                   fNTracks;     ///< number of daughter tracks
+  Bool_t                  fOkD0;        ///< 2-prong: D0->Kpi candidate
+  Bool_t                  fOkJPSI;      ///< 2-prong: J/psi->ee candidate
+  Bool_t                  fLikeSign;    ///< like-sign candidate
+  Bool_t                  fFlag;        ///< D*: store also the D0; 3-prong: store the vertex twice
+  Int_t                   fIndex;       ///< cascade: index of the V0
+  Bool_t                  fOwner;       ///< the objects are copies owned by the record
+  Bool_t                  fOwnV0;       ///< the V0 is a copy owned by the record
+};
+//----------------------------------------------------------------------------
+/// Output arrays of FindCandidates and their number of entries
+struct AliAnalysisVertexingHF::CandidateOutput {
+  CandidateOutput() :
+    fEvent(0x0),fVerticesHF(0x0),fD0toKpi(0x0),fJPSItoEle(0x0),fCharm3Prong(0x0),
+    fCharm4Prong(0x0),fDstar(0x0),fCascades(0x0),fLikeSign2Prong(0x0),fLikeSign3Prong(0x0),
+    fNVerticesHF(0),fND0toKpi(0),fNJPSItoEle(0),fN3Prong(0),fN4Prong(0),fNDstar(0),
+    fNCascades(0),fNLikeSign2Prong(0),fNLikeSign3Prong(0),fLastStored(0x0) {}
+
+  AliVEvent    *fEvent;            ///< input event
+  TClonesArray *fVerticesHF;       ///< secondary vertices
+  TClonesArray *fD0toKpi;          ///< D0->Kpi
+  TClonesArray *fJPSItoEle;        ///< J/psi->ee
+  TClonesArray *fCharm3Prong;      ///< 3 prongs
+  TClonesArray *fCharm4Prong;      ///< 4 prongs
+  TClonesArray *fDstar;            ///< D*
+  TClonesArray *fCascades;         ///< V0 + track
+  TClonesArray *fLikeSign2Prong;   ///< like-sign 2 prongs
+  TClonesArray *fLikeSign3Prong;   ///< like-sign 3 prongs
+  Int_t fNVerticesHF;              ///< number of entries in fVerticesHF
+  Int_t fND0toKpi;                 ///< number of entries in fD0toKpi
+  Int_t fNJPSItoEle;               ///< number of entries in fJPSItoEle
+  Int_t fN3Prong;                  ///< number of entries in fCharm3Prong
+  Int_t fN4Prong;                  ///< number of entries in fCharm4Prong
+  Int_t fNDstar;                   ///< number of entries in fDstar
+  Int_t fNCascades;                ///< number of entries in fCascades
+  Int_t fNLikeSign2Prong;          ///< number of entries in fLikeSign2Prong
+  Int_t fNLikeSign3Prong;          ///< number of entries in fLikeSign3Prong
+  AliAODRecoDecayHF *fLastStored;  ///< last decay stored (the D0 referenced by the D* vertex)
+};
+//----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 					    TClonesArray *aodVerticesHFTClArr,
 					    TClonesArray *aodD0toKpiTClArr,
@@ -508,70 +687,56 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     return;
   }
 
-  // delete candidates from previous event and create references
-  Int_t iVerticesHF=0,iD0toKpi=0,iJPSItoEle=0,i3Prong=0,i4Prong=0,iDstar=0,iCascades=0,iLikeSign2Prong=0,iLikeSign3Prong=0;
+  // delete candidates from previous event
+  CandidateOutput out;
+  out.fEvent = event;
   aodVerticesHFTClArr->Delete();
-  iVerticesHF = aodVerticesHFTClArr->GetEntriesFast();
-  TClonesArray &verticesHFRef = *aodVerticesHFTClArr;
+  out.fNVerticesHF = aodVerticesHFTClArr->GetEntriesFast();
   if(fD0toKpi || fDstar)   {
     aodD0toKpiTClArr->Delete();
-    iD0toKpi = aodD0toKpiTClArr->GetEntriesFast();
+    out.fND0toKpi = aodD0toKpiTClArr->GetEntriesFast();
   }
   if(fJPSItoEle) {
     aodJPSItoEleTClArr->Delete();
-    iJPSItoEle = aodJPSItoEleTClArr->GetEntriesFast();
+    out.fNJPSItoEle = aodJPSItoEleTClArr->GetEntriesFast();
   }
   if(f3Prong) {
     aodCharm3ProngTClArr->Delete();
-    i3Prong = aodCharm3ProngTClArr->GetEntriesFast();
+    out.fN3Prong = aodCharm3ProngTClArr->GetEntriesFast();
   }
   if(f4Prong) {
     aodCharm4ProngTClArr->Delete();
-    i4Prong = aodCharm4ProngTClArr->GetEntriesFast();
+    out.fN4Prong = aodCharm4ProngTClArr->GetEntriesFast();
   }
   if(fDstar) {
     aodDstarTClArr->Delete();
-    iDstar = aodDstarTClArr->GetEntriesFast();
+    out.fNDstar = aodDstarTClArr->GetEntriesFast();
   }
   if(fCascades) {
     aodCascadesTClArr->Delete();
-    iCascades = aodCascadesTClArr->GetEntriesFast();
+    out.fNCascades = aodCascadesTClArr->GetEntriesFast();
   }
   if(fLikeSign) {
     aodLikeSign2ProngTClArr->Delete();
-    iLikeSign2Prong = aodLikeSign2ProngTClArr->GetEntriesFast();
+    out.fNLikeSign2Prong = aodLikeSign2ProngTClArr->GetEntriesFast();
   }
   if(fLikeSign3prong && f3Prong) {
     aodLikeSign3ProngTClArr->Delete();
-    iLikeSign3Prong = aodLikeSign3ProngTClArr->GetEntriesFast();
+    out.fNLikeSign3Prong = aodLikeSign3ProngTClArr->GetEntriesFast();
   }
 
-  TClonesArray &aodD0toKpiRef        = *aodD0toKpiTClArr;
-  TClonesArray &aodJPSItoEleRef      = *aodJPSItoEleTClArr;
-  TClonesArray &aodCharm3ProngRef    = *aodCharm3ProngTClArr;
-  TClonesArray &aodCharm4ProngRef    = *aodCharm4ProngTClArr;
-  TClonesArray &aodDstarRef          = *aodDstarTClArr;
-  TClonesArray &aodCascadesRef       = *aodCascadesTClArr;
-  TClonesArray &aodLikeSign2ProngRef = *aodLikeSign2ProngTClArr;
-  TClonesArray &aodLikeSign3ProngRef = *aodLikeSign3ProngTClArr;
-
+  out.fVerticesHF     = aodVerticesHFTClArr;
+  out.fD0toKpi        = aodD0toKpiTClArr;
+  out.fJPSItoEle      = aodJPSItoEleTClArr;
+  out.fCharm3Prong    = aodCharm3ProngTClArr;
+  out.fCharm4Prong    = aodCharm4ProngTClArr;
+  out.fDstar          = aodDstarTClArr;
+  out.fCascades       = aodCascadesTClArr;
+  out.fLikeSign2Prong = aodLikeSign2ProngTClArr;
+  out.fLikeSign3Prong = aodLikeSign3ProngTClArr;
 
-  AliAODRecoDecayHF2Prong *io2Prong  = 0;
-  AliAODRecoDecayHF3Prong *io3Prong  = 0;
-  AliAODRecoDecayHF4Prong *io4Prong  = 0;
-  AliAODRecoCascadeHF     *ioCascade = 0;
 
-  Int_t    iTrkP1,iTrkP2,iTrkN1,iTrkN2,iTrkSoftPi,trkEntries,iv0,nv0;
-  Double_t xdummy,ydummy,dcap1n1,dcap1n2,dcap2n1,dcap1p2,dcan1n2,dcap2n2,dcaCasc;
-  Bool_t   okD0=kFALSE,okJPSI=kFALSE,ok3Prong=kFALSE,ok4Prong=kFALSE;
-  Bool_t   okDstar=kFALSE,okD0fromDstar=kFALSE;
-  Bool_t   okCascades=kFALSE;
-  AliESDtrack *postrack1 = 0;
-  AliESDtrack *postrack2 = 0;
-  AliESDtrack *negtrack1 = 0;
-  AliESDtrack *negtrack2 = 0;
-  AliESDtrack *trackPi   = 0;
-  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
+  Int_t    trkEntries,nv0;
   Float_t dcaMax = fCutsD0toKpi->GetDCACut();
   if(fCutsJpsitoee) dcaMax=TMath::Max(dcaMax,fCutsJpsitoee->GetDCACut());
   if(fCutsDplustoKpipi) dcaMax=TMath::Max(dcaMax,fCutsDplustoKpipi->GetDCACut());
@@ -630,23 +795,6 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   fnSeleTrksTotal += nSeleTrks;
 
 
-  TObjArray *twoTrackArray1    = new TObjArray(2);
-  TObjArray *twoTrackArray2    = new TObjArray(2);
-  TObjArray *twoTrackArrayV0   = new TObjArray(2);
-  TObjArray *twoTrackArrayCasc = new TObjArray(2);
-  TObjArray *threeTrackArray   = new TObjArray(3);
-  TObjArray *fourTrackArray    = new TObjArray(4);
-
-  Double_t dispersion;
-  Bool_t isLikeSign2Prong=kFALSE,isLikeSign3Prong=kFALSE;
-
-  AliAODRecoDecayHF   *rd = 0;
-  AliAODRecoCascadeHF *rc = 0;
-  AliAODv0            *v0 = 0;
-  AliESDv0         *esdV0 = 0;
-
-  Bool_t massCutOK=kTRUE;
-  
   fMinPt3Prong=0.;
   fMinPt3Prong=TMath::Min(fCutsDplustoKpipi->GetMinPtCandidate(),fCutsDstoKKpi->GetMinPtCandidate());
   fMinPt3Prong=TMath::Min(fMinPt3Prong,fCutsLctopKpi->GetMinPtCandidate());
@@ -662,14 +810,137 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     if(minPtV0fromDp<minPtV0) minPtV0=minPtV0fromDp;
   }
    
+  // LOOPS ON TRACKS (positive tracks split over threads if requested)
+  CandidateLoopInput *loopInput = new CandidateLoopInput(event,&seleTrksArray,&tracksAtVertex,
+							  seleFlags,evtNumber,nSeleTrks,
+							  trkEntries,nv0,dcaMax,minPtV0);
+  if(fKinematicPrefilter3Prong && f3Prong) FillTrackTable(*loopInput);
+  if(fNThreadsForCandidates>1 && nSeleTrks>1) {
+    FindCandidatesInThreads(*loopInput,out);
+  } else {
+    FindCandidatesForPositiveTracks(0,nSeleTrks,*loopInput,&out,0x0);
+  }
+
+
+  //  AliDebug(1,Form(" Total HF vertices in event = %d;",
+  //		  (Int_t)aodVerticesHFTClArr->GetEntriesFast()));
+  if(fD0toKpi) {
+    AliDebug(1,Form(" D0->Kpi in event = %d;",
+		    (Int_t)aodD0toKpiTClArr->GetEntriesFast()));
+  }
+  if(fJPSItoEle) {
+    AliDebug(1,Form(" JPSI->ee in event = %d;",
+		    (Int_t)aodJPSItoEleTClArr->GetEntriesFast()));
+  }
+  if(f3Prong) {
+    AliDebug(1,Form(" Charm->3Prong in event = %d;",
+		    (Int_t)aodCharm3ProngTClArr->GetEntriesFast()));
+  }
+  if(f4Prong) {
+    AliDebug(1,Form(" Charm->4Prong in event = %d;\n",
+		    (Int_t)aodCharm4ProngTClArr->GetEntriesFast()));
+  }
+  if(fDstar) {
+    AliDebug(1,Form(" D*->D0pi in event = %d;\n",
+		    (Int_t)aodDstarTClArr->GetEntriesFast()));
+  }
+  if(fCascades){
+    AliDebug(1,Form(" cascades -> v0 + track in event = %d;\n",
+		    (Int_t)aodCascadesTClArr->GetEntriesFast()));
+  }
+  if(fLikeSign) {
+    AliDebug(1,Form(" Like-sign 2Prong in event = %d;\n",
+		    (Int_t)aodLikeSign2ProngTClArr->GetEntriesFast()));
+  }
+  if(fLikeSign3prong && f3Prong) {
+    AliDebug(1,Form(" Like-sign 3Prong in event = %d;\n",
+		    (Int_t)aodLikeSign3ProngTClArr->GetEntriesFast()));
+  }
+
+
+  delete loopInput; loopInput=NULL;
+  delete [] seleFlags; seleFlags=NULL;
+  if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
+  tracksAtVertex.Delete();
+
+  if(fInputAOD) {
+    seleTrksArray.Delete();
+    if(fAODMap) { delete [] fAODMap; fAODMap=NULL; }
+  }
+
+
+  //printf("Trks: total %d  sele %d\n",fnTrksTotal,fnSeleTrksTotal);
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FindCandidatesForPositiveTracks(Int_t firstTrkP1,Int_t lastTrkP1,
+							      CandidateLoopInput &in,
+							      CandidateOutput *out,
+							      std::vector<CandidateRecord> *records)
+{
+  /// Loops on tracks of FindCandidates for the positive tracks from
+  /// firstTrkP1 to lastTrkP1-1: the candidates are stored in the output
+  /// arrays (out) or, with threads, collected in records
+  //AliCodeTimerAuto("",0);
+
+  AliVEvent *event           = in.fEvent;
+  TObjArray &seleTrksArray   = *in.fSeleTrks;
+  TObjArray &seleTrksEvent   = *in.fSeleTrksEvent;
+  TObjArray &tracksAtVertex  = *in.fTracksAtVertex;
+  UChar_t   *seleFlags       = in.fSeleFlags;
+  Int_t     *evtNumber       = in.fEvtNumber;
+  Int_t      nSeleTrks       = in.fNSeleTrks;
+  Int_t      trkEntries      = in.fTrkEntries;
+  Int_t      nv0             = in.fNV0s;
+  Float_t    dcaMax          = in.fDcaMax;
+  Double_t   minPtV0         = in.fMinPtV0;
+
+  AliAODRecoDecayHF2Prong *io2Prong  = 0;
+  AliAODRecoDecayHF3Prong *io3Prong  = 0;
+  AliAODRecoDecayHF4Prong *io4Prong  = 0;
+  AliAODRecoCascadeHF     *ioCascade = 0;
+
+  Int_t    iTrkP1,iTrkP2,iTrkN1,iTrkN2,iTrkSoftPi,iv0;
+  Double_t xdummy,ydummy,dcap1n1,dcap1n2,dcap2n1,dcap1p2,dcan1n2,dcap2n2,dcaCasc;
+  Bool_t   okD0=kFALSE,okJPSI=kFALSE,ok3Prong=kFALSE,ok4Prong=kFALSE;
+  Bool_t   okDstar=kFALSE,okD0fromDstar=kFALSE;
+  Bool_t   okCascades=kFALSE;
+  AliESDtrack *postrack1 = 0;
+  AliESDtrack *postrack2 = 0;
+  AliESDtrack *negtrack1 = 0;
+  AliESDtrack *negtrack2 = 0;
+  AliESDtrack *trackPi   = 0;
+  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
+
+  TObjArray *twoTrackArray1    = &in.fTwoTrackArray1;
+  TObjArray *twoTrackArray2    = &in.fTwoTrackArray2;
+  TObjArray *twoTrackArrayV0   = &in.fTwoTrackArrayV0;
+  TObjArray *twoTrackArrayCasc = &in.fTwoTrackArrayCasc;
+  TObjArray *threeTrackArray   = &in.fThreeTrackArray;
+  TObjArray *fourTrackArray    = &in.fFourTrackArray;
+
+  Double_t dispersion;
+  Bool_t isLikeSign2Prong=kFALSE,isLikeSign3Prong=kFALSE;
+
+  AliAODv0            *v0 = 0;
+  AliESDv0         *esdV0 = 0;
+
+  Bool_t massCutOK=kTRUE;
   // LOOP ON  POSITIVE  TRACKS
-  for(iTrkP1=0; iTrkP1<nSeleTrks; iTrkP1++) {
+  for(iTrkP1=firstTrkP1; iTrkP1<lastTrkP1; iTrkP1++) {
 
     //if(iTrkP1%1==0) AliDebug(1,Form("  1st loop on pos: track number %d of %d",iTrkP1,nSeleTrks));
     //if(iTrkP1%1==0) printf("  1st loop on pos: track number %d of %d\n",iTrkP1,nSeleTrks);
 
     // get track from tracks array
     postrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP1);
+    // in threads, the tracks restart from their parameters at the primary vertex
+    // for each positive track, so that the candidates do not depend on the
+    // positive tracks processed before by the same thread
+    if(in.fThreaded) {
+      for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) SetParametersAtVertex((AliESDtrack*)seleTrksArray.UncheckedAt(iTrk),(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrk));
+    }
     postrack1->GetPxPyPz(mompos1);
 
     // Make cascades with V0+track
@@ -737,10 +1008,18 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
           if (posVV0track->GetKinkIndex(0)>0  || negVV0track->GetKinkIndex(0)>0) continue;
 
           // Define the AODv0 from ESDv0 if reading ESDs
+	if(in.fThreaded) {
+	  // the tracks of the event are shared by the threads, propagate copies
+	  twoTrackArrayV0->AddAt(new AliExternalTrackParam(*posVV0track),0);
+	  twoTrackArrayV0->AddAt(new AliExternalTrackParam(*negVV0track),1);
+	  v0 = TransformESDv0toAODv0(esdV0,twoTrackArrayV0);
+	  twoTrackArrayV0->Delete();
+	} else {
 	  twoTrackArrayV0->AddAt(posVV0track,0);
 	  twoTrackArrayV0->AddAt(negVV0track,1);
           v0 = TransformESDv0toAODv0(esdV0,twoTrackArrayV0);
 	  twoTrackArrayV0->Clear();
+	}
         }
 
         // Define the V0 (neutral) track
@@ -797,20 +1076,15 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
         if(okCascades && ioCascade) {
           //AliDebug(1,Form("Storing a cascade object... "));
           // add the vertex and the cascade to the AOD
-          rc = new(aodCascadesRef[iCascades++])AliAODRecoCascadeHF(*ioCascade);
-          if(fMakeReducedRHF){
-            UShort_t id[2]={(UShort_t)postrack1->GetID(),(UShort_t)iv0};
-            rc->SetProngIDs(2,id);
-            rc->DeleteRecoD();
-          }else{
-            AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
-            rc->SetSecondaryVtx(vCasc);
-            vCasc->SetParent(rc);
-            if(!fInputAOD) vCasc->AddDaughter(v0); // just to fill ref #0 ??
-            AddRefs(vCasc,rc,event,twoTrackArrayCasc); // add the track (proton)
-            vCasc->AddDaughter(v0); // fill the 2prong V0
-          }
-          rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+          CandidateRecord rec(CandidateRecord::kCascade);
+          rec.fCand = ioCascade;
+          rec.fVertex = vertexCasc;
+          rec.fV0 = v0;
+          rec.fTracks[0] = postrack1;
+          rec.fTracks[1] = trackV0;
+          rec.fNTracks = 2;
+          rec.fIndex = iv0;
+          EmitCandidate(rec,out,records);
         }
 
 
@@ -895,45 +1169,16 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	if((fD0toKpi && okD0) || (fJPSItoEle && okJPSI) || (isLikeSign2Prong && (okD0 || okJPSI))) {
 	  // add the vertex and the decay to the AOD
-          AliAODVertex *v2Prong =0x0;
-          if(!fMakeReducedRHF)v2Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
-	  if(!isLikeSign2Prong) {
-	    if(okD0) {
-	      rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
-	      SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
-
-              if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-              }else{
-		rd->SetSecondaryVtx(v2Prong);
-		v2Prong->SetParent(rd);
-		AddRefs(v2Prong,rd,event,twoTrackArray1);
-              }
-	    }
-	    if(okJPSI) {
-	      rd = new(aodJPSItoEleRef[iJPSItoEle++])AliAODRecoDecayHF2Prong(*io2Prong);
-	      if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-		if(!okD0) v2Prong->SetParent(rd); // it cannot have two mothers ...
-		AddRefs(v2Prong,rd,event,twoTrackArray1);
-              }
-	    }
-	  } else { // isLikeSign2Prong
-	    rd = new(aodLikeSign2ProngRef[iLikeSign2Prong++])AliAODRecoDecayHF2Prong(*io2Prong);
-	    //Set selection bit for PID
-	    if(okD0) SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
-	    if(fMakeReducedRHF){
-	      rd->DeleteRecoD();
-	      rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	    }else{
-	      rd->SetSecondaryVtx(v2Prong);
-	      v2Prong->SetParent(rd);
-	      AddRefs(v2Prong,rd,event,twoTrackArray1);
-	    }
-	  }
+	  CandidateRecord rec(CandidateRecord::k2Prong);
+	  rec.fCand = io2Prong;
+	  rec.fVertex = vertexp1n1;
+	  rec.fTracks[0] = postrack1;
+	  rec.fTracks[1] = negtrack1;
+	  rec.fNTracks = 2;
+	  rec.fOkD0 = okD0;
+	  rec.fOkJPSI = okJPSI;
+	  rec.fLikeSign = isLikeSign2Prong;
+	  EmitCandidate(rec,out,records);
 	}
 	// D* candidates
 	if(fDstar && okD0fromDstar && !isLikeSign2Prong) {
@@ -941,8 +1186,8 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  if(fInputAOD) {
 	    AddDaughterRefs(vertexp1n1,event,twoTrackArray1);
 	  } else {
-	    vertexp1n1->AddDaughter(postrack1);
-	    vertexp1n1->AddDaughter(negtrack1);
+	    vertexp1n1->AddDaughter(seleTrksEvent.UncheckedAt(iTrkP1));
+	    vertexp1n1->AddDaughter(seleTrksEvent.UncheckedAt(iTrkN1));
 	  }
 	  io2Prong->SetSecondaryVtx(vertexp1n1);
           //printf("--->  %d %d %d %d %d\n",vertexp1n1->GetNDaughters(),iTrkP1,iTrkN1,postrack1->Charge(),negtrack1->Charge());
@@ -1003,38 +1248,20 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
             ioCascade = MakeCascade(twoTrackArrayCasc,event,vertexCasc,io2Prong,dcaCasc,okDstar);
             if(okDstar) {
-	      // add the D0 to the AOD (if not already done)
-	      if(!okD0) {
-	        rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
-                 if(fMakeReducedRHF){
-		   rd->DeleteRecoD();
-		   rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	         }else{
-		   AliAODVertex *v2Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
-		   rd->SetSecondaryVtx(v2Prong);
-		   v2Prong->SetParent(rd);
-		   AddRefs(v2Prong,rd,event,twoTrackArray1);
-                 }
-        	okD0=kTRUE; // this is done to add it only once
-	      }
-	      // add the vertex and the cascade to the AOD
-	      rc = new(aodDstarRef[iDstar++])AliAODRecoCascadeHF(*ioCascade);
-	      // Set selection bit for PID
-	      SetSelectionBitForPID(fCutsDStartoKpipi,rc,AliRDHFCuts::kDstarPID);
-	      if(fMakeReducedRHF){
-		//assign a ID to the D0 candidate, daughter of the Cascade. ID = position in the D0toKpi array
-		UShort_t idCasc[2]={(UShort_t)trackPi->GetID(),(UShort_t)(iD0toKpi-1)};
-		rc->SetProngIDs(2,idCasc);
-		rc->DeleteRecoD();
-		rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-		AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
-		rc->SetSecondaryVtx(vCasc);
-		vCasc->SetParent(rc);
-		if(!fInputAOD) vCasc->AddDaughter(rd); // just to fill ref #0
-		AddRefs(vCasc,rc,event,twoTrackArrayCasc);
-		vCasc->AddDaughter(rd); // add the D0 (in ref #1)
-	      }
+	      // add the vertex and the cascade to the AOD, with the D0 if not already done
+	      CandidateRecord rec(CandidateRecord::kDstar);
+	      rec.fCand = ioCascade;
+	      rec.fVertex = vertexCasc;
+	      rec.fTracks[0] = trackPi;
+	      rec.fTracks[1] = trackD0;
+	      rec.fNTracks = 2;
+	      rec.fFlag = !okD0;
+	      rec.fD0 = io2Prong;
+	      rec.fD0Vertex = vertexp1n1;
+	      rec.fD0Tracks[0] = postrack1;
+	      rec.fD0Tracks[1] = negtrack1;
+	      EmitCandidate(rec,out,records);
+        	okD0=kTRUE; // this is done to add the D0 only once
             }
 	    twoTrackArrayCasc->Clear();
 	    trackPi=0;
@@ -1057,8 +1284,18 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       }
 
 
+      // kinematic prefilter: no third track gives a 3 prong above the min. pt
+      Int_t lastTrk3Prong=nSeleTrks;
+      if(fKinematicPrefilter3Prong && f3Prong) {
+	Int_t firstTrk3=TMath::Min(iTrkP1,iTrkN1)+1;
+	if(in.fTrkPt[iTrkP1]+in.fTrkPt[iTrkN1]+in.fMaxPtAfter[firstTrk3]+kPrefilterTolerance<in.fMinPt3Prong) {
+	  fNCombinations[kPairsPrunedPt]++;
+	  lastTrk3Prong=0;
+	}
+      }
+
       // 2nd LOOP  ON  POSITIVE  TRACKS
-      for(iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
+      for(iTrkP2=iTrkP1+1; iTrkP2<(f4Prong ? nSeleTrks : lastTrk3Prong); iTrkP2++) {
 
 	if(iTrkP2==iTrkP1 || iTrkP2==iTrkN1) continue;
 
@@ -1129,6 +1366,11 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat) &&
 	     !TESTBIT(seleFlags[iTrkP2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
 	}
+	fNCombinations[kTriplets3Prong]++;
+	if(fKinematicPrefilter3Prong && f3Prong && !f4Prong) {
+	  Int_t stage=KinematicPrefilter3Prong(in,iTrkP1,iTrkN1,iTrkP2);
+	  if(stage!=kTriplets3Prong) { fNCombinations[stage]++; postrack2=0; continue; }
+	}
 	// back to primary vertex
 	//	postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
 	//	postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
@@ -1140,9 +1382,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
 	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
-	if(dcap2n1>dcaMax) { postrack2=0; continue; }
+	if(dcap2n1>dcaMax) { fNCombinations[kTripletsPrunedDCA]++; postrack2=0; continue; }
 	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
-	if(dcap1p2>dcaMax) { postrack2=0; continue; }
+	if(dcap1p2>dcaMax) { fNCombinations[kTripletsPrunedDCA]++; postrack2=0; continue; }
 
 	// check invariant mass cuts for D+,Ds,Lc
         massCutOK=kTRUE;
@@ -1167,6 +1409,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	}
 
 	if(f3Prong && !massCutOK) {
+	  fNCombinations[kTripletsPrunedMassCut]++;
 	  threeTrackArray->Clear();
 	  if(!f4Prong) {
 	    postrack2=0;
@@ -1181,44 +1424,19 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	// 3 prong candidates
 	if(f3Prong && massCutOK) {
 	  
+	  fNCombinations[kTripletsVertexed]++;
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
-            AliAODVertex *v3Prong=0x0;
-	    if(!fMakeReducedRHF)v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-	    if(!isLikeSign3Prong) {
-	      rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	      // Set selection bit for PID
-	      SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	      SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	      SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	      if(fMakeReducedRHF){
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	      }else{
-                v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-		rd->SetSecondaryVtx(v3Prong);
-		v3Prong->SetParent(rd);
-		AddRefs(v3Prong,rd,event,threeTrackArray);
-	      }
-	    } else { // isLikeSign3Prong
-	      if(fLikeSign3prong){
-		rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	        // Set selection bit for PID
-	        SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	        SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	        SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-                if(fMakeReducedRHF){
-		  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                  ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-		}else{
-		  rd->SetSecondaryVtx(v3Prong);
-		  v3Prong->SetParent(rd);
-		  AddRefs(v3Prong,rd,event,threeTrackArray);
-                }
-	      }
-	    }
-
+	    // add the vertex and the decay to the AOD
+	    CandidateRecord rec(CandidateRecord::k3Prong);
+	    rec.fCand = io3Prong;
+	    rec.fVertex = secVert3PrAOD;
+	    for(Int_t iTrk=0; iTrk<3; iTrk++) rec.fTracks[iTrk] = (AliExternalTrackParam*)threeTrackArray->UncheckedAt(iTrk);
+	    rec.fNTracks = 3;
+	    rec.fLikeSign = isLikeSign3Prong;
+	    rec.fFlag = kTRUE; // second copy of the vertex, the +-+ triplets store it twice (the -+- ones once)
+	    EmitCandidate(rec,out,records);
 	  }
 	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
 	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
@@ -1303,16 +1521,13 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    AliAODVertex* secVert4PrAOD = ReconstructSecondaryVertex(fourTrackArray,dispersion);
 	    io4Prong = Make4Prong(fourTrackArray,event,secVert4PrAOD,vertexp1n1,vertexp1n1p2,dcap1n1,dcap1n2,dcap2n1,dcap2n2,ok4Prong);
 	    if(ok4Prong) {
-	      rd = new(aodCharm4ProngRef[i4Prong++])AliAODRecoDecayHF4Prong(*io4Prong);
-	      if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-                AliAODVertex *v4Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert4PrAOD);
-		rd->SetSecondaryVtx(v4Prong);
-		v4Prong->SetParent(rd);
-		AddRefs(v4Prong,rd,event,fourTrackArray);
-	      }
+	      // add the vertex and the decay to the AOD
+	      CandidateRecord rec(CandidateRecord::k4Prong);
+	      rec.fCand = io4Prong;
+	      rec.fVertex = secVert4PrAOD;
+	      for(Int_t iTrk=0; iTrk<4; iTrk++) rec.fTracks[iTrk] = (AliExternalTrackParam*)fourTrackArray->UncheckedAt(iTrk);
+	      rec.fNTracks = 4;
+	      EmitCandidate(rec,out,records);
             }
 
 	    if(io4Prong) {delete io4Prong; io4Prong=NULL;}
@@ -1334,7 +1549,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       twoTrackArray2->Clear();
 
       // 2nd LOOP  ON  NEGATIVE  TRACKS (for 3 prong -+-)
-      for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
+      for(iTrkN2=iTrkN1+1; iTrkN2<lastTrk3Prong; iTrkN2++) {
 
 	if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
 
@@ -1400,6 +1615,11 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat) &&
 	     !TESTBIT(seleFlags[iTrkN2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
 	}
+	fNCombinations[kTriplets3Prong]++;
+	if(fKinematicPrefilter3Prong && f3Prong) {
+	  Int_t stage=KinematicPrefilter3Prong(in,iTrkN1,iTrkP1,iTrkN2);
+	  if(stage!=kTriplets3Prong) { fNCombinations[stage]++; negtrack2=0; continue; }
+	}
 
 	// back to primary vertex
 	// postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
@@ -1411,9 +1631,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
 	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
+	if(dcap1n2>dcaMax) { fNCombinations[kTripletsPrunedDCA]++; negtrack2=0; continue; }
 	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
+	if(dcan1n2>dcaMax) { fNCombinations[kTripletsPrunedDCA]++; negtrack2=0; continue; }
 
 	threeTrackArray->AddAt(negtrack1,0);
 	threeTrackArray->AddAt(postrack1,1);
@@ -1430,6 +1650,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
 	}
 	if(!massCutOK) {
+	  fNCombinations[kTripletsPrunedMassCut]++;
 	  threeTrackArray->Clear();
 	  negtrack2=0;
 	  continue;
@@ -1440,41 +1661,18 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	twoTrackArray2->AddAt(negtrack2,1);
 
 	if(f3Prong) {
+	  fNCombinations[kTripletsVertexed]++;
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
-	    AliAODVertex *v3Prong = 0x0;
-            if(!fMakeReducedRHF) v3Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-	    if(!isLikeSign3Prong) {
-	      rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	      SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	      SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	      SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	      if(fMakeReducedRHF){
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	      }else{
-		rd->SetSecondaryVtx(v3Prong);
-		v3Prong->SetParent(rd);
-		AddRefs(v3Prong,rd,event,threeTrackArray);
-              }
-	    } else { // isLikeSign3Prong
-	      if(fLikeSign3prong){
-		rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	        SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	        SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	        SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	        if(fMakeReducedRHF){
-		  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                  ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	        }else{
-                  rd->SetSecondaryVtx(v3Prong);
-                  v3Prong->SetParent(rd);
-                  AddRefs(v3Prong,rd,event,threeTrackArray);
-		}
-	      }
-
-	    }
+	    // add the vertex and the decay to the AOD
+	    CandidateRecord rec(CandidateRecord::k3Prong);
+	    rec.fCand = io3Prong;
+	    rec.fVertex = secVert3PrAOD;
+	    for(Int_t iTrk=0; iTrk<3; iTrk++) rec.fTracks[iTrk] = (AliExternalTrackParam*)threeTrackArray->UncheckedAt(iTrk);
+	    rec.fNTracks = 3;
+	    rec.fLikeSign = isLikeSign3Prong;
+	    EmitCandidate(rec,out,records);
 	  }
 	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
 	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
@@ -1493,61 +1691,475 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     postrack1 = 0;
  }  // end 1st loop on positive tracks
 
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::EmitCandidate(CandidateRecord &rec,CandidateOutput *out,
+					   std::vector<CandidateRecord> *records)
+{
+  /// Store a candidate found in the loops on tracks in the output arrays or,
+  /// with threads, keep a copy of it to be stored after the loops
 
-  //  AliDebug(1,Form(" Total HF vertices in event = %d;",
-  //		  (Int_t)aodVerticesHFTClArr->GetEntriesFast()));
-  if(fD0toKpi) {
-    AliDebug(1,Form(" D0->Kpi in event = %d;",
-		    (Int_t)aodD0toKpiTClArr->GetEntriesFast()));
+  if(out) {
+    StoreCandidate(rec,*out);
+    return;
   }
-  if(fJPSItoEle) {
-    AliDebug(1,Form(" JPSI->ee in event = %d;",
-		    (Int_t)aodJPSItoEleTClArr->GetEntriesFast()));
+
+  // the candidate, the vertices and the neutral tracks are deleted in the loops
+  switch(rec.fType) {
+  case CandidateRecord::kCascade:
+  case CandidateRecord::kDstar:
+    rec.fCand = new AliAODRecoCascadeHF(*(AliAODRecoCascadeHF*)rec.fCand);
+    break;
+  case CandidateRecord::k2Prong:
+    rec.fCand = new AliAODRecoDecayHF2Prong(*(AliAODRecoDecayHF2Prong*)rec.fCand);
+    break;
+  case CandidateRecord::k3Prong:
+    rec.fCand = new AliAODRecoDecayHF3Prong(*(AliAODRecoDecayHF3Prong*)rec.fCand);
+    break;
+  case CandidateRecord::k4Prong:
+    rec.fCand = new AliAODRecoDecayHF4Prong(*(AliAODRecoDecayHF4Prong*)rec.fCand);
+    break;
+  }
+  if(rec.fVertex) rec.fVertex = new AliAODVertex(*rec.fVertex);
+  if(rec.fType==CandidateRecord::kDstar && rec.fFlag) {
+    rec.fD0 = new AliAODRecoDecayHF2Prong(*rec.fD0);
+    rec.fD0Vertex = new AliAODVertex(*rec.fD0Vertex);
+  } else {
+    rec.fD0 = 0x0;
+    rec.fD0Vertex = 0x0;
   }
-  if(f3Prong) {
-    AliDebug(1,Form(" Charm->3Prong in event = %d;",
-		    (Int_t)aodCharm3ProngTClArr->GetEntriesFast()));
+  if(rec.fV0 && !fInputAOD) {
+    rec.fV0 = new AliAODv0(*rec.fV0);
+    rec.fOwnV0 = kTRUE;
   }
-  if(f4Prong) {
-    AliDebug(1,Form(" Charm->4Prong in event = %d;\n",
-		    (Int_t)aodCharm4ProngTClArr->GetEntriesFast()));
+  if((rec.fType==CandidateRecord::kCascade || rec.fType==CandidateRecord::kDstar) && rec.fTracks[1]) {
+    rec.fTracks[1] = new AliNeutralTrackParam(*(AliNeutralTrackParam*)rec.fTracks[1]);
   }
-  if(fDstar) {
-    AliDebug(1,Form(" D*->D0pi in event = %d;\n",
-		    (Int_t)aodDstarTClArr->GetEntriesFast()));
+  rec.fOwner = kTRUE;
+  records->push_back(rec);
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::StoreCandidate(const CandidateRecord &rec,CandidateOutput &out)
+{
+  /// Add a candidate and its secondary vertex to the output arrays
+  //AliCodeTimerAuto("",0);
+
+  AliVEvent *event = out.fEvent;
+  TClonesArray &verticesHFRef        = *out.fVerticesHF;
+  TClonesArray &aodD0toKpiRef        = *out.fD0toKpi;
+  TClonesArray &aodJPSItoEleRef      = *out.fJPSItoEle;
+  TClonesArray &aodCharm3ProngRef    = *out.fCharm3Prong;
+  TClonesArray &aodCharm4ProngRef    = *out.fCharm4Prong;
+  TClonesArray &aodDstarRef          = *out.fDstar;
+  TClonesArray &aodCascadesRef       = *out.fCascades;
+  TClonesArray &aodLikeSign2ProngRef = *out.fLikeSign2Prong;
+  TClonesArray &aodLikeSign3ProngRef = *out.fLikeSign3Prong;
+  Int_t &iVerticesHF     = out.fNVerticesHF;
+  Int_t &iD0toKpi        = out.fND0toKpi;
+  Int_t &iJPSItoEle      = out.fNJPSItoEle;
+  Int_t &i3Prong         = out.fN3Prong;
+  Int_t &i4Prong         = out.fN4Prong;
+  Int_t &iDstar          = out.fNDstar;
+  Int_t &iCascades       = out.fNCascades;
+  Int_t &iLikeSign2Prong = out.fNLikeSign2Prong;
+  Int_t &iLikeSign3Prong = out.fNLikeSign3Prong;
+
+  AliAODRecoDecayHF   *&rd = out.fLastStored;
+  AliAODRecoCascadeHF *rc = 0;
+
+  TObjArray trkArray(rec.fNTracks);
+  for(Int_t iTrk=0; iTrk<rec.fNTracks; iTrk++) trkArray.AddAt(rec.fTracks[iTrk],iTrk);
+
+  switch(rec.fType) {
+  case CandidateRecord::kCascade: {
+    AliAODRecoCascadeHF *ioCascade = (AliAODRecoCascadeHF*)rec.fCand;
+    rc = new(aodCascadesRef[iCascades++])AliAODRecoCascadeHF(*ioCascade);
+    if(fMakeReducedRHF){
+      UShort_t id[2]={(UShort_t)rec.fTracks[0]->GetID(),(UShort_t)rec.fIndex};
+      rc->SetProngIDs(2,id);
+      rc->DeleteRecoD();
+    }else{
+      AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+      rc->SetSecondaryVtx(vCasc);
+      vCasc->SetParent(rc);
+      if(!fInputAOD) vCasc->AddDaughter(rec.fV0); // just to fill ref #0 ??
+      AddRefs(vCasc,rc,event,&trkArray); // add the track (proton)
+      vCasc->AddDaughter(rec.fV0); // fill the 2prong V0
+    }
+    rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+    break;
+  }
+  case CandidateRecord::k2Prong: {
+    AliAODRecoDecayHF2Prong *io2Prong = (AliAODRecoDecayHF2Prong*)rec.fCand;
+    Bool_t okD0 = rec.fOkD0, okJPSI = rec.fOkJPSI;
+    AliAODVertex *v2Prong =0x0;
+    if(!fMakeReducedRHF)v2Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+    if(!rec.fLikeSign) {
+      if(okD0) {
+	rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
+	SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
+
+	if(fMakeReducedRHF){
+	  rd->DeleteRecoD();
+	  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+	}else{
+	  rd->SetSecondaryVtx(v2Prong);
+	  v2Prong->SetParent(rd);
+	  AddRefs(v2Prong,rd,event,&trkArray);
+	}
+      }
+      if(okJPSI) {
+	rd = new(aodJPSItoEleRef[iJPSItoEle++])AliAODRecoDecayHF2Prong(*io2Prong);
+	if(fMakeReducedRHF){
+	  rd->DeleteRecoD();
+	  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+	}else{
+	  if(!okD0) v2Prong->SetParent(rd); // it cannot have two mothers ...
+	  AddRefs(v2Prong,rd,event,&trkArray);
+	}
+      }
+    } else { // isLikeSign2Prong
+      rd = new(aodLikeSign2ProngRef[iLikeSign2Prong++])AliAODRecoDecayHF2Prong(*io2Prong);
+      //Set selection bit for PID
+      if(okD0) SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
+      if(fMakeReducedRHF){
+	rd->DeleteRecoD();
+	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+      }else{
+	rd->SetSecondaryVtx(v2Prong);
+	v2Prong->SetParent(rd);
+	AddRefs(v2Prong,rd,event,&trkArray);
+      }
+    }
+    break;
+  }
+  case CandidateRecord::kDstar: {
+    AliAODRecoCascadeHF *ioCascade = (AliAODRecoCascadeHF*)rec.fCand;
+    // add the D0 to the AOD (if not already done)
+    if(rec.fFlag) {
+      rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*rec.fD0);
+      if(fMakeReducedRHF){
+	rd->DeleteRecoD();
+	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+      }else{
+	TObjArray d0TrkArray(2);
+	d0TrkArray.AddAt(rec.fD0Tracks[0],0);
+	d0TrkArray.AddAt(rec.fD0Tracks[1],1);
+	AliAODVertex *v2Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fD0Vertex);
+	rd->SetSecondaryVtx(v2Prong);
+	v2Prong->SetParent(rd);
+	AddRefs(v2Prong,rd,event,&d0TrkArray);
+      }
+    }
+    // add the vertex and the cascade to the AOD
+    rc = new(aodDstarRef[iDstar++])AliAODRecoCascadeHF(*ioCascade);
+    // Set selection bit for PID
+    SetSelectionBitForPID(fCutsDStartoKpipi,rc,AliRDHFCuts::kDstarPID);
+    if(fMakeReducedRHF){
+      //assign a ID to the D0 candidate, daughter of the Cascade. ID = position in the D0toKpi array
+      UShort_t idCasc[2]={(UShort_t)rec.fTracks[0]->GetID(),(UShort_t)(iD0toKpi-1)};
+      rc->SetProngIDs(2,idCasc);
+      rc->DeleteRecoD();
+      rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+    }else{
+      AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+      rc->SetSecondaryVtx(vCasc);
+      vCasc->SetParent(rc);
+      if(!fInputAOD) vCasc->AddDaughter(rd); // just to fill ref #0
+      AddRefs(vCasc,rc,event,&trkArray);
+      vCasc->AddDaughter(rd); // add the D0 (in ref #1)
+    }
+    break;
+  }
+  case CandidateRecord::k3Prong: {
+    AliAODRecoDecayHF3Prong *io3Prong = (AliAODRecoDecayHF3Prong*)rec.fCand;
+    AliAODVertex *v3Prong=0x0;
+    if(!fMakeReducedRHF)v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+    if(!rec.fLikeSign) {
+      rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+      // Set selection bit for PID
+      SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+      SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+      SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+      if(fMakeReducedRHF){
+	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+	((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
+      }else{
+	if(rec.fFlag) v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+	rd->SetSecondaryVtx(v3Prong);
+	v3Prong->SetParent(rd);
+	AddRefs(v3Prong,rd,event,&trkArray);
+      }
+    } else { // isLikeSign3Prong
+      if(fLikeSign3prong){
+	rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+	// Set selection bit for PID
+	SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+	SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+	SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+	if(fMakeReducedRHF){
+	  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+	  ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
+	}else{
+	  rd->SetSecondaryVtx(v3Prong);
+	  v3Prong->SetParent(rd);
+	  AddRefs(v3Prong,rd,event,&trkArray);
+	}
+      }
+    }
+    break;
+  }
+  case CandidateRecord::k4Prong: {
+    AliAODRecoDecayHF4Prong *io4Prong = (AliAODRecoDecayHF4Prong*)rec.fCand;
+    rd = new(aodCharm4ProngRef[i4Prong++])AliAODRecoDecayHF4Prong(*io4Prong);
+    if(fMakeReducedRHF){
+      rd->DeleteRecoD();
+      rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+    }else{
+      AliAODVertex *v4Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*rec.fVertex);
+      rd->SetSecondaryVtx(v4Prong);
+      v4Prong->SetParent(rd);
+      AddRefs(v4Prong,rd,event,&trkArray);
+    }
+    break;
   }
-  if(fCascades){
-    AliDebug(1,Form(" cascades -> v0 + track in event = %d;\n",
-		    (Int_t)aodCascadesTClArr->GetEntriesFast()));
   }
-  if(fLikeSign) {
-    AliDebug(1,Form(" Like-sign 2Prong in event = %d;\n",
-		    (Int_t)aodLikeSign2ProngTClArr->GetEntriesFast()));
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FindCandidatesInThreads(CandidateLoopInput &in,CandidateOutput &out)
+{
+  /// Loops on tracks of FindCandidates with the positive tracks shared among
+  /// fNThreadsForCandidates threads. Each thread uses its own copy of this
+  /// vertexer and of the selected tracks; the candidates are then stored in
+  /// the order of the positive tracks, independently of the number of threads
+  //AliCodeTimerAuto("",0);
+
+  // The TRefs to the vertices and tracks are created in the threads: ROOT is
+  // made thread-safe here, once per process, since a vertexer streamed to the
+  // worker nodes does not go through its setters again
+  static Bool_t threadSafetyEnabled=kFALSE;
+  if(!threadSafetyEnabled) {
+    ROOT::EnableThreadSafety();
+    threadSafetyEnabled=kTRUE;
+  }
+  // The static field of AliKFParticle is set here for all the threads, the
+  // workers do not set it in ReconstructSecondaryVertex
+  if(fSecVtxWithKF) AliKFParticle::SetField(fBzkG);
+
+  Int_t nThreads = TMath::Min(fNThreadsForCandidates,in.fNSeleTrks);
+  std::vector<std::vector<CandidateRecord> > records(in.fNSeleTrks);
+  std::vector<AliAnalysisVertexingHF*> workers(nThreads);
+  std::vector<CandidateLoopInput*> inputs(nThreads);
+  for(Int_t iThread=0; iThread<nThreads; iThread++) {
+    workers[iThread] = MakeCandidateWorker(in.fEvent);
+    inputs[iThread] = new CandidateLoopInput(in);
+  }
+
+  // positive tracks are handed out one at a time: the load per track is very uneven
+  std::atomic<Int_t> nextTrkP1(0);
+  std::vector<std::thread> threads;
+  for(Int_t iThread=0; iThread<nThreads; iThread++) {
+    threads.push_back(std::thread([&,iThread]() {
+	  for(Int_t iTrkP1=nextTrkP1++; iTrkP1<in.fNSeleTrks; iTrkP1=nextTrkP1++) {
+	    workers[iThread]->FindCandidatesForPositiveTracks(iTrkP1,iTrkP1+1,*inputs[iThread],0x0,&records[iTrkP1]);
+	  }
+	}));
   }
-  if(fLikeSign3prong && f3Prong) {
-    AliDebug(1,Form(" Like-sign 3Prong in event = %d;\n",
-		    (Int_t)aodLikeSign3ProngTClArr->GetEntriesFast()));
+  for(Int_t iThread=0; iThread<nThreads; iThread++) threads[iThread].join();
+
+  for(Int_t iTrkP1=0; iTrkP1<in.fNSeleTrks; iTrkP1++) {
+    for(UInt_t iRec=0; iRec<records[iTrkP1].size(); iRec++) {
+      StoreCandidate(records[iTrkP1][iRec],out);
+      records[iTrkP1][iRec].DeleteOwned();
+    }
   }
 
+  for(Int_t iThread=0; iThread<nThreads; iThread++) {
+    for(Int_t iStage=0; iStage<kNCombinationStages; iStage++) fNCombinations[iStage]+=workers[iThread]->fNCombinations[iStage];
+    delete inputs[iThread];
+    DeleteCandidateWorker(workers[iThread]);
+  }
 
-  twoTrackArray1->Delete();  delete twoTrackArray1;
-  twoTrackArray2->Delete();  delete twoTrackArray2;
-  twoTrackArrayCasc->Delete();  delete twoTrackArrayCasc;
-  twoTrackArrayV0->Delete();  delete twoTrackArrayV0;
-  threeTrackArray->Clear();
-  threeTrackArray->Delete(); delete threeTrackArray;
-  fourTrackArray->Delete();  delete fourTrackArray;
-  delete [] seleFlags; seleFlags=NULL;
-  if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
-  tracksAtVertex.Delete();
+  return;
+}
+//----------------------------------------------------------------------------
+AliAnalysisVertexingHF* AliAnalysisVertexingHF::MakeCandidateWorker(AliVEvent *event) const
+{
+  /// Copy of this vertexer for one thread of FindCandidates, with its own
+  /// secondary vertexer, primary vertex, mass calculators and cut objects.
+  /// The track filters are only used in the track selection, before the threads
+
+  AliAnalysisVertexingHF *worker = new AliAnalysisVertexingHF(*this);
+  worker->fIsCandidateWorker = kTRUE;
+  worker->fMakeReducedRHF = fMakeReducedRHF;
+  worker->fVertexerTracks = new AliVertexerTracks(fBzkG);
+  worker->fV1 = fV1 ? new AliESDVertex(*fV1) : 0x0;
+  worker->fV1AOD = fV1AOD ? new AliAODVertex(*fV1AOD) : 0x0;
+  Double_t d02[2]={0.,0.};
+  Double_t d03[3]={0.,0.,0.};
+  Double_t d04[4]={0.,0.,0.,0.};
+  worker->fMassCalc2 = new AliAODRecoDecay(0x0,2,0,d02);
+  worker->fMassCalc3 = new AliAODRecoDecay(0x0,3,1,d03);
+  worker->fMassCalc4 = new AliAODRecoDecay(0x0,4,0,d04);
+  worker->fTrackFilter = 0x0;
+  worker->fTrackFilter2prongCentral = 0x0;
+  worker->fTrackFilter3prongCentral = 0x0;
+  worker->fTrackFilterSoftPi = 0x0;
+  worker->fTrackFilterBachelor = 0x0;
+  worker->fCutsD0toKpi = fCutsD0toKpi ? new AliRDHFCutsD0toKpi(*fCutsD0toKpi) : 0x0;
+  worker->fCutsJpsitoee = fCutsJpsitoee ? new AliRDHFCutsJpsitoee(*fCutsJpsitoee) : 0x0;
+  worker->fCutsDplustoK0spi = fCutsDplustoK0spi ? new AliRDHFCutsDplustoK0spi(*fCutsDplustoK0spi) : 0x0;
+  worker->fCutsDplustoKpipi = fCutsDplustoKpipi ? new AliRDHFCutsDplustoKpipi(*fCutsDplustoKpipi) : 0x0;
+  worker->fCutsDstoK0sK = fCutsDstoK0sK ? new AliRDHFCutsDstoK0sK(*fCutsDstoK0sK) : 0x0;
+  worker->fCutsDstoKKpi = fCutsDstoKKpi ? new AliRDHFCutsDstoKKpi(*fCutsDstoKKpi) : 0x0;
+  worker->fCutsLctopKpi = fCutsLctopKpi ? new AliRDHFCutsLctopKpi(*fCutsLctopKpi) : 0x0;
+  worker->fCutsLctoV0 = fCutsLctoV0 ? new AliRDHFCutsLctoV0(*fCutsLctoV0) : 0x0;
+  worker->fCutsD0toKpipipi = fCutsD0toKpipipi ? new AliRDHFCutsD0toKpipipi(*fCutsD0toKpipipi) : 0x0;
+  worker->fCutsDStartoKpipi = fCutsDStartoKpipi ? new AliRDHFCutsDStartoKpipi(*fCutsDStartoKpipi) : 0x0;
+
+  // the PID response is not copied with the cuts: the workers share it and
+  // their candidate selections are serialized with LockPIDResponse
+  if(worker->fCutsD0toKpi) worker->fCutsD0toKpi->SetupPID(event);
+  if(worker->fCutsJpsitoee) worker->fCutsJpsitoee->SetupPID(event);
+  if(worker->fCutsDplustoK0spi) worker->fCutsDplustoK0spi->SetupPID(event);
+  if(worker->fCutsDplustoKpipi) worker->fCutsDplustoKpipi->SetupPID(event);
+  if(worker->fCutsDstoK0sK) worker->fCutsDstoK0sK->SetupPID(event);
+  if(worker->fCutsDstoKKpi) worker->fCutsDstoKKpi->SetupPID(event);
+  if(worker->fCutsLctopKpi) worker->fCutsLctopKpi->SetupPID(event);
+  if(worker->fCutsLctoV0) worker->fCutsLctoV0->SetupPID(event);
+  if(worker->fCutsD0toKpipipi) worker->fCutsD0toKpipipi->SetupPID(event);
+  if(worker->fCutsDStartoKpipi) worker->fCutsDStartoKpipi->SetupPID(event);
+
+  return worker;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::DeleteCandidateWorker(AliAnalysisVertexingHF *worker)
+{
+  /// Delete a copy made by MakeCandidateWorker (the AOD track map is shared)
 
-  if(fInputAOD) {
-    seleTrksArray.Delete();
-    if(fAODMap) { delete [] fAODMap; fAODMap=NULL; }
+  worker->fAODMap = 0x0;
+  delete worker;
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FillTrackTable(CandidateLoopInput &in) const
+{
+  /// Table of the selected tracks for the kinematic prefilter of the 3 prongs:
+  /// pt, pz, p and energies with the pion, kaon and proton masses, max. pt of
+  /// the 3-prong tracks after each track and mass windows of the 3-prong cuts.
+  /// pt, pz and p are not changed by the propagation to the secondary vertex,
+  /// so the bounds derived from them hold for the momenta used in the cuts
+  //AliCodeTimerAuto("",0);
+
+  Int_t nSeleTrks = in.fNSeleTrks;
+  in.fTrkPt.resize(nSeleTrks);
+  in.fTrkPz.resize(nSeleTrks);
+  in.fTrkP.resize(nSeleTrks);
+  in.fTrkE.resize(3*nSeleTrks);
+  in.fMaxPtAfter.assign(nSeleTrks+1,0.);
+
+  Double_t mass[3];
+  mass[0]=TDatabasePDG::Instance()->GetParticle(211)->Mass();
+  mass[1]=TDatabasePDG::Instance()->GetParticle(321)->Mass();
+  mass[2]=TDatabasePDG::Instance()->GetParticle(2212)->Mass();
+  Double_t mom[3];
+  for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) {
+    ((AliExternalTrackParam*)in.fTracksAtVertex->UncheckedAt(iTrk))->GetPxPyPz(mom);
+    Double_t pt2=mom[0]*mom[0]+mom[1]*mom[1];
+    Double_t p2=pt2+mom[2]*mom[2];
+    in.fTrkPt[iTrk]=TMath::Sqrt(pt2);
+    in.fTrkPz[iTrk]=mom[2];
+    in.fTrkP[iTrk]=TMath::Sqrt(p2);
+    for(Int_t iHyp=0; iHyp<3; iHyp++) in.fTrkE[3*iTrk+iHyp]=TMath::Sqrt(mass[iHyp]*mass[iHyp]+p2);
+  }
+  for(Int_t iTrk=nSeleTrks-1; iTrk>=0; iTrk--) {
+    Double_t pt=0.;
+    if(TESTBIT(in.fSeleFlags[iTrk],kBitDispl) && TESTBIT(in.fSeleFlags[iTrk],kBit3Prong)) pt=in.fTrkPt[iTrk];
+    in.fMaxPtAfter[iTrk]=TMath::Max(pt,in.fMaxPtAfter[iTrk+1]);
+  }
+
+  // same pt cut as in SelectInvMassAndPt3prong
+  in.fMinPt3Prong = fMinPt3Prong>0.1 ? fMinPt3Prong : 0.;
+  in.fMinPtLc = fCutsLctopKpi->GetMinPtCandidate();
+
+  // widest mass windows over the pt bins
+  AliRDHFCuts *cuts[3]={fCutsDplustoKpipi,fCutsDstoKKpi,fCutsLctopKpi};
+  Double_t massCand[3]={fMassDplus,fMassDs,fMassLambdaC};
+  for(Int_t iCand=0; iCand<3; iCand++) {
+    Double_t mrange=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,cuts[iCand]->GetNPtBins()); iPtBin++) {
+      Double_t mrangeBin=0.;
+      if(iCand==0) mrangeBin=fCutsDplustoKpipi->GetMassCut(iPtBin);
+      else if(iCand==1) mrangeBin=fCutsDstoKKpi->GetMassCut(iPtBin);
+      else mrangeBin=fCutsLctopKpi->GetMassCut(iPtBin);
+      mrange=TMath::Max(mrange,mrangeBin);
+    }
+    Double_t lolim=TMath::Max(0.,massCand[iCand]-mrange);
+    Double_t hilim=massCand[iCand]+mrange;
+    in.fMassWindow2[2*iCand]=lolim*lolim;
+    in.fMassWindow2[2*iCand+1]=hilim*hilim;
   }
 
+  return;
+}
+//----------------------------------------------------------------------------
+Int_t AliAnalysisVertexingHF::KinematicPrefilter3Prong(const CandidateLoopInput &in,
+						       Int_t iTrk0,Int_t iTrk1,Int_t iTrk2) const
+{
+  /// Kinematic prefilter of the triplet (iTrk0,iTrk1,iTrk2), in the order of
+  /// the tracks in the 3-prong candidate. Returns kTripletsPrunedPt or
+  /// kTripletsPrunedMass if the triplet cannot pass SelectInvMassAndPt3prong,
+  /// kTriplets3Prong otherwise. The candidate pt is at most the sum of the
+  /// track pts and the invariant mass squared is between E^2-(sum p)^2 and
+  /// E^2-(sum pz)^2 for each mass hypothesis; PID and the phi mass cut of the
+  /// Ds are not used, the prefilter never rejects a triplet passing the cuts
+
+  Double_t ptMax=in.fTrkPt[iTrk0]+in.fTrkPt[iTrk1]+in.fTrkPt[iTrk2];
+  if(ptMax+kPrefilterTolerance<in.fMinPt3Prong) return kTripletsPrunedPt;
+
+  Double_t sumPz=in.fTrkPz[iTrk0]+in.fTrkPz[iTrk1]+in.fTrkPz[iTrk2];
+  Double_t sumP=in.fTrkP[iTrk0]+in.fTrkP[iTrk1]+in.fTrkP[iTrk2];
+  Double_t pz2=sumPz*sumPz-kPrefilterTolerance;
+  Double_t p2=sumP*sumP+kPrefilterTolerance;
+  const Double_t *e0=&in.fTrkE[3*iTrk0];
+  const Double_t *e1=&in.fTrkE[3*iTrk1];
+  const Double_t *e2=&in.fTrkE[3*iTrk2];
+  const Double_t *mw2=in.fMassWindow2;
+
+  // pion = 0, kaon = 1, proton = 2; the odd-charge track is always a kaon
+  Double_t eDplus=e0[0]+e1[1]+e2[0];
+  Double_t eDs1=e0[1]+e1[1]+e2[0];
+  Double_t eDs2=e0[0]+e1[1]+e2[1];
+  Double_t eLc1=e0[2]+e1[1]+e2[0];
+  Double_t eLc2=e0[0]+e1[1]+e2[2];
+  Bool_t okLc=(ptMax+kPrefilterTolerance>in.fMinPtLc);
+  Bool_t ok=((eDplus*eDplus-pz2>mw2[0]) & (eDplus*eDplus-p2<mw2[1])) |
+    ((eDs1*eDs1-pz2>mw2[2]) & (eDs1*eDs1-p2<mw2[3])) |
+    ((eDs2*eDs2-pz2>mw2[2]) & (eDs2*eDs2-p2<mw2[3])) |
+    (okLc & (((eLc1*eLc1-pz2>mw2[4]) & (eLc1*eLc1-p2<mw2[5])) |
+	     ((eLc2*eLc2-pz2>mw2[4]) & (eLc2*eLc2-p2<mw2[5]))));
+
+  return ok ? kTriplets3Prong : kTripletsPrunedMass;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::PrintCombinationCounters() const
+{
+  /// Print the number of 3-prong combinations at each stage of FindCandidates
 
-  //printf("Trks: total %d  sele %d\n",fnTrksTotal,fnSeleTrksTotal);
+  printf("AliAnalysisVertexingHF: 3-prong combinations\n");
+  printf("  triplets after the single-track selections: %lld\n",fNCombinations[kTriplets3Prong]);
+  printf("  pairs without third track (pt bound):       %lld\n",fNCombinations[kPairsPrunedPt]);
+  printf("  triplets pruned by the pt bound:            %lld\n",fNCombinations[kTripletsPrunedPt]);
+  printf("  triplets pruned by the mass bounds:         %lld\n",fNCombinations[kTripletsPrunedMass]);
+  printf("  triplets rejected by the DCA cuts:          %lld\n",fNCombinations[kTripletsPrunedDCA]);
+  printf("  triplets rejected by the mass cut:          %lld\n",fNCombinations[kTripletsPrunedMassCut]);
+  printf("  triplets vertexed:                          %lld\n",fNCombinations[kTripletsVertexed]);
 
   return;
 }
@@ -2156,6 +2768,7 @@ AliAODRecoCascadeHF* AliAnalysisVertexingHF::MakeCascade(
   }
   // select D*->D0pi
   if(fDstar) {
+    std::unique_lock<std::mutex> pidLock=LockPIDResponse(fIsCandidateWorker);
     okDstar = (Bool_t)fCutsDStartoKpipi->IsSelected(tmpCascade,AliRDHFCuts::kCandidate);
     if(okDstar) theCascade->SetSelectionBit(AliRDHFCuts::kDstarCuts);
   }
@@ -2244,6 +2857,7 @@ AliAODRecoCascadeHF* AliAnalysisVertexingHF::MakeCascade(
 
   // select Cascades
   if (fCascades && fInputAOD) {
+    std::unique_lock<std::mutex> pidLock=LockPIDResponse(fIsCandidateWorker);
     if (fCutsLctoV0->IsSelected(theCascade, AliRDHFCuts::kCandidate)>0) {
       okCascades = kTRUE;
       theCascade->SetSelectionBit(AliRDHFCuts::kLctoV0Cuts);
@@ -2361,6 +2975,7 @@ AliAODRecoDecayHF2Prong *AliAnalysisVertexingHF::Make2Prong(
       // Add daughter references already here
       if(fInputAOD) AddDaughterRefs(secVert,(AliAODEvent*)event,twoTrackArray);
 
+      std::unique_lock<std::mutex> pidLock=LockPIDResponse(fIsCandidateWorker);
       // select D0->Kpi
       if(fD0toKpi)   {
 	okD0 = (Bool_t)fCutsD0toKpi->IsSelected(the2Prong,AliRDHFCuts::kCandidate,(AliAODEvent*)event);
@@ -2515,6 +3130,7 @@ AliAODRecoDecayHF3Prong* AliAnalysisVertexingHF::Make3Prong(
   // select D+->Kpipi, Ds->KKpi, Lc->pKpi
   if(f3Prong) {
     ok3Prong = kFALSE;
+    std::unique_lock<std::mutex> pidLock=LockPIDResponse(fIsCandidateWorker);
 
     if(fOKInvMassDplus && fCutsDplustoKpipi->IsSelected(the3Prong,AliRDHFCuts::kCandidate,(AliAODEvent*)event)) {
       ok3Prong = kTRUE;
@@ -2754,7 +3370,10 @@ AliAODRecoDecayHF4Prong* AliAnalysisVertexingHF::Make4Prong(
 
   delete primVertexAOD; primVertexAOD=NULL;
 
-  ok4Prong=(Bool_t)fCutsD0toKpipipi->IsSelected(the4Prong,AliRDHFCuts::kCandidate);
+  {
+    std::unique_lock<std::mutex> pidLock=LockPIDResponse(fIsCandidateWorker);
+    ok4Prong=(Bool_t)fCutsD0toKpipipi->IsSelected(the4Prong,AliRDHFCuts::kCandidate);
+  }
 
 
   if(!fRecoPrimVtxSkippingTrks && !fRmTrksFromPrimVtx && !fMixEvent) {
@@ -2933,6 +3552,8 @@ void AliAnalysisVertexingHF::PrintStatus() const {
   }
   if(fRecoPrimVtxSkippingTrks) printf("RecoPrimVtxSkippingTrks\n");
   if(fRmTrksFromPrimVtx) printf("RmTrksFromPrimVtx\n");
+  if(fNThreadsForCandidates>1) printf("Loops on tracks split over %d threads\n",fNThreadsForCandidates);
+  if(fKinematicPrefilter3Prong) printf("Kinematic prefilter of the 3-prong triplets\n");
   if(fD0toKpi) {
     printf("Reconstruct D0->Kpi candidates with cuts:\n");
     if(fCutsD0toKpi) fCutsD0toKpi->PrintAll();
@@ -3008,7 +3629,8 @@ AliAODVertex* AliAnalysisVertexingHF::ReconstructSecondaryVertex(TObjArray *trkA
 
   } else { // Kalman Filter vertexer (AliKFParticle)
 
-    AliKFParticle::SetField(fBzkG);
+    // the workers of FindCandidatesInThreads share the field set before the threads start
+    if(!fIsCandidateWorker) AliKFParticle::SetField(fBzkG);
 
     AliKFVertex vertexKF;
 
@@ -13,6 +13,7 @@
 /// \author Contact: andrea.dainese@pd.infn.it
 //-------------------------------------------------------------------------
 
+#include <vector>
 #include <TNamed.h>
 #include <TList.h>
 
@@ -179,6 +180,20 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetCutsDStartoKpipi(AliRDHFCutsDStartoKpipi* cuts) { fCutsDStartoKpipi = cuts; }
   AliRDHFCutsDStartoKpipi* GetCutsDStartoKpipi() const { return fCutsDStartoKpipi; }
   void SetMassCutBeforeVertexing(Bool_t flag) { fMassCutBeforeVertexing=flag; }
+  /// split the loop on the positive tracks of FindCandidates over nThreads
+  /// threads (<=1: serial loop)
+  void SetNThreadsForCandidates(Int_t nThreads) { fNThreadsForCandidates=nThreads; }
+  Int_t GetNThreadsForCandidates() const { return fNThreadsForCandidates; }
+  /// reject the triplets of the 3-prong loops with bounds on their pt and
+  /// invariant mass from the table of the selected tracks, before the DCAs
+  /// and the vertexing (only triplets that would fail the 3-prong mass and pt cuts)
+  void SetKinematicPrefilter3Prong(Bool_t flag=kTRUE) { fKinematicPrefilter3Prong=flag; }
+  Bool_t GetKinematicPrefilter3Prong() const { return fKinematicPrefilter3Prong; }
+  /// stages of the 3-prong combinatorics, counted over all the events
+  enum ECombinationStage { kTriplets3Prong = 0, kPairsPrunedPt, kTripletsPrunedPt, kTripletsPrunedMass,
+			   kTripletsPrunedDCA, kTripletsPrunedMassCut, kTripletsVertexed, kNCombinationStages };
+  Long64_t GetNCombinations(Int_t stage) const { return fNCombinations[stage]; }
+  void PrintCombinationCounters() const;
 
   void SetMasses();
   Bool_t CheckCutsConsistency();
@@ -355,6 +370,18 @@ class AliAnalysisVertexingHF : public TNamed {
   Double_t fMassPhi;
   Double_t fMassK;
 
+  Int_t fNThreadsForCandidates; /// number of threads for the loops on tracks in FindCandidates
+  Bool_t fKinematicPrefilter3Prong; /// prefilter on pt and mass of the triplets before the DCAs and the vertexing
+  Long64_t fNCombinations[kNCombinationStages]; //! number of 3-prong combinations per stage
+  Bool_t fIsCandidateWorker; //! copy of the vertexer used in one thread of FindCandidatesInThreads
+
+  /// inputs of the loops on tracks of FindCandidates (one per thread)
+  struct CandidateLoopInput;
+  /// candidate found in the loops on tracks, to be stored in the output arrays
+  struct CandidateRecord;
+  /// output arrays of FindCandidates and their number of entries
+  struct CandidateOutput;
+
   //
   void AddRefs(AliAODVertex *v,AliAODRecoDecayHF *rd,const AliVEvent *event,
 	       const TObjArray *trkArray) const;
@@ -428,8 +455,20 @@ class AliAnalysisVertexingHF : public TNamed {
   AliAODv0* TransformESDv0toAODv0(AliESDv0 *esdv0,
 				  TObjArray *twoTrackArrayV0);
 
+  void FindCandidatesForPositiveTracks(Int_t firstTrkP1,Int_t lastTrkP1,
+				       CandidateLoopInput &in,CandidateOutput *out,
+				       std::vector<CandidateRecord> *records);
+  void FindCandidatesInThreads(CandidateLoopInput &in,CandidateOutput &out);
+  void EmitCandidate(CandidateRecord &rec,CandidateOutput *out,
+		     std::vector<CandidateRecord> *records);
+  void StoreCandidate(const CandidateRecord &rec,CandidateOutput &out);
+  AliAnalysisVertexingHF* MakeCandidateWorker(AliVEvent *event) const;
+  static void DeleteCandidateWorker(AliAnalysisVertexingHF *worker);
+  void FillTrackTable(CandidateLoopInput &in) const;
+  Int_t KinematicPrefilter3Prong(const CandidateLoopInput &in,Int_t iTrk0,Int_t iTrk1,Int_t iTrk2) const;
+
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,30);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,32);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
@@ -0,0 +1,279 @@
+/**************************************************************************
+ * Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+/////////////////////////////////////////////////////////////
+///
+/// \class AliHFTreeEnsembleReader
+/// \brief Flat-array evaluator of TMVA BDTs read from the weight xml file
+///
+/////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <TXMLEngine.h>
+
+#include "AliHFTreeEnsembleReader.h"
+
+namespace {
+
+  const char* GetAttr(TXMLEngine& xml, XMLNodePointer_t node, const char* name) {
+    const char* value = xml.GetAttr(node, name);
+    return value ? value : "";
+  }
+
+  /// append the node and its daughters to the flat arrays, return the index of the node
+  int AddNode(TXMLEngine& xml, XMLNodePointer_t xmlNode, double weight, bool useYesNoLeaf, bool isGrad,
+              int depth, int& maxDepth, std::vector<int>& var, std::vector<double>& cut, std::vector<int>& cutType,
+              std::vector<int>& child, std::vector<double>& value, bool& isClean) {
+    const int index = var.size();
+    var.push_back(0);
+    cut.push_back(0.);
+    cutType.push_back(0);
+    child.push_back(index);
+    child.push_back(index);
+    value.push_back(0.);
+    if (depth > maxDepth) maxDepth = depth;
+
+    if (atoi(GetAttr(xml, xmlNode, "NCoef")) != 0) {
+      std::cout << "AliHFTreeEnsembleReader: Fisher cuts are not supported" << std::endl;
+      isClean = false;
+    }
+
+    const int nodeType = atoi(GetAttr(xml, xmlNode, "nType"));
+    if (nodeType != 0) {
+      if (isGrad) value[index] = atof(GetAttr(xml, xmlNode, "res"));
+      else if (useYesNoLeaf) value[index] = weight * nodeType;
+      else value[index] = weight * atof(GetAttr(xml, xmlNode, "purity"));
+      return index;
+    }
+
+    var[index] = atoi(GetAttr(xml, xmlNode, "IVar"));
+    cut[index] = atof(GetAttr(xml, xmlNode, "Cut"));
+    cutType[index] = atoi(GetAttr(xml, xmlNode, "cType")) != 0;
+    for (XMLNodePointer_t daughter = xml.GetChild(xmlNode); daughter; daughter = xml.GetNext(daughter)) {
+      const std::string pos = GetAttr(xml, daughter, "pos");
+      const int iDaughter = AddNode(xml, daughter, weight, useYesNoLeaf, isGrad, depth + 1, maxDepth,
+                                    var, cut, cutType, child, value, isClean);
+      if (pos == "l") child[2*index] = iDaughter;
+      else if (pos == "r") child[2*index + 1] = iDaughter;
+    }
+    if (child[2*index] == index || child[2*index + 1] == index) {
+      std::cout << "AliHFTreeEnsembleReader: intermediate node without daughters" << std::endl;
+      isClean = false;
+    }
+    return index;
+  }
+}
+
+//________________________________________________________________________
+AliHFTreeEnsembleReader::AliHFTreeEnsembleReader():
+  IClassifierReader(),
+  fInputVars(),
+  fVarMin(),
+  fVarMax(),
+  fBoostType(kAdaBoost),
+  fNorm(1.),
+  fTreeRoot(),
+  fTreeDepth(),
+  fNodeVar(),
+  fNodeCut(),
+  fNodeCutType(),
+  fNodeChild(),
+  fNodeValue()
+{
+  /// Default constructor
+}
+
+//________________________________________________________________________
+AliHFTreeEnsembleReader::AliHFTreeEnsembleReader(std::vector<std::string>& theInputVars, const std::string& xmlFileName):
+  IClassifierReader(),
+  fInputVars(),
+  fVarMin(),
+  fVarMax(),
+  fBoostType(kAdaBoost),
+  fNorm(1.),
+  fTreeRoot(),
+  fTreeDepth(),
+  fNodeVar(),
+  fNodeCut(),
+  fNodeCutType(),
+  fNodeChild(),
+  fNodeValue()
+{
+  /// Standard constructor: load the forest and check the input variables as the generated classes do
+
+  if (!LoadWeightsFile(xmlFileName)) return;
+
+  if (theInputVars.size() != fInputVars.size()) {
+    std::cout << "Problem in AliHFTreeEnsembleReader: mismatch in number of input values: "
+              << theInputVars.size() << " != " << fInputVars.size() << std::endl;
+    fStatusIsClean = false;
+    return;
+  }
+  for (size_t ivar = 0; ivar < theInputVars.size(); ivar++) {
+    if (theInputVars[ivar] != fInputVars[ivar]) {
+      std::cout << "Problem in AliHFTreeEnsembleReader: mismatch in input variable names" << std::endl
+                << " for variable [" << ivar << "]: " << theInputVars[ivar] << " != " << fInputVars[ivar] << std::endl;
+      fStatusIsClean = false;
+    }
+  }
+}
+
+//________________________________________________________________________
+bool AliHFTreeEnsembleReader::LoadWeightsFile(const std::string& xmlFileName)
+{
+  /// Read variables, options and forest from the TMVA weight file
+
+  fStatusIsClean = false;
+  fInputVars.clear();
+  fVarMin.clear();
+  fVarMax.clear();
+  fTreeRoot.clear();
+  fTreeDepth.clear();
+  fNodeVar.clear();
+  fNodeCut.clear();
+  fNodeCutType.clear();
+  fNodeChild.clear();
+  fNodeValue.clear();
+
+  TXMLEngine xml;
+  XMLDocPointer_t doc = xml.ParseFile(xmlFileName.data());
+  if (!doc) {
+    std::cout << "AliHFTreeEnsembleReader: failed to open " << xmlFileName << std::endl;
+    return false;
+  }
+  XMLNodePointer_t mainNode = xml.DocGetRootElement(doc);
+
+  bool useYesNoLeaf = true;
+  bool isClean = true;
+  XMLNodePointer_t weightsNode = 0;
+  fBoostType = kAdaBoost;
+  for (XMLNodePointer_t branch = xml.GetChild(mainNode); branch; branch = xml.GetNext(branch)) {
+    const std::string branchName = xml.GetNodeName(branch);
+    if (branchName == "Options") {
+      for (XMLNodePointer_t option = xml.GetChild(branch); option; option = xml.GetNext(option)) {
+        const std::string optionName = GetAttr(xml, option, "name");
+        const char* content = xml.GetNodeContent(option);
+        const std::string optionValue = content ? content : "";
+        if (optionName == "BoostType") {
+          if (optionValue == "Grad") fBoostType = kGrad;
+          else if (optionValue != "AdaBoost" && optionValue != "RealAdaBoost") {
+            std::cout << "AliHFTreeEnsembleReader: boost type " << optionValue << " not supported" << std::endl;
+            isClean = false;
+          }
+        }
+        else if (optionName == "UseYesNoLeaf") useYesNoLeaf = (optionValue == "True");
+        else if (optionName == "VarTransform" && optionValue != "None") {
+          std::cout << "AliHFTreeEnsembleReader: variable transformation " << optionValue << " not supported" << std::endl;
+          isClean = false;
+        }
+      }
+    }
+    else if (branchName == "Variables") {
+      for (XMLNodePointer_t variable = xml.GetChild(branch); variable; variable = xml.GetNext(variable)) {
+        fInputVars.push_back(GetAttr(xml, variable, "Expression"));
+        fVarMin.push_back(atof(GetAttr(xml, variable, "Min")));
+        fVarMax.push_back(atof(GetAttr(xml, variable, "Max")));
+      }
+    }
+    else if (branchName == "Weights") weightsNode = branch;
+  }
+
+  if (!weightsNode) {
+    std::cout << "AliHFTreeEnsembleReader: no weights found in " << xmlFileName << std::endl;
+    xml.FreeDoc(doc);
+    return false;
+  }
+
+  fNorm = 0.;
+  for (XMLNodePointer_t tree = xml.GetChild(weightsNode); tree; tree = xml.GetNext(tree)) {
+    const double weight = (fBoostType == kGrad) ? 1. : atof(GetAttr(xml, tree, "boostWeight"));
+    XMLNodePointer_t root = xml.GetChild(tree);
+    if (!root) continue;
+    int depth = 0;
+    fTreeRoot.push_back(AddNode(xml, root, weight, useYesNoLeaf, fBoostType == kGrad, 0, depth,
+                                fNodeVar, fNodeCut, fNodeCutType, fNodeChild, fNodeValue, isClean));
+    fTreeDepth.push_back(depth);
+    fNorm += weight;
+  }
+  xml.FreeDoc(doc);
+
+  if (fTreeRoot.empty() || fNorm == 0.) {
+    std::cout << "AliHFTreeEnsembleReader: empty forest in " << xmlFileName << std::endl;
+    return false;
+  }
+  fStatusIsClean = isClean;
+  return isClean;
+}
+
+//________________________________________________________________________
+double AliHFTreeEnsembleReader::Response(double sum) const
+{
+  /// Same output as TMVA::MethodBDT for the supported boost types
+  if (fBoostType == kGrad) return 2. / (1. + std::exp(-2. * sum)) - 1.;
+  return sum / fNorm;
+}
+
+//________________________________________________________________________
+double AliHFTreeEnsembleReader::GetMvaValue(const std::vector<double>& inputValues) const
+{
+  /// Classifier response for a single candidate
+
+  if (!IsStatusClean()) {
+    std::cout << "Problem in AliHFTreeEnsembleReader: cannot return classifier response"
+              << " because status is dirty" << std::endl;
+    return 0.;
+  }
+
+  const double* values = &inputValues[0];
+  double sum = 0.;
+  for (size_t itree = 0; itree < fTreeRoot.size(); itree++) {
+    int node = fTreeRoot[itree];
+    for (int depth = fTreeDepth[itree]; depth--;) node = NextNode(node, values);
+    sum += fNodeValue[node];
+  }
+  return Response(sum);
+}
+
+//________________________________________________________________________
+void AliHFTreeEnsembleReader::GetMvaValues(const double* inputValues, int nCandidates, double* outputValues) const
+{
+  /// Classifier response for a block of candidates. The loop over the candidates is the
+  /// inner one, so that the nodes of each tree are read once per block and the fixed-length
+  /// descent (the leaves point to themselves) has no data-dependent branch
+
+  const size_t nVars = fInputVars.size();
+  if (!IsStatusClean()) {
+    std::cout << "Problem in AliHFTreeEnsembleReader: cannot return classifier response"
+              << " because status is dirty" << std::endl;
+    for (int iCand = 0; iCand < nCandidates; iCand++) outputValues[iCand] = 0.;
+    return;
+  }
+
+  for (int iCand = 0; iCand < nCandidates; iCand++) outputValues[iCand] = 0.;
+  for (size_t itree = 0; itree < fTreeRoot.size(); itree++) {
+    const int root = fTreeRoot[itree];
+    const int treeDepth = fTreeDepth[itree];
+    for (int iCand = 0; iCand < nCandidates; iCand++) {
+      const double* values = inputValues + iCand * nVars;
+      int node = root;
+      for (int depth = treeDepth; depth--;) node = NextNode(node, values);
+      outputValues[iCand] += fNodeValue[node];
+    }
+  }
+  for (int iCand = 0; iCand < nCandidates; iCand++) outputValues[iCand] = Response(outputValues[iCand]);
+}
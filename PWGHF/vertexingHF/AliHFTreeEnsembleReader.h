@@ -0,0 +1,72 @@
+#ifndef ALIHFTREEENSEMBLEREADER_H
+#define ALIHFTREEENSEMBLEREADER_H
+
+/* Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+///*************************************************************************
+/// \class AliHFTreeEnsembleReader
+///
+/// \brief Generic evaluator of TMVA BDTs read at runtime from the weight
+/// xml file, alternative to the classes generated by MethodBase::MakeClass.
+/// The forest is stored in flat arrays (structure of arrays) and can be
+/// evaluated for many candidates at once, each tree being traversed by all
+/// the candidates before moving to the next one.
+///*************************************************************************
+
+#include <string>
+#include <vector>
+
+#include "IClassifierReader.h"
+
+class AliHFTreeEnsembleReader : public IClassifierReader
+{
+ public:
+
+  enum EBoostType {kAdaBoost, kGrad};
+
+  AliHFTreeEnsembleReader();
+  AliHFTreeEnsembleReader(std::vector<std::string>& theInputVars, const std::string& xmlFileName);
+  virtual ~AliHFTreeEnsembleReader() {}
+
+  /// read the forest from the TMVA weight xml file, return false if the model is not supported
+  bool LoadWeightsFile(const std::string& xmlFileName);
+
+  /// classifier response for one candidate, "inputValues" in the order of the variables of the xml file
+  virtual double GetMvaValue(const std::vector<double>& inputValues) const;
+  /// classifier response for nCandidates candidates stored row-major (GetNvar() values per candidate)
+  void GetMvaValues(const double* inputValues, int nCandidates, double* outputValues) const;
+
+  size_t GetNvar() const { return fInputVars.size(); }
+  size_t GetNTrees() const { return fTreeRoot.size(); }
+  const std::vector<std::string>& GetInputVars() const { return fInputVars; }
+  double GetVarMin(int ivar) const { return fVarMin[ivar]; }
+  double GetVarMax(int ivar) const { return fVarMax[ivar]; }
+
+ private:
+
+  /// child of the node followed by the candidate, leaves point to themselves
+  int NextNode(int node, const double* inputValues) const {
+    return fNodeChild[2*node + ((inputValues[fNodeVar[node]] >= fNodeCut[node]) == fNodeCutType[node])];
+  }
+  /// final transformation of the sum of the leaf values
+  double Response(double sum) const;
+
+  std::vector<std::string> fInputVars; /// input variables as in the xml file
+  std::vector<double> fVarMin;         /// minimum of the input variables in the training sample
+  std::vector<double> fVarMax;         /// maximum of the input variables in the training sample
+
+  EBoostType fBoostType;               /// boost type of the forest
+  double fNorm;                        /// normalisation of the AdaBoost response (sum of the boost weights)
+
+  std::vector<int> fTreeRoot;          /// index of the root node of each tree
+  std::vector<int> fTreeDepth;         /// depth of each tree
+
+  std::vector<int> fNodeVar;           /// index of the variable cut on at each node (0 for leaves)
+  std::vector<double> fNodeCut;        /// cut value at each node
+  std::vector<int> fNodeCutType;       /// 1 if the candidates above the cut go right, 0 otherwise
+  std::vector<int> fNodeChild;         /// left and right child of each node
+  std::vector<double> fNodeValue;      /// boost-weighted leaf value (0 for intermediate nodes)
+};
+
+#endif
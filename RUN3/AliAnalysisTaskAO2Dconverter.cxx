@@ -19,8 +19,13 @@
  */
 
 #include <TChain.h>
+#include <TFile.h>
+#include <TSystem.h>
 #include <TTree.h>
 #include <TMath.h>
+#include <TBranch.h>
+#include <TROOT.h>
+#include <chrono>
 #include "AliAnalysisTask.h"
 #include "AliAnalysisManager.h"
 #include "AliESDEvent.h"
@@ -79,6 +84,30 @@ ULong64_t GetEventIdAsLong(AliVHeader *header)
   return id;
 }
 
+// Keep nbits of the float mantissa, rounding to the nearest representable value
+Float_t TruncateMantissa(Float_t x, Int_t nbits)
+{
+  if (nbits >= 23)
+    return x;
+  union {
+    Float_t f;
+    UInt_t i;
+  } u;
+  u.f = x;
+  if ((u.i & 0x7f800000u) == 0x7f800000u) // inf or nan
+    return x;
+  const Int_t drop = 23 - (nbits > 0 ? nbits : 0);
+  u.i += 1u << (drop - 1);
+  u.i &= ~((1u << drop) - 1u);
+  return u.f;
+}
+
+// Map signed differences to unsigned values, small in absolute value for small differences
+inline Int_t ZigZag(Int_t v)
+{
+  return static_cast<Int_t>((static_cast<UInt_t>(v) << 1) ^ static_cast<UInt_t>(v >> 31));
+}
+
 } // namespace
 
 AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
@@ -121,11 +150,68 @@ void AliAnalysisTaskAO2Dconverter::PostTree(TreeIndex t)
   PostData(t + 1, fTree[t]);
 }
 
+void AliAnalysisTaskAO2Dconverter::SetIndexColumn(TreeIndex t, Int_t* column)
+{
+  fIndexColumn[t] = column;
+  fLastIndex[t] = 0;
+}
+
 void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return;
+  // The reference table gets the row before the truncation and the delta encoding
+  if (fReferenceTree[t])
+    fReferenceTree[t]->Fill();
+  if (t == kTracks)
+    TruncateTrack();
+  // Replace the index column by its encoded difference to the previous row for the Fill only
+  const Bool_t encodeIndex = fDeltaEncodeIndices && fIndexColumn[t];
+  Int_t index = 0;
+  if (encodeIndex) {
+    index = *fIndexColumn[t];
+    *fIndexColumn[t] = ZigZag(index - fLastIndex[t]);
+    fLastIndex[t] = index;
+  }
+  auto start = std::chrono::steady_clock::now();
   fTree[t]->Fill();
+  fFillTime[t] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+  if (encodeIndex)
+    *fIndexColumn[t] = index;
+}
+
+void AliAnalysisTaskAO2Dconverter::TruncateTrack()
+{
+  struct Column {
+    Float_t* value;
+    TruncationGroup group;
+  };
+  const Column columns[] = {
+    { &tracks.fX, kTrackX }, { &tracks.fAlpha, kTrackAlpha },
+    { &tracks.fY, kTrackYZ }, { &tracks.fZ, kTrackYZ },
+    { &tracks.fSnp, kTrackSnpTgl }, { &tracks.fTgl, kTrackSnpTgl },
+    { &tracks.fSigned1Pt, kTrack1Pt },
+    { &tracks.fCYY, kTrackCovDiag }, { &tracks.fCZZ, kTrackCovDiag }, { &tracks.fCSnpSnp, kTrackCovDiag },
+    { &tracks.fCTglTgl, kTrackCovDiag }, { &tracks.fC1Pt21Pt2, kTrackCovDiag },
+    { &tracks.fCZY, kTrackCovOffDiag }, { &tracks.fCSnpY, kTrackCovOffDiag }, { &tracks.fCSnpZ, kTrackCovOffDiag },
+    { &tracks.fCTglY, kTrackCovOffDiag }, { &tracks.fCTglZ, kTrackCovOffDiag }, { &tracks.fCTglSnp, kTrackCovOffDiag },
+    { &tracks.fC1PtY, kTrackCovOffDiag }, { &tracks.fC1PtZ, kTrackCovOffDiag }, { &tracks.fC1PtSnp, kTrackCovOffDiag },
+    { &tracks.fC1PtTgl, kTrackCovOffDiag },
+    { &tracks.fTPCinnerP, kTrackPID }, { &tracks.fITSchi2Ncl, kTrackPID }, { &tracks.fTPCchi2Ncl, kTrackPID },
+    { &tracks.fTRDchi2, kTrackPID }, { &tracks.fTOFchi2, kTrackPID }, { &tracks.fTPCsignal, kTrackPID },
+    { &tracks.fTRDsignal, kTrackPID }, { &tracks.fTOFsignal, kTrackPID }, { &tracks.fLength, kTrackPID }
+  };
+  for (const Column& col : columns) {
+    const Int_t nbits = fMantissaBits[col.group];
+    if (nbits >= 23)
+      continue;
+    const Float_t original = *col.value;
+    *col.value = TruncateMantissa(original, nbits);
+    const Double_t err = TMath::Abs(static_cast<Double_t>(*col.value) - original);
+    fMaxAbsError[col.group] = TMath::Max(fMaxAbsError[col.group], err);
+    if (original != 0.f)
+      fMaxRelError[col.group] = TMath::Max(fMaxRelError[col.group], err / TMath::Abs(original));
+  }
 }
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -138,6 +224,12 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
     break;
   }
 
+  // Start the thread pool compressing the baskets in the background
+  if (fNImplicitMTThreads >= 0 && !ROOT::IsImplicitMTEnabled()) {
+    ROOT::EnableImplicitMT(fNImplicitMTThreads);
+    AliInfo(Form("Implicit MT enabled with %u threads", ROOT::GetImplicitMTPoolSize()));
+  }
+
   // Reset the offsets
   fOffsetMuTrackID = 0;
   fOffsetTrackID = 0;
@@ -206,7 +298,10 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
     tTracks->Branch("fC1PtTgl", &tracks.fC1PtTgl, "fC1PtTgl/F");
     tTracks->Branch("fC1Pt21Pt2", &tracks.fC1Pt21Pt2, "fC1Pt21Pt2/F");
     tTracks->Branch("fTPCinnerP", &tracks.fTPCinnerP, "fTPCinnerP/F");
-    tTracks->Branch("fFlags", &tracks.fFlags, "fFlags/l");
+    if (fCompactFlags)
+      tTracks->Branch("fFlags", &tracks.fFlagsCompact, "fFlags/i");
+    else
+      tTracks->Branch("fFlags", &tracks.fFlags, "fFlags/l");
     tTracks->Branch("fITSClusterMap", &tracks.fITSClusterMap, "fITSClusterMap/b");
     tTracks->Branch("fTPCncls", &tracks.fTPCncls, "fTPCncls/s");
     tTracks->Branch("fTRDntracklets", &tracks.fTRDntracklets, "fTRDntracklets/b");
@@ -368,6 +463,114 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 #endif
 
   Prune(); //Removing all unwanted branches (if any)
+  ConfigureOutput(); // Basket sizes, compression and implicit MT of the trees
+
+  // Sorted index columns, delta encoded on request. The references of the V0s and cascades to the
+  // tracks and V0s follow the order of the V0s in the ESD and are left as they are
+  SetIndexColumn(kTracks, &tracks.fCollisionsID);
+  SetIndexColumn(kCalo, &calo.fCollisionsID);
+  SetIndexColumn(kCaloTrigger, &calotrigger.fCollisionsID);
+  SetIndexColumn(kMuon, &muons.fCollisionsID);
+  SetIndexColumn(kMuonCls, &mucls.fMuonsID);
+  SetIndexColumn(kZdc, &zdc.fCollisionsID);
+  SetIndexColumn(kVzero, &vzero.fCollisionsID);
+  if (fDeltaEncodeIndices) {
+    // Flag the encoding for the readers of the trees
+    for (Int_t i = 0; i < kTrees; i++) {
+      if (fTree[i] && fIndexColumn[i])
+        fTree[i]->GetUserInfo()->Add(new TNamed("IndexEncoding", "delta+zigzag"));
+    }
+  }
+  if (fEncodingReference)
+    CreateReferenceTrees();
+  for (Int_t i = 0; i < kTruncationGroups; i++)
+    fMaxAbsError[i] = fMaxRelError[i] = 0.;
+  fNLostFlags = 0;
+}
+
+void AliAnalysisTaskAO2Dconverter::ConfigureOutput()
+{
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTree[i] || !fTreeStatus[i])
+      continue;
+    fFillTime[i] = 0.;
+    if (fBasketSize[i] > 0)
+      fTree[i]->SetBasketSize("*", fBasketSize[i]);
+    if (fCompression[i] >= 0) {
+      TObjArray* branches = fTree[i]->GetListOfBranches();
+      for (Int_t k = 0; k < branches->GetEntries(); k++)
+        static_cast<TBranch*>(branches->At(k))->SetCompressionSettings(fCompression[i]);
+    }
+    // The baskets of the different branches are flushed as parallel tasks
+    fTree[i]->SetImplicitMT(fNImplicitMTThreads >= 0);
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::CreateReferenceTrees()
+{
+  // Copies of the track table and of the delta encoded tables, with the same branches and compression,
+  // written to a temporary file in the working directory and removed in FinishTaskOutput
+  TDirectory* outputDir = gDirectory;
+  fReferenceFile = TFile::Open(Form("AO2Dreference_%d.root", gSystem->GetPid()), "RECREATE");
+  if (!fReferenceFile || fReferenceFile->IsZombie()) {
+    AliError("Cannot create the file of the reference tables, the gain of the encodings is not measured");
+    delete fReferenceFile;
+    fReferenceFile = nullptr;
+    outputDir->cd();
+    return;
+  }
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTree[i] || !fTreeStatus[i] || (i != kTracks && !(fDeltaEncodeIndices && fIndexColumn[i])))
+      continue;
+    // The compact track flags are replaced by the 64 bits of the ESD
+    const Bool_t fullFlags = (i == kTracks && fCompactFlags && fTree[i]->GetBranchStatus("fFlags"));
+    if (fullFlags)
+      fTree[i]->SetBranchStatus("fFlags", 0);
+    fReferenceTree[i] = fTree[i]->CloneTree(0);
+    if (fullFlags) {
+      fTree[i]->SetBranchStatus("fFlags", 1);
+      fReferenceTree[i]->Branch("fFlags", &tracks.fFlags, "fFlags/l");
+    }
+    fReferenceTree[i]->SetDirectory(fReferenceFile);
+  }
+  outputDir->cd();
+}
+
+void AliAnalysisTaskAO2Dconverter::ReportEncodingGain()
+{
+  if (!fReferenceFile)
+    return;
+  AliInfo("Compressed size of the tables without -> with truncation and delta encoding (bytes):");
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fReferenceTree[i])
+      continue;
+    fReferenceTree[i]->FlushBaskets();
+    const Long64_t referenceBytes = fReferenceTree[i]->GetZipBytes();
+    const Long64_t encodedBytes = fTree[i]->GetZipBytes();
+    AliInfo(Form("  %-14s %12lld -> %12lld (%6.2f%%)", TreeName[i].Data(), referenceBytes, encodedBytes,
+                 referenceBytes > 0 ? 100. * encodedBytes / referenceBytes : 0.));
+  }
+  if (fReferenceTree[kTracks]) {
+    AliInfo("Track table per column:");
+    TObjArray* branches = fReferenceTree[kTracks]->GetListOfBranches();
+    for (Int_t k = 0; k < branches->GetEntries(); k++) {
+      TBranch* referenceBranch = static_cast<TBranch*>(branches->At(k));
+      TBranch* br = fTree[kTracks]->GetBranch(referenceBranch->GetName());
+      if (!br)
+        continue;
+      AliInfo(Form("  %-16s %12lld -> %12lld (%6.2f%%)", br->GetName(), referenceBranch->GetZipBytes(), br->GetZipBytes(),
+                   referenceBranch->GetZipBytes() > 0 ? 100. * br->GetZipBytes() / referenceBranch->GetZipBytes() : 0.));
+    }
+  }
+
+  const TString fileName = fReferenceFile->GetName();
+  for (Int_t i = 0; i < kTrees; i++) {
+    delete fReferenceTree[i];
+    fReferenceTree[i] = nullptr;
+  }
+  delete fReferenceFile;
+  fReferenceFile = nullptr;
+  gSystem->Unlink(fileName);
 }
 
 void AliAnalysisTaskAO2Dconverter::Prune()
@@ -559,6 +762,9 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     tracks.fTPCinnerP = (intp ? intp->GetP() : 0); // Set the momentum to 0 if the track did not reach TPC
 
     tracks.fFlags = track->GetStatus();
+    tracks.fFlagsCompact = static_cast<UInt_t>(tracks.fFlags);
+    if (fCompactFlags && (tracks.fFlags >> 32))
+      fNLostFlags++;
 
     tracks.fITSClusterMap = track->GetITSClusterMap();
     tracks.fTPCncls = track->GetTPCNcls();
@@ -601,7 +807,7 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     track->GetTOFLabel(fTOFLabel);
 #endif
 
-    FillTree(kTracks);
+    FillTree(kTracks); // Also truncates the track columns
   } // end loop on tracks
 
   //---------------------------------------------------------------------------
@@ -855,6 +1061,45 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   fOffsetV0ID += nv0;
 }
 
+void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
+{
+  // Report the output throughput per tree. It is done here and not in Terminate because only
+  // the worker holds the filled trees when running in a train
+  AliInfo("Output throughput per tree:");
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTree[i] || !fTreeStatus[i])
+      continue;
+    fTree[i]->FlushBaskets();
+    Double_t totMB = fTree[i]->GetTotBytes() / 1048576.;
+    Double_t zipMB = fTree[i]->GetZipBytes() / 1048576.;
+    AliInfo(Form("  %-14s %10lld entries %10.2f MB -> %10.2f MB (ratio %5.2f) in %8.2f s (%8.2f MB/s)",
+                 TreeName[i].Data(), fTree[i]->GetEntries(), totMB, zipMB, zipMB > 0 ? totMB / zipMB : 0.,
+                 fFillTime[i], fFillTime[i] > 0 ? totMB / fFillTime[i] : 0.));
+  }
+
+  // Validation of the lossy packing of the track table: compression per column vs induced error
+  if (fTree[kTracks] && fTreeStatus[kTracks]) {
+    const char* groupName[kTruncationGroups] = { "X", "Alpha", "Y,Z", "Snp,Tgl", "Signed1Pt", "Cov. diagonal", "Cov. off-diagonal", "PID/quality" };
+    AliInfo("Track table packing (mantissa bits, max abs error, max rel error):");
+    for (Int_t i = 0; i < kTruncationGroups; i++) {
+      AliInfo(Form("  %-18s %2d bits %12.4g %12.4g", groupName[i], TMath::Min(fMantissaBits[i], 23), fMaxAbsError[i], fMaxRelError[i]));
+    }
+    AliInfo("Track table size per column (raw -> compressed bytes):");
+    TObjArray* branches = fTree[kTracks]->GetListOfBranches();
+    for (Int_t k = 0; k < branches->GetEntries(); k++) {
+      TBranch* br = static_cast<TBranch*>(branches->At(k));
+      AliInfo(Form("  %-16s %12lld -> %12lld (ratio %5.2f)", br->GetName(), br->GetTotBytes(), br->GetZipBytes(),
+                   br->GetZipBytes() > 0 ? static_cast<Double_t>(br->GetTotBytes()) / br->GetZipBytes() : 0.));
+    }
+  }
+  // Gain of the encodings with respect to the unencoded and untruncated tables (SetEncodingReference)
+  ReportEncodingGain();
+  if (fDeltaEncodeIndices)
+    AliInfo("Collision and muon index columns are delta and zig-zag encoded");
+  if (fCompactFlags && fNLostFlags)
+    AliWarning(Form("%lld tracks had status bits above 32 that were lost with the compact flags", fNLostFlags));
+}
+
 void AliAnalysisTaskAO2Dconverter::Terminate(Option_t *)
 {
   // terminate
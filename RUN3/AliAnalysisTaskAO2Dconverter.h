@@ -16,6 +16,7 @@
 #include <Rtypes.h>
 
 class AliESDEvent;
+class TFile;
 
 class AliAnalysisTaskAO2Dconverter : public AliAnalysisTaskSE
 {
@@ -32,6 +33,7 @@ public:
 
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
+  virtual void FinishTaskOutput();
   virtual void Terminate(Option_t *option);
 
   void SetNumberOfEventsPerCluster(int n) { fNumberOfEventsPerCluster = n; }
@@ -83,6 +85,37 @@ public:
   void Prune(TString p) { fPruneList = p; }; // Setter of the pruning list
   void SetMCMode() { fTaskMode = kMC; };     // Setter of the MC running mode
 
+  // Output mode: the baskets (column blocks) of the branches are compressed and written by the
+  // ROOT implicit MT thread pool, with basket size and compression configurable per tree
+  void SetImplicitMT(Int_t nThreads = 0) { fNImplicitMTThreads = nThreads; } // nThreads = 0: all the cores, < 0: disabled
+  void SetBasketSize(TreeIndex t, Int_t bytes) { fBasketSize[t] = bytes; }   // Basket size of all the branches of the tree (0: ROOT default)
+  void SetCompression(TreeIndex t, Int_t settings) { fCompression[t] = settings; } // e.g. ROOT::CompressionSettings(ROOT::kLZ4, 4), -1: file default
+
+  // Lossy packing of the track table: number of mantissa bits kept per group of columns (23: full float precision)
+  enum TruncationGroup {
+    kTrackX = 0,     // fX
+    kTrackAlpha,     // fAlpha
+    kTrackYZ,        // fY, fZ
+    kTrackSnpTgl,    // fSnp, fTgl
+    kTrack1Pt,       // fSigned1Pt
+    kTrackCovDiag,   // diagonal elements of the covariance matrix
+    kTrackCovOffDiag,// off-diagonal elements of the covariance matrix
+    kTrackPID,       // fTPCinnerP, chi2, PID signals and track length
+    kTruncationGroups
+  };
+  void SetMantissaBits(TruncationGroup g, Int_t nbits) { fMantissaBits[g] = nbits; }
+  // Store the sorted index columns (collision and muon references, which do not decrease within a tree)
+  // as zig-zag encoded differences to the previous row of the same tree. The original index of row i is
+  // the sum of the decoded differences of rows 0..i within the output file. The track and V0 references
+  // of the V0 and cascade tables are not sorted and are stored as they are
+  void SetDeltaEncodeIndices(Bool_t flag = kTRUE) { fDeltaEncodeIndices = flag; }
+  // Also write the truncated and delta encoded tables without these encodings to a temporary file, to
+  // report at the end of the job their compressed size with and without the encodings (validation only:
+  // it doubles the output work of these tables)
+  void SetEncodingReference(Bool_t flag = kTRUE) { fEncodingReference = flag; }
+  // Store the track status flags as 32 bits, all the ESD status bits fit in them
+  void SetCompactFlags(Bool_t flag = kTRUE) { fCompactFlags = flag; }
+
   AliAnalysisFilter fTrackFilter; // Standard track filter object
 private:
   Bool_t fUseEventCuts = kFALSE;         //! Use or not event cuts
@@ -93,12 +126,39 @@ private:
   // Output TTree
   TTree* fTree[kTrees] = { nullptr }; //! Array with all the output trees
   void Prune();                       // Function to perform tree pruning
+  void ConfigureOutput();             // Function to apply the basket size and compression settings
   void FillTree(TreeIndex t);         // Function to fill the trees (only the active ones)
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
+  Int_t fNImplicitMTThreads = -1;         // Number of threads of the implicit MT pool (-1: disabled, 0: all the cores)
+  Int_t fBasketSize[kTrees] = { 0 };      // Basket size in bytes per tree (0: ROOT default)
+  Int_t fCompression[kTrees] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }; // Compression settings per tree (-1: file default)
+
+  Int_t fMantissaBits[kTruncationGroups] = { 23, 23, 23, 23, 23, 23, 23, 23 }; // Mantissa bits kept per group of track columns
+  Bool_t fDeltaEncodeIndices = kFALSE;    // Delta and zig-zag encoding of the index columns
+  Bool_t fCompactFlags = kFALSE;          // Track flags stored in 32 bits
+  Bool_t fEncodingReference = kFALSE;     // Write the tables without encodings to measure their gain
+
+  // Output statistics
+  Double_t fFillTime[kTrees] = { 0. };    //! Time spent in TTree::Fill per tree (s)
+  Double_t fMaxAbsError[kTruncationGroups] = { 0. }; //! Maximum absolute error induced by the truncation per group
+  Double_t fMaxRelError[kTruncationGroups] = { 0. }; //! Maximum relative error induced by the truncation per group
+  Long64_t fNLostFlags = 0;               //! Number of tracks with status bits above 32 (lost with compact flags)
+
+  // Index column of each tree and its value in the previous row (delta encoding)
+  Int_t* fIndexColumn[kTrees] = { nullptr }; //! Pointer to the sorted index column of each tree
+  Int_t fLastIndex[kTrees] = { 0 };          //! Index of the previous row
+  void SetIndexColumn(TreeIndex t, Int_t* column);
+  void TruncateTrack(); // Apply the mantissa truncation to the track columns
+
+  // Tables without truncation and delta encoding (SetEncodingReference)
+  TFile* fReferenceFile = nullptr;             //! Temporary file of the reference tables
+  TTree* fReferenceTree[kTrees] = { nullptr }; //! Reference tables, filled with the rows of the output trees
+  void CreateReferenceTrees();
+  void ReportEncodingGain();
 
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
@@ -169,6 +229,7 @@ private:
 
     // Track quality parameters
     ULong64_t fFlags = 0u;       /// Reconstruction status flags
+    UInt_t fFlagsCompact = 0u;   /// Reconstruction status flags in 32 bits (compact flags mode)
 
     // Clusters
     UChar_t fITSClusterMap = 0u; /// ITS map of clusters, one bit per a layer
@@ -358,7 +419,7 @@ private:
   Int_t fOffsetTrackID = 0;   ///! Offset of track IDs (used in V0s)
   Int_t fOffsetV0ID = 0;      ///! Offset of track IDs (used in cascades)
 
-  ClassDef(AliAnalysisTaskAO2Dconverter, 4);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 7);
 };
 
 #endif